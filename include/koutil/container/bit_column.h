@@ -0,0 +1,378 @@
+#ifndef KOUTIL_CONTAINER_BIT_COLUMN_H
+#define KOUTIL_CONTAINER_BIT_COLUMN_H
+
+#include <bit>
+#include <cassert>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Element type selecting a bool column packed into bits.
+ *
+ * Rows of the column are accessed through `bit_reference` proxies and the whole column through a `bit_span`.
+ */
+struct packed_bool { };
+
+namespace detail {
+
+    /**
+     * @brief Word storing the bits of a packed column.
+     */
+    using bit_word = std::uint64_t;
+
+    /**
+     * @brief Number of bits in a word.
+     */
+    inline constexpr std::size_t bit_word_bits = sizeof(bit_word) * 8;
+
+    /**
+     * @brief Returns the number of words holding a number of bits.
+     *
+     * @param bits The number of bits.
+     * @return The number of words.
+     */
+    constexpr std::size_t bit_word_count(std::size_t bits) { return (bits + bit_word_bits - 1) / bit_word_bits; }
+
+}
+
+/**
+ * @brief Proxy referencing a single bit.
+ *
+ * @tparam Word The word type, const-qualified for a read-only reference.
+ */
+template <typename Word> class bit_reference {
+public:
+    bit_reference(const bit_reference&) = default;
+
+    /**
+     * @brief Constructs a reference to a bit of a word.
+     *
+     * @param word The word.
+     * @param mask The mask selecting the bit.
+     */
+    bit_reference(Word* word, detail::bit_word mask)
+        : m_word(word)
+        , m_mask(mask) { }
+
+    operator bool() const { return (*m_word & m_mask) != 0; }
+
+    const bit_reference& operator=(bool value) const
+        requires(!std::is_const_v<Word>)
+    {
+        if (value) {
+            *m_word |= m_mask;
+        } else {
+            *m_word &= ~m_mask;
+        }
+        return *this;
+    }
+
+    const bit_reference& operator=(const bit_reference& other) const
+        requires(!std::is_const_v<Word>)
+    {
+        return *this = static_cast<bool>(other);
+    }
+
+    /**
+     * @brief Inverts the bit.
+     */
+    void flip() const
+        requires(!std::is_const_v<Word>)
+    {
+        *m_word ^= m_mask;
+    }
+
+private:
+    Word* m_word;
+    detail::bit_word m_mask;
+};
+
+/**
+ * @brief Random access pointer to a bit in an array of words.
+ *
+ * @tparam Word The word type, const-qualified for a read-only pointer.
+ */
+template <typename Word> class bit_pointer {
+public:
+    using value_type        = bool;
+    using reference         = bit_reference<Word>;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    bit_pointer() = default;
+
+    /**
+     * @brief Constructs a pointer to a bit.
+     *
+     * @param words The array of words.
+     * @param pos The index of the bit.
+     */
+    bit_pointer(Word* words, std::size_t pos)
+        : m_words(words)
+        , m_pos(pos) { }
+
+    /**
+     * @brief Converts a mutable pointer to a constant pointer.
+     *
+     * @tparam Other The word type of the other pointer.
+     * @param other The pointer to convert.
+     */
+    template <typename Other>
+        requires(std::is_const_v<Word> && std::is_same_v<const Other, Word>)
+    bit_pointer(const bit_pointer<Other>& other)
+        : m_words(other.words())
+        , m_pos(other.pos()) { }
+
+    reference operator*() const {
+        return reference(
+            m_words + (m_pos / detail::bit_word_bits), detail::bit_word { 1 } << (m_pos % detail::bit_word_bits)
+        );
+    }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    bit_pointer& operator++() { return *this += 1; }
+
+    bit_pointer operator++(int) {
+        bit_pointer tmp = *this;
+        *this += 1;
+        return tmp;
+    }
+
+    bit_pointer& operator--() { return *this -= 1; }
+
+    bit_pointer operator--(int) {
+        bit_pointer tmp = *this;
+        *this -= 1;
+        return tmp;
+    }
+
+    bit_pointer& operator+=(difference_type n) {
+        m_pos = static_cast<std::size_t>(static_cast<difference_type>(m_pos) + n);
+        return *this;
+    }
+
+    bit_pointer& operator-=(difference_type n) { return *this += -n; }
+
+    bit_pointer operator+(difference_type n) const {
+        bit_pointer tmp = *this;
+        return tmp += n;
+    }
+
+    friend bit_pointer operator+(difference_type n, const bit_pointer& ptr) { return ptr + n; }
+
+    bit_pointer operator-(difference_type n) const {
+        bit_pointer tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const bit_pointer& other) const {
+        return static_cast<difference_type>(m_pos) - static_cast<difference_type>(other.m_pos);
+    }
+
+    bool operator==(const bit_pointer& other) const { return m_words == other.m_words && m_pos == other.m_pos; }
+
+    auto operator<=>(const bit_pointer& other) const { return m_pos <=> other.m_pos; }
+
+    /**
+     * @brief Returns the array of words.
+     *
+     * @return Pointer to the first word.
+     */
+    [[nodiscard]] Word* words() const { return m_words; }
+
+    /**
+     * @brief Returns the index of the bit.
+     *
+     * @return The index of the bit.
+     */
+    [[nodiscard]] std::size_t pos() const { return m_pos; }
+
+private:
+    Word* m_words     = nullptr;
+    std::size_t m_pos = 0;
+};
+
+/**
+ * @brief View over a packed bool column.
+ *
+ * The queries work a word at a time. Bits past the size in the last word are ignored.
+ *
+ * @tparam Word The word type, const-qualified for a read-only view.
+ */
+template <typename Word> class bit_span {
+public:
+    using iterator = bit_pointer<Word>;
+
+    /**
+     * @brief Constructs a view over bits starting at the beginning of a word.
+     *
+     * @param first Pointer to the first bit.
+     * @param size The number of bits.
+     */
+    bit_span(bit_pointer<Word> first, std::size_t size)
+        : m_words(first.words())
+        , m_size(size) {
+        assert(first.pos() == 0);
+    }
+
+    /**
+     * @brief Returns the number of bits.
+     *
+     * @return The number of bits.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Checks if the view is empty.
+     *
+     * @return True if the view is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    bit_reference<Word> operator[](std::size_t pos) const {
+        assert(pos < m_size);
+        return begin()[static_cast<std::ptrdiff_t>(pos)];
+    }
+
+    /**
+     * @brief Returns the words holding the bits.
+     *
+     * @return The words.
+     */
+    [[nodiscard]] std::span<Word> words() const { return { m_words, detail::bit_word_count(m_size) }; }
+
+    /**
+     * @brief Counts the set bits.
+     *
+     * @return The number of set bits.
+     */
+    [[nodiscard]] std::size_t count() const {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < word_count(); ++i) {
+            total += static_cast<std::size_t>(std::popcount(word(i)));
+        }
+        return total;
+    }
+
+    /**
+     * @brief Finds the first set bit.
+     *
+     * @return The index of the first set bit, or `size()` if no bit is set.
+     */
+    [[nodiscard]] std::size_t find_first() const {
+        for (std::size_t i = 0; i < word_count(); ++i) {
+            const detail::bit_word bits = word(i);
+            if (bits != 0) {
+                return i * detail::bit_word_bits + static_cast<std::size_t>(std::countr_zero(bits));
+            }
+        }
+        return m_size;
+    }
+
+    /**
+     * @brief Calls a function with the index of every set bit in increasing order.
+     *
+     * @tparam Fn The type of the function.
+     * @param fn The function.
+     */
+    template <typename Fn> void for_each_set(Fn&& fn) const {
+        for (std::size_t i = 0; i < word_count(); ++i) {
+            for (detail::bit_word bits = word(i); bits != 0; bits &= bits - 1) {
+                fn(i * detail::bit_word_bits + static_cast<std::size_t>(std::countr_zero(bits)));
+            }
+        }
+    }
+
+    iterator begin() const { return iterator(m_words, 0); }
+
+    iterator end() const { return iterator(m_words, m_size); }
+
+private:
+    Word* m_words;
+    std::size_t m_size;
+
+    [[nodiscard]] std::size_t word_count() const { return detail::bit_word_count(m_size); }
+
+    /**
+     * @brief Returns a word with the bits past the size cleared.
+     *
+     * @param index The index of the word.
+     * @return The word.
+     */
+    [[nodiscard]] detail::bit_word word(std::size_t index) const {
+        const std::size_t tail = m_size % detail::bit_word_bits;
+        if (tail != 0 && index + 1 == word_count()) {
+            return m_words[index] & ((detail::bit_word { 1 } << tail) - 1);
+        }
+        return m_words[index];
+    }
+};
+
+/**
+ * @brief Describes how a multi_vector column of an element type is accessed.
+ *
+ * @tparam T The element type, const-qualified for read-only access.
+ */
+template <typename T> struct column_traits {
+    using value_type = std::remove_const_t<T>;
+    using pointer    = T*;
+    using reference  = T&;
+    using span       = std::span<T>;
+};
+
+template <> struct column_traits<packed_bool> {
+    using value_type = bool;
+    using pointer    = bit_pointer<detail::bit_word>;
+    using reference  = bit_reference<detail::bit_word>;
+    using span       = bit_span<detail::bit_word>;
+};
+
+template <> struct column_traits<const packed_bool> {
+    using value_type = bool;
+    using pointer    = bit_pointer<const detail::bit_word>;
+    using reference  = bit_reference<const detail::bit_word>;
+    using span       = bit_span<const detail::bit_word>;
+};
+
+namespace detail {
+
+    /**
+     * @brief Reorders bits so that `data[i]` becomes the former `data[permutation[i]]`.
+     *
+     * @tparam Allocator The allocator type, rebound to `bool`.
+     * @param data Pointer to the first bit.
+     * @param permutation The permutation.
+     * @param alloc The allocator of the temporary bits.
+     */
+    template <typename Allocator>
+    void apply_permutation(
+        bit_pointer<bit_word> data,
+        const std::vector<std::size_t>& permutation,
+        const Allocator& alloc
+    ) {
+        using bool_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<bool>;
+
+        std::vector<bool, bool_allocator_t> bits(permutation.size(), bool_allocator_t(alloc));
+        for (std::size_t i = 0; i < permutation.size(); ++i) {
+            bits[i] = data[static_cast<std::ptrdiff_t>(permutation[i])];
+        }
+
+        for (std::size_t i = 0; i < permutation.size(); ++i) {
+            data[static_cast<std::ptrdiff_t>(i)] = bits[i];
+        }
+    }
+
+}
+
+}
+
+#endif
@@ -0,0 +1,476 @@
+#ifndef KOUTIL_CONTAINER_CONCURRENT_MULTI_VECTOR_H
+#define KOUTIL_CONTAINER_CONCURRENT_MULTI_VECTOR_H
+
+#include "koutil/container/indexed_row_iterator.h"
+#include "koutil/container/multi_vector.h"
+#include "koutil/container/multi_vector_storage.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace koutil::container {
+
+/**
+ * @brief Default number of rows in the first segment of a concurrent_multi_vector.
+ */
+inline constexpr std::size_t default_segment_size = 1024;
+
+/**
+ * @brief Class representing a multi_vector which can be appended to by several threads at once.
+ *
+ * The rows are stored in segments whose sizes double, starting at `FirstSegment`. A segment is allocated once and
+ * never moved, so growing only installs a new segment and does not block readers or other producers.
+ *
+ * A producer reserves a row with an atomic increment, constructs the elements without any lock and marks the row as
+ * ready. Any producer then advances `size()` over the ready rows following it, so `size()` only counts rows whose
+ * elements are fully constructed and a producer never waits for a slower one. Every row below `size()` can be read
+ * while other threads keep appending. Clearing, reserving and destroying are not thread-safe.
+ *
+ * The allocator is called from the producing threads, so it has to be thread-safe.
+ *
+ * @tparam FirstSegment The number of rows in the first segment, a power of two.
+ * @tparam Allocator The allocator type, rebound to cache lines.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t FirstSegment, typename Allocator, is_multi_vector_element... Types>
+    requires(std::has_single_bit(FirstSegment) && sizeof...(Types) != 0 && (!std::is_void_v<Types> && ...))
+class basic_concurrent_multi_vector {
+private:
+    static constexpr std::size_t column_count = sizeof...(Types);
+
+    static constexpr std::size_t alignment = std::max({ detail::cache_line_size, alignof(Types)... });
+
+    static_assert(FirstSegment % alignment == 0, "Every column of a segment must start on a cache line");
+
+    static constexpr std::array<std::size_t, column_count + 1> column_offsets = [] {
+        constexpr std::array<std::size_t, column_count> sizes = { sizeof(Types)... };
+
+        std::array<std::size_t, column_count + 1> offsets {};
+        std::partial_sum(sizes.begin(), sizes.end(), offsets.begin() + 1);
+        return offsets;
+    }();
+
+    static constexpr std::size_t first_shift = std::countr_zero(FirstSegment);
+
+    /**
+     * @brief The number of segments needed to address every `std::size_t` position.
+     */
+    static constexpr std::size_t max_segments = sizeof(std::size_t) * 8 - first_shift;
+
+    /**
+     * @brief Byte offset of the ready flags of the rows in a segment, relative to the segment capacity.
+     */
+    static constexpr std::size_t flags_offset = column_offsets[column_count];
+
+    struct alignas(alignment) line {
+        std::byte bytes[alignment];
+    };
+
+    using allocator_t      = std::allocator_traits<Allocator>::template rebind_alloc<line>;
+    using allocator_traits = std::allocator_traits<allocator_t>;
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+public:
+    using allocator_type = Allocator;
+
+    using value_ref_t       = std::tuple<Types&...>;
+    using const_value_ref_t = std::tuple<const Types&...>;
+    using value_t           = std::tuple<Types...>;
+
+    using iterator_t       = indexed_row_iterator<basic_concurrent_multi_vector>;
+    using const_iterator_t = indexed_row_iterator<const basic_concurrent_multi_vector>;
+
+    basic_concurrent_multi_vector() = default;
+
+    /**
+     * @brief Constructs an empty multi_vector using an allocator.
+     *
+     * @param alloc The allocator used by the segments.
+     */
+    explicit basic_concurrent_multi_vector(const allocator_type& alloc)
+        : m_alloc(alloc) { }
+
+    basic_concurrent_multi_vector(const basic_concurrent_multi_vector&)            = delete;
+    basic_concurrent_multi_vector(basic_concurrent_multi_vector&&)                 = delete;
+    basic_concurrent_multi_vector& operator=(const basic_concurrent_multi_vector&) = delete;
+    basic_concurrent_multi_vector& operator=(basic_concurrent_multi_vector&&)      = delete;
+
+    ~basic_concurrent_multi_vector() {
+        clear();
+        for (std::size_t segment = 0; segment < max_segments; ++segment) {
+            line* block = m_segments[segment].load(std::memory_order_relaxed);
+            if (block != nullptr) {
+                allocator_traits::deallocate(m_alloc, block, segment_lines(segment));
+            }
+        }
+    }
+
+    /**
+     * @brief Returns the allocator used by the segments.
+     *
+     * @return The allocator.
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return allocator_type(m_alloc); }
+
+    /**
+     * @brief Returns the number of published elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Checks if the multi_vector has no published element.
+     *
+     * @return True if the multi_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Returns the number of rows in a segment.
+     *
+     * @param segment The index of the segment.
+     * @return The number of rows.
+     */
+    static constexpr std::size_t segment_capacity(std::size_t segment) { return FirstSegment << segment; }
+
+    /**
+     * @brief Returns the number of segments holding at least one published element.
+     *
+     * @return The number of segments.
+     */
+    [[nodiscard]] std::size_t segment_count() const {
+        const std::size_t rows = size();
+        return rows == 0 ? 0 : segment_of(rows - 1) + 1;
+    }
+
+    /**
+     * @brief Returns the published elements of a column stored in a segment.
+     *
+     * @tparam I The index of the column.
+     * @param segment The index of the segment.
+     * @return The span over the elements.
+     */
+    template <std::size_t I> std::span<element_t<I>> segment(std::size_t segment) {
+        assert(segment < segment_count());
+        return std::span<element_t<I>>(column<I>(segment), segment_rows(segment));
+    }
+
+    /**
+     * @brief Returns the published elements of a column stored in a segment.
+     *
+     * @tparam I The index of the column.
+     * @param segment The index of the segment.
+     * @return The span over the elements.
+     */
+    template <std::size_t I> std::span<const element_t<I>> segment(std::size_t segment) const {
+        assert(segment < segment_count());
+        return std::span<const element_t<I>>(column<I>(segment), segment_rows(segment));
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of a published element.
+     * @return Reference to the element.
+     */
+    value_ref_t at(std::size_t pos) {
+        assert(pos < size());
+        return get_all<value_ref_t>(pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of a published element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t at(std::size_t pos) const {
+        assert(pos < size());
+        return get_all<const_value_ref_t>(pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of a published element.
+     * @return Reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of a published element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Allocates the segments for a specified number of elements.
+     *
+     * Not thread-safe.
+     *
+     * @param size The number of elements.
+     */
+    void reserve(std::size_t size) {
+        if (size != 0) {
+            for (std::size_t segment = 0; segment <= segment_of(size - 1); ++segment) {
+                acquire_segment(segment);
+            }
+        }
+    }
+
+    /**
+     * @brief Destroys all elements and keeps the segments for reuse.
+     *
+     * Not thread-safe.
+     */
+    void clear() {
+        const std::size_t rows = size();
+        for (std::size_t pos = 0; pos < rows; ++pos) {
+            destroy_row(pos, helper_seq);
+            ready_flag(pos).store(false, std::memory_order_relaxed);
+        }
+
+        m_reserved.store(0, std::memory_order_relaxed);
+        m_size.store(0, std::memory_order_release);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * The segment of the row is allocated before the row is reserved, so an exception of the allocator leaves the
+     * multi_vector unchanged. The elements are constructed without holding a lock. A reserved row which never becomes
+     * ready would hide every later row, so a constructor which throws terminates instead.
+     *
+     * @tparam Args The types of the arguments.
+     * @param args The arguments to construct the new element.
+     * @return The position of the new element.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == column_count)
+    std::size_t emplace_back(Args&&... args) {
+        const std::size_t pos = reserve_row();
+        construct_and_publish(pos, std::forward<decltype(args)>(args)...);
+
+        return pos;
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     * @return The position of the new element.
+     */
+    std::size_t push_back(const value_t& value) {
+        return std::apply([this](const Types&... values) { return emplace_back(values...); }, value);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     * @return The position of the new element.
+     */
+    std::size_t push_back(value_t&& value) {
+        return std::apply([this](Types&... values) { return emplace_back(std::move(values)...); }, value);
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning of the multi_vector.
+     *
+     * @return An iterator to the beginning of the multi_vector.
+     */
+    iterator_t begin() { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t begin() const { return const_iterator_t(this, 0); }
+
+    /**
+     * @brief Returns an iterator past the elements published when called.
+     *
+     * @return An iterator to the end of the multi_vector.
+     */
+    iterator_t end() { return iterator_t(this, size()); }
+
+    /**
+     * @brief Returns a const iterator past the elements published when called.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t end() const { return const_iterator_t(this, size()); }
+
+private:
+    [[no_unique_address]] allocator_t m_alloc;
+    std::array<std::atomic<line*>, max_segments> m_segments {};
+
+    // producers contend on the reservation counter, readers only load the published size
+    alignas(detail::cache_line_size) std::atomic<std::size_t> m_reserved { 0 };
+    alignas(detail::cache_line_size) std::atomic<std::size_t> m_size { 0 };
+
+    static constexpr std::size_t segment_lines(std::size_t segment) {
+        return segment_capacity(segment) * (flags_offset + sizeof(std::atomic<bool>)) / alignment;
+    }
+
+    /**
+     * @brief Returns the segment holding a position.
+     *
+     * Segment `s` holds the positions `[FirstSegment * (2^s - 1), FirstSegment * (2^(s + 1) - 1))`.
+     *
+     * @param pos The position.
+     * @return The index of the segment.
+     */
+    static std::size_t segment_of(std::size_t pos) {
+        return static_cast<std::size_t>(std::bit_width((pos >> first_shift) + 1)) - 1;
+    }
+
+    static std::size_t segment_start(std::size_t segment) { return (FirstSegment << segment) - FirstSegment; }
+
+    [[nodiscard]] std::size_t segment_rows(std::size_t segment) const {
+        return std::min(segment_capacity(segment), size() - segment_start(segment));
+    }
+
+    /**
+     * @brief Returns a segment, allocating it if no other thread did.
+     *
+     * @param segment The index of the segment.
+     * @return The segment.
+     */
+    line* acquire_segment(std::size_t segment) {
+        line* block = m_segments[segment].load(std::memory_order_acquire);
+        if (block != nullptr) {
+            return block;
+        }
+
+        line* fresh = allocator_traits::allocate(m_alloc, segment_lines(segment));
+        std::uninitialized_value_construct_n(ready_flags(fresh, segment), segment_capacity(segment));
+
+        if (m_segments[segment].compare_exchange_strong(
+                block, fresh, std::memory_order_acq_rel, std::memory_order_acquire
+            )) {
+            return fresh;
+        }
+
+        // another thread installed the segment first
+        allocator_traits::deallocate(m_alloc, fresh, segment_lines(segment));
+        return block;
+    }
+
+    /**
+     * @brief Reserves the next row after allocating its segment.
+     *
+     * @return The position of the row.
+     */
+    std::size_t reserve_row() {
+        std::size_t pos = m_reserved.load(std::memory_order_relaxed);
+        do {
+            acquire_segment(segment_of(pos));
+        } while (!m_reserved.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed));
+
+        return pos;
+    }
+
+    template <typename... Args> void construct_and_publish(std::size_t pos, Args&&... args) noexcept {
+        construct_row(pos, helper_seq, std::forward<decltype(args)>(args)...);
+        ready_flag(pos).store(true, std::memory_order_seq_cst);
+
+        publish();
+    }
+
+    /**
+     * @brief Advances the published size over the ready rows following it.
+     *
+     * A producer which finds the next row not ready stops, the producer of that row advances the size after marking
+     * it. The flags are stored and loaded sequentially consistent, so of two producers marking neighbouring rows at
+     * least one sees the row of the other.
+     */
+    void publish() noexcept {
+        std::size_t published = m_size.load(std::memory_order_seq_cst);
+        while (true) {
+            std::size_t end = published;
+            while (is_ready(end)) {
+                ++end;
+            }
+
+            if (end == published || m_size.compare_exchange_weak(published, end, std::memory_order_seq_cst)) {
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] bool is_ready(std::size_t pos) const {
+        const std::size_t segment = segment_of(pos);
+        line* block               = m_segments[segment].load(std::memory_order_acquire);
+
+        return block != nullptr && ready_flags(block, segment)[pos - segment_start(segment)].load();
+    }
+
+    static std::atomic<bool>* ready_flags(line* block, std::size_t segment) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<std::atomic<bool>*>(
+            reinterpret_cast<std::byte*>(block) + segment_capacity(segment) * flags_offset
+        );
+    }
+
+    std::atomic<bool>& ready_flag(std::size_t pos) const {
+        const std::size_t segment = segment_of(pos);
+        return ready_flags(m_segments[segment].load(std::memory_order_acquire), segment)[pos - segment_start(segment)];
+    }
+
+    template <std::size_t I> element_t<I>* column(std::size_t segment) const {
+        line* block = m_segments[segment].load(std::memory_order_acquire);
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<element_t<I>*>(
+            reinterpret_cast<std::byte*>(block) + segment_capacity(segment) * column_offsets[I]
+        );
+    }
+
+    template <std::size_t I> element_t<I>& element(std::size_t pos) const {
+        const std::size_t segment = segment_of(pos);
+        return column<I>(segment)[pos - segment_start(segment)];
+    }
+
+    template <typename Ref, std::size_t... I>
+    Ref get_all(std::size_t pos, std::index_sequence<I...> /*unused*/) const {
+        return Ref { element<I>(pos)... };
+    }
+
+    template <typename... Args, std::size_t... I>
+    void construct_row(std::size_t pos, std::index_sequence<I...> /*unused*/, Args&&... args) {
+        (std::construct_at(&element<I>(pos), std::forward<decltype(args)>(args)), ...);
+    }
+
+    template <std::size_t... I> void destroy_row(std::size_t pos, std::index_sequence<I...> /*unused*/) {
+        (std::destroy_at(&element<I>(pos)), ...);
+    }
+};
+
+/**
+ * @brief Alias for a concurrent multi_vector with the default segment size and allocator.
+ *
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <is_multi_vector_element... Types>
+using concurrent_multi_vector
+    = basic_concurrent_multi_vector<default_segment_size, std::allocator<std::byte>, Types...>;
+
+}
+
+#endif
@@ -0,0 +1,498 @@
+#ifndef KOUTIL_CONTAINER_ENCODED_COLUMN_H
+#define KOUTIL_CONTAINER_ENCODED_COLUMN_H
+
+#include "koutil/container/hash_array.h"
+#include "koutil/container/multi_vector_query.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Column storing every distinct value once and a code per row.
+ *
+ * Appended values are deduplicated with a hash_array over the dictionary. Scans comparing with a single value look
+ * the value up once and then compare only the codes.
+ *
+ * @tparam T The type of the values.
+ * @tparam Code The unsigned type of the codes, it limits the number of distinct values.
+ * @tparam Hash The hash function of the values.
+ */
+template <typename T, std::unsigned_integral Code = std::uint32_t, is_hash<T> Hash = std::hash<T>>
+class dictionary_column {
+private:
+    /**
+     * @brief Key adapter comparing a value with an entry of the dictionary.
+     */
+    struct adapter {
+        const T* values;
+
+        [[nodiscard]] bool eql(const T& value, Code code) const { return std::equal_to<T>()(value, values[code]); }
+    };
+
+public:
+    using value_type = T;
+    using code_type  = Code;
+
+    dictionary_column() = default;
+
+    /**
+     * @brief Appends a value.
+     *
+     * @param value The value.
+     * @return The code of the value.
+     */
+    Code push_back(const T& value) {
+        auto it = m_index.find(value, adapter { m_dictionary.data() });
+        if (it != m_index.end()) {
+            m_codes.push_back(*it);
+            return *it;
+        }
+
+        assert(m_dictionary.size() <= std::numeric_limits<Code>::max());
+
+        const auto code = static_cast<Code>(m_dictionary.size());
+        m_dictionary.push_back(value);
+        m_index.try_insert(value, code, adapter { m_dictionary.data() });
+        m_codes.push_back(code);
+        return code;
+    }
+
+    /**
+     * @brief Returns the value of a row.
+     *
+     * @param pos The position of the row.
+     * @return Const reference to the value.
+     */
+    const T& at(std::size_t pos) const {
+        assert(pos < size());
+        return m_dictionary[m_codes[pos]];
+    }
+
+    const T& operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Returns the code of a value.
+     *
+     * @param value The value.
+     * @return The code, or nothing if the value is not in the dictionary.
+     */
+    [[nodiscard]] std::optional<Code> find_code(const T& value) const {
+        auto it = m_index.find(value, adapter { m_dictionary.data() });
+        if (it == m_index.end()) {
+            return std::nullopt;
+        }
+        return *it;
+    }
+
+    /**
+     * @brief Selects the rows equal to a value.
+     *
+     * @param value The value.
+     * @return The indices of the selected rows in increasing order.
+     */
+    [[nodiscard]] selection_vector select_equal(const T& value) const {
+        assert(size() <= std::numeric_limits<std::uint32_t>::max());
+
+        selection_vector result;
+        const std::optional<Code> code = find_code(value);
+        if (!code) {
+            return result;
+        }
+
+        detail::selection_writer out(result);
+        for (std::size_t i = 0; i < m_codes.size(); ++i) {
+            out.write(static_cast<std::uint32_t>(i), m_codes[i] == *code);
+        }
+        out.flush();
+
+        return result;
+    }
+
+    /**
+     * @brief Writes the values of all rows.
+     *
+     * @param out The destination, it must hold `size()` elements.
+     */
+    void decode(std::span<T> out) const {
+        assert(out.size() == size());
+
+        for (std::size_t i = 0; i < m_codes.size(); ++i) {
+            out[i] = m_dictionary[m_codes[i]];
+        }
+    }
+
+    /**
+     * @brief Returns the codes of the rows.
+     *
+     * @return The codes.
+     */
+    [[nodiscard]] std::span<const Code> codes() const { return m_codes; }
+
+    /**
+     * @brief Returns the distinct values indexed by their codes.
+     *
+     * @return The dictionary.
+     */
+    [[nodiscard]] std::span<const T> dictionary() const { return m_dictionary; }
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @return The number of rows.
+     */
+    [[nodiscard]] std::size_t size() const { return m_codes.size(); }
+
+    /**
+     * @brief Checks if the column is empty.
+     *
+     * @return True if the column is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_codes.empty(); }
+
+    /**
+     * @brief Reserves storage for the codes.
+     *
+     * @param size The number of rows.
+     */
+    void reserve(std::size_t size) { m_codes.reserve(size); }
+
+    /**
+     * @brief Removes all rows and the dictionary.
+     */
+    void clear() {
+        m_codes.clear();
+        m_dictionary.clear();
+        m_index.clear();
+    }
+
+    /**
+     * @brief Returns the number of bytes used by the codes and the dictionary.
+     *
+     * Memory owned by the values themselves and by the hash index is not counted.
+     *
+     * @return The number of bytes.
+     */
+    [[nodiscard]] std::size_t memory_usage() const {
+        return m_codes.capacity() * sizeof(Code) + m_dictionary.capacity() * sizeof(T);
+    }
+
+private:
+    using index_t = hash_array<T, Code, adapter, Hash>;
+
+    std::vector<Code> m_codes;
+    std::vector<T> m_dictionary;
+    index_t m_index;
+};
+
+/**
+ * @brief Column of integers stored as bit-packed deltas.
+ *
+ * The rows are split into blocks. A full block keeps its first value and the smallest delta, every other delta is
+ * stored minus the smallest one with the bit width of the largest remainder. Sorted integers with regular gaps need
+ * only a few bits per row. Rows of the last, incomplete block are kept unpacked.
+ *
+ * Any integers round-trip exactly, deltas are computed modulo the range of the type.
+ *
+ * @tparam T The integral type of the values.
+ * @tparam BlockSize The number of rows in a block.
+ */
+template <std::integral T, std::size_t BlockSize = 128>
+    requires(BlockSize > 1)
+class delta_column {
+private:
+    using unsigned_t = std::make_unsigned_t<T>;
+    using word_t     = std::uint64_t;
+
+    static constexpr std::size_t word_bits = sizeof(word_t) * 8;
+
+    /**
+     * @brief Describes a packed block.
+     */
+    struct block_header {
+        T first;
+        unsigned_t min_delta;
+        std::size_t offset;
+        std::uint8_t width;
+    };
+
+public:
+    using value_type = T;
+
+    static constexpr std::size_t block_size = BlockSize;
+
+    delta_column() { m_tail.reserve(BlockSize); }
+
+    /**
+     * @brief Appends a value.
+     *
+     * @param value The value.
+     */
+    void push_back(T value) {
+        m_tail.push_back(value);
+        if (m_tail.size() == BlockSize) {
+            pack_tail();
+        }
+    }
+
+    /**
+     * @brief Returns the value of a row.
+     *
+     * The deltas of the block preceding the row are summed, use `decode` or `for_each_block` for scans.
+     *
+     * @param pos The position of the row.
+     * @return The value.
+     */
+    [[nodiscard]] T at(std::size_t pos) const {
+        assert(pos < size());
+
+        const std::size_t block = pos / BlockSize;
+        const std::size_t index = pos % BlockSize;
+        if (block == m_blocks.size()) {
+            return m_tail[index];
+        }
+
+        const block_header& header = m_blocks[block];
+
+        auto acc = static_cast<unsigned_t>(header.first);
+        for (std::size_t i = 0; i < index; ++i) {
+            acc = static_cast<unsigned_t>(acc + read(header, i));
+        }
+        return static_cast<T>(acc);
+    }
+
+    T operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Calls a function with the decoded values of every block in order.
+     *
+     * @tparam Fn The type of the function.
+     * @param fn The function called with a span of at most `block_size` values.
+     */
+    template <typename Fn> void for_each_block(Fn&& fn) const {
+        std::array<T, BlockSize> buffer;
+        for (const block_header& header : m_blocks) {
+            decode_block(header, buffer.data());
+            fn(std::span<const T>(buffer));
+        }
+
+        if (!m_tail.empty()) {
+            fn(std::span<const T>(m_tail));
+        }
+    }
+
+    /**
+     * @brief Writes the values of all rows.
+     *
+     * @param out The destination, it must hold `size()` elements.
+     */
+    void decode(std::span<T> out) const {
+        assert(out.size() == size());
+
+        T* dest = out.data();
+        for (const block_header& header : m_blocks) {
+            decode_block(header, dest);
+            dest += BlockSize;
+        }
+        std::copy(m_tail.begin(), m_tail.end(), dest);
+    }
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @return The number of rows.
+     */
+    [[nodiscard]] std::size_t size() const { return m_blocks.size() * BlockSize + m_tail.size(); }
+
+    /**
+     * @brief Checks if the column is empty.
+     *
+     * @return True if the column is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return size() == 0; }
+
+    /**
+     * @brief Removes all rows.
+     */
+    void clear() {
+        m_words.clear();
+        m_blocks.clear();
+        m_tail.clear();
+    }
+
+    /**
+     * @brief Releases the unused capacity of the packed blocks.
+     */
+    void shrink_to_fit() {
+        m_words.shrink_to_fit();
+        m_blocks.shrink_to_fit();
+    }
+
+    /**
+     * @brief Returns the number of bytes used by the column.
+     *
+     * @return The number of bytes.
+     */
+    [[nodiscard]] std::size_t memory_usage() const {
+        return m_words.capacity() * sizeof(word_t) + m_blocks.capacity() * sizeof(block_header)
+            + m_tail.capacity() * sizeof(T);
+    }
+
+private:
+    std::vector<word_t> m_words;
+    std::vector<block_header> m_blocks;
+    std::vector<T> m_tail;
+
+    /**
+     * @brief Packs the full tail into a new block.
+     */
+    void pack_tail() {
+        assert(m_tail.size() == BlockSize);
+
+        std::array<unsigned_t, BlockSize - 1> deltas;
+        for (std::size_t i = 1; i < BlockSize; ++i) {
+            const auto prev = static_cast<unsigned_t>(m_tail[i - 1]);
+            deltas[i - 1]   = static_cast<unsigned_t>(static_cast<unsigned_t>(m_tail[i]) - prev);
+        }
+
+        const unsigned_t min_delta = *std::min_element(deltas.begin(), deltas.end());
+
+        unsigned_t max_rest = 0;
+        for (unsigned_t& delta : deltas) {
+            delta    = static_cast<unsigned_t>(delta - min_delta);
+            max_rest = std::max(max_rest, delta);
+        }
+
+        const block_header header {
+            .first     = m_tail.front(),
+            .min_delta = min_delta,
+            .offset    = m_words.size(),
+            .width     = static_cast<std::uint8_t>(std::bit_width(max_rest)),
+        };
+
+        m_words.resize(m_words.size() + (header.width * (BlockSize - 1) + word_bits - 1) / word_bits);
+
+        for (std::size_t i = 0; i < deltas.size(); ++i) {
+            write(header, i, deltas[i]);
+        }
+
+        m_blocks.push_back(header);
+        m_tail.clear();
+    }
+
+    /**
+     * @brief Writes the packed remainder of a delta.
+     *
+     * @param header The block.
+     * @param index The index of the delta.
+     * @param value The remainder, it must fit into the width of the block.
+     */
+    void write(const block_header& header, std::size_t index, unsigned_t value) {
+        if (header.width == 0) {
+            return;
+        }
+
+        const std::size_t bit   = index * header.width;
+        const std::size_t word  = header.offset + bit / word_bits;
+        const std::size_t shift = bit % word_bits;
+        const auto bits         = static_cast<word_t>(value);
+
+        m_words[word] |= bits << shift;
+        if (shift + header.width > word_bits) {
+            m_words[word + 1] |= bits >> (word_bits - shift);
+        }
+    }
+
+    /**
+     * @brief Reads the packed remainder of a delta and adds the smallest delta.
+     *
+     * @param header The block.
+     * @param index The index of the delta.
+     * @return The delta.
+     */
+    [[nodiscard]] unsigned_t read(const block_header& header, std::size_t index) const {
+        if (header.width == 0) {
+            return header.min_delta;
+        }
+
+        const std::size_t bit   = index * header.width;
+        const std::size_t word  = header.offset + bit / word_bits;
+        const std::size_t shift = bit % word_bits;
+        const word_t mask       = header.width == word_bits ? ~word_t { 0 } : (word_t { 1 } << header.width) - 1;
+
+        word_t bits = m_words[word] >> shift;
+        if (shift + header.width > word_bits) {
+            bits |= m_words[word + 1] << (word_bits - shift);
+        }
+
+        return static_cast<unsigned_t>(static_cast<unsigned_t>(bits & mask) + header.min_delta);
+    }
+
+    /**
+     * @brief Decodes a packed block.
+     *
+     * @param header The block.
+     * @param out The destination of `block_size` values.
+     */
+    void decode_block(const block_header& header, T* out) const {
+        auto acc = static_cast<unsigned_t>(header.first);
+        out[0]   = header.first;
+        for (std::size_t i = 1; i < BlockSize; ++i) {
+            acc    = static_cast<unsigned_t>(acc + read(header, i - 1));
+            out[i] = static_cast<T>(acc);
+        }
+    }
+};
+
+/**
+ * @brief Encodes a column of a multi_vector with a dictionary.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The encoded column.
+ */
+template <std::size_t I, typename Vec> auto encode_dictionary(const Vec& vec) {
+    const auto column = vec.template get_container<I>();
+
+    dictionary_column<std::remove_cvref_t<decltype(column[0])>> result;
+    result.reserve(column.size());
+    for (const auto& value : column) {
+        result.push_back(value);
+    }
+    return result;
+}
+
+/**
+ * @brief Encodes an integral column of a multi_vector with bit-packed deltas.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The encoded column.
+ */
+template <std::size_t I, typename Vec> auto encode_delta(const Vec& vec) {
+    const auto column = vec.template get_container<I>();
+
+    delta_column<std::remove_cvref_t<decltype(column[0])>> result;
+    for (const auto value : column) {
+        result.push_back(value);
+    }
+    result.shrink_to_fit();
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,828 @@
+#ifndef KOUTIL_CONTAINER_FLAT_HASH_ARRAY_H
+#define KOUTIL_CONTAINER_FLAT_HASH_ARRAY_H
+
+#include "koutil/container/hash_array.h"
+#include "koutil/container/template_hash_array.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace koutil::container {
+
+namespace detail {
+
+    /**
+     * @brief Control byte of a slot which was never used.
+     */
+    inline constexpr std::uint8_t ctrl_empty = 0x80;
+
+    /**
+     * @brief Control byte of a slot whose element was erased.
+     */
+    inline constexpr std::uint8_t ctrl_deleted = 0xFE;
+
+    /**
+     * @brief Number of slots probed together.
+     */
+    inline constexpr std::size_t flat_group_size = 16;
+
+    /**
+     * @brief Mixes a hash so that both the group index and the fingerprint depend on all of its bits.
+     *
+     * @param hash The hash.
+     * @return The mixed hash.
+     */
+    constexpr std::uint64_t mix_hash(std::size_t hash) {
+        std::uint64_t mixed = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+        return mixed ^ (mixed >> 32);
+    }
+
+    /**
+     * @brief Returns the 7-bit fingerprint stored in the control byte of a full slot.
+     *
+     * @param mixed The mixed hash.
+     * @return The fingerprint.
+     */
+    constexpr std::uint8_t hash_fingerprint(std::uint64_t mixed) { return static_cast<std::uint8_t>(mixed & 0x7F); }
+
+    /**
+     * @brief Control bytes of a group of slots.
+     */
+    class ctrl_group {
+    public:
+        /**
+         * @brief Loads the control bytes of a group.
+         *
+         * @param ctrl Pointer to the first control byte of the group.
+         */
+        explicit ctrl_group(const std::uint8_t* ctrl)
+            : m_ctrl(ctrl) { }
+
+        /**
+         * @brief Finds the slots with a fingerprint.
+         *
+         * @param fingerprint The fingerprint.
+         * @return The mask of matching slots.
+         */
+        [[nodiscard]] std::uint32_t match(std::uint8_t fingerprint) const {
+#if defined(__SSE2__)
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_ctrl));
+            const __m128i eql  = _mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(fingerprint)));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(eql));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < flat_group_size; ++i) {
+                mask |= static_cast<std::uint32_t>(m_ctrl[i] == fingerprint) << i;
+            }
+            return mask;
+#endif
+        }
+
+        /**
+         * @brief Finds the empty slots.
+         *
+         * @return The mask of empty slots.
+         */
+        [[nodiscard]] std::uint32_t match_empty() const { return match(ctrl_empty); }
+
+        /**
+         * @brief Finds the empty and deleted slots.
+         *
+         * @return The mask of the slots without an element.
+         */
+        [[nodiscard]] std::uint32_t match_free() const {
+#if defined(__SSE2__)
+            // only the free control bytes have the high bit set
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            const __m128i ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_ctrl));
+            return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+            std::uint32_t mask = 0;
+            for (std::size_t i = 0; i < flat_group_size; ++i) {
+                mask |= static_cast<std::uint32_t>((m_ctrl[i] & 0x80) != 0) << i;
+            }
+            return mask;
+#endif
+        }
+
+    private:
+        const std::uint8_t* m_ctrl;
+    };
+
+}
+
+/**
+ * @brief A hash array with open addressing in one flat slot array.
+ *
+ * Every slot has a control byte holding a 7-bit fingerprint of the hash. Lookups probe groups of 16 control bytes at
+ * once with SSE2 and call the key adapter only for slots whose fingerprint and stored hash match. The capacity is a
+ * power of two and the groups are visited with triangular probing.
+ *
+ * @tparam Key The key type.
+ * @tparam KeyID The key ID type.
+ * @tparam ComptimeData The comptime data type.
+ * @tparam KeyAdapter The key adapter type.
+ * @tparam Hash The hash function type.
+ * @tparam Allocator The allocator type.
+ * @tparam Stats The probe statistics policy.
+ */
+template <
+    typename Key,
+    typename KeyID,
+    typename ComptimeData,
+    is_template_key_adapter<Key, KeyID, ComptimeData> KeyAdapter,
+    is_template_hash<Key, ComptimeData> Hash,
+    typename Allocator   = std::allocator<std::byte>,
+    is_probe_stats Stats = no_probe_stats>
+class flat_template_hash_array {
+private:
+    using key_t      = Key;
+    using key_id_t   = KeyID;
+    using hash_t     = Hash;
+    using adapter_t  = KeyAdapter;
+    using comptime_t = ComptimeData;
+
+    struct slot {
+        std::size_t hash;
+        KeyID id;
+    };
+
+    using ctrl_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<std::uint8_t>;
+    using slot_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<slot>;
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+     * @brief Iterator over the full slots.
+     *
+     * @tparam is_const Boolean indicating if the iterator is constant.
+     */
+    template <bool is_const> class iterator {
+    private:
+        using array_t = std::conditional_t<is_const, const flat_template_hash_array, flat_template_hash_array>;
+
+    public:
+        using value_type      = KeyID;
+        using reference       = std::conditional_t<is_const, const value_type&, value_type&>;
+        using difference_type = std::ptrdiff_t;
+
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() = default;
+
+        /**
+         * @brief Constructs an iterator to the first full slot at or after a position.
+         *
+         * @param array The hash array.
+         * @param pos The position of the slot.
+         */
+        iterator(array_t* array, std::size_t pos)
+            : m_array(array)
+            , m_pos(pos) {
+            find_full();
+        }
+
+        /**
+         * @brief Conversion operator to constant iterator.
+         *
+         * @return iterator<true> Constant iterator.
+         */
+        operator iterator<true>() const
+            requires(!is_const)
+        {
+            return { m_array, m_pos };
+        }
+
+        bool operator==(const iterator& other) const { return m_pos == other.m_pos; }
+
+        reference operator*() const { return m_array->m_slots[m_pos].id; }
+
+        iterator& operator++() {
+            m_pos += 1;
+            find_full();
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        /**
+         * @brief Returns the index of the slot.
+         *
+         * @return The index of the slot.
+         */
+        [[nodiscard]] std::size_t pos() const { return m_pos; }
+
+    private:
+        array_t* m_array  = nullptr;
+        std::size_t m_pos = 0;
+
+        void find_full() {
+            const std::size_t capacity = m_array->capacity();
+            while (m_pos < capacity && (m_array->m_ctrl[m_pos] & 0x80) != 0) {
+                m_pos += 1;
+            }
+        }
+    };
+
+public:
+    using iterator_t       = iterator<false>;
+    using const_iterator_t = iterator<true>;
+
+    /**
+     * @brief Default constructor.
+     */
+    flat_template_hash_array()
+        : flat_template_hash_array(detail::flat_group_size) { }
+
+    /**
+     * @brief Constructor with bucket count.
+     *
+     * @param bucket_count Minimal number of slots, it is rounded up to a power of two.
+     */
+    flat_template_hash_array(std::size_t bucket_count)
+        : m_ctrl(round_capacity(bucket_count), detail::ctrl_empty)
+        , m_slots(m_ctrl.size()) { }
+
+    /**
+     * @brief Check if the hash_array is empty.
+     * @return bool True if empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Get the number of elements in the hash_array.
+     * @return std::size_t Number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Returns the number of slots.
+     * @return std::size_t Number of slots.
+     */
+    [[nodiscard]] std::size_t bucket_count() const { return capacity(); }
+
+    /**
+     * @brief Returns the maximum load factor.
+     * @return float Maximum load factor.
+     */
+    [[nodiscard]] float max_load_factor() const { return m_max_load_factor; }
+
+    /**
+     * @brief Sets a new maximum load factor.
+     *
+     * At least one slot of every table stays free, so the factor must be lower than one.
+     *
+     * @param factor New maximum load factor.
+     */
+    void set_max_load_factor(float factor) {
+        assert(factor > 0 && factor < 1);
+        m_max_load_factor = factor;
+    }
+
+    /**
+     * @brief Clear all elements from the hash_array.
+     */
+    void clear() {
+        std::fill(m_ctrl.begin(), m_ctrl.end(), detail::ctrl_empty);
+        m_size    = 0;
+        m_deleted = 0;
+    }
+
+    /**
+     * @brief Returns the probe statistics.
+     * @return const Stats& The statistics.
+     */
+    [[nodiscard]] const Stats& stats() const { return m_stats; }
+
+    /**
+     * @brief Resets the probe statistics.
+     */
+    void reset_stats() { m_stats.reset(); }
+
+    /**
+     * @brief Try to insert a key and key ID into the hash_array.
+     * @tparam Data The comptime data.
+     * @param key The key to insert.
+     * @param key_id The key ID to insert.
+     * @return bool True if the key is not inside hash_array, false otherwise.
+     */
+    template <comptime_t Data> bool try_insert(const key_t& key, const key_id_t& key_id, adapter_t adapter) {
+        const std::size_t hash = hash_t().template hash<Data>(key);
+        if (find_slot<Data>(key, hash, adapter) != npos) {
+            return false;
+        }
+
+        if (static_cast<float>(m_size + m_deleted + 1) > static_cast<float>(capacity()) * m_max_load_factor) {
+            grow();
+        }
+
+        const std::uint64_t mixed = detail::mix_hash(hash);
+        const std::size_t pos     = find_free(mixed);
+
+        if (m_ctrl[pos] == detail::ctrl_deleted) {
+            m_deleted -= 1;
+        }
+
+        m_ctrl[pos]  = detail::hash_fingerprint(mixed);
+        m_slots[pos] = { hash, key_id };
+        m_size += 1;
+        return true;
+    }
+
+    /**
+     * @brief Try to set new key ID.
+     * @tparam Data The comptime data.
+     * @param key The key.
+     * @param new_key_id The new key ID.
+     * @return bool True if the key ID was changed, false otherwise.
+     */
+    template <comptime_t Data> bool try_set(const key_t& key, const key_id_t& new_key_id, adapter_t adapter) {
+        const std::size_t pos = find_slot<Data>(key, hash_t().template hash<Data>(key), adapter);
+        if (pos == npos) {
+            return false;
+        }
+
+        m_slots[pos].id = new_key_id;
+        return true;
+    }
+
+    /**
+     * @brief Erases an element from the hash table.
+     *
+     * The slot becomes empty again if its group has an empty slot, otherwise it is marked as deleted so that probe
+     * sequences passing through the group continue.
+     *
+     * @tparam Data The comptime data.
+     * @param key Key of the element to erase.
+     * @param adapter Key adapter for comparison.
+     */
+    template <comptime_t Data> void erase(const key_t& key, adapter_t adapter) {
+        const std::size_t pos = find_slot<Data>(key, hash_t().template hash<Data>(key), adapter);
+        if (pos == npos) {
+            return;
+        }
+
+        const std::size_t group = pos & ~(detail::flat_group_size - 1);
+        if (detail::ctrl_group(m_ctrl.data() + group).match_empty() != 0) {
+            m_ctrl[pos] = detail::ctrl_empty;
+        } else {
+            m_ctrl[pos] = detail::ctrl_deleted;
+            m_deleted += 1;
+        }
+        m_size -= 1;
+    }
+
+    /**
+     * @brief Finds an element in the hash table.
+     * @tparam Data The comptime data.
+     * @param key Key of the element to find.
+     * @param adapter Key adapter for comparison.
+     * @return iterator_t The iterator with found element, if not found end() is returned.
+     */
+    template <comptime_t Data> iterator_t find(const key_t& key, adapter_t adapter) {
+        const std::size_t pos = find_slot<Data>(key, hash_t().template hash<Data>(key), adapter);
+        return pos == npos ? end() : iterator_t { this, pos };
+    }
+
+    /**
+     * @brief Finds an element in the hash table.
+     * @tparam Data The comptime data.
+     * @param key Key of the element to find.
+     * @param adapter Key adapter for comparison.
+     * @return const_iterator_t The iterator with found element, if not found end() is returned.
+     */
+    template <comptime_t Data> const_iterator_t find(const key_t& key, adapter_t adapter) const {
+        const std::size_t pos = find_slot<Data>(key, hash_t().template hash<Data>(key), adapter);
+        return pos == npos ? cend() : const_iterator_t { this, pos };
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * The keys are processed in groups, every key of a group is hashed and the control bytes and slots of its first
+     * probed group are prefetched before the first key is probed.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    template <comptime_t Data>
+    void find_batch(std::span<const key_t> keys, std::span<iterator_t> out, adapter_t adapter) {
+        assert(out.size() >= keys.size());
+
+        lookup_batch<Data>(keys, adapter, [&](std::size_t i, std::size_t pos) {
+            out[i] = pos == npos ? end() : iterator_t { this, pos };
+        });
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    template <comptime_t Data>
+    void find_batch(std::span<const key_t> keys, std::span<const_iterator_t> out, adapter_t adapter) const {
+        assert(out.size() >= keys.size());
+
+        lookup_batch<Data>(keys, adapter, [&](std::size_t i, std::size_t pos) {
+            out[i] = pos == npos ? cend() : const_iterator_t { this, pos };
+        });
+    }
+
+    /**
+     * @brief Checks which keys of a batch are in the hash table.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The flags of found keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     * @return std::size_t The number of found keys.
+     */
+    template <comptime_t Data>
+    std::size_t contains_batch(std::span<const key_t> keys, std::span<bool> out, adapter_t adapter) const {
+        assert(out.size() >= keys.size());
+
+        std::size_t found = 0;
+        lookup_batch<Data>(keys, adapter, [&](std::size_t i, std::size_t pos) {
+            out[i] = pos != npos;
+            found += static_cast<std::size_t>(out[i]);
+        });
+        return found;
+    }
+
+    iterator_t begin() { return { this, 0 }; }
+
+    iterator_t end() { return { this, capacity() }; }
+
+    const_iterator_t begin() const { return { this, 0 }; }
+
+    const_iterator_t end() const { return { this, capacity() }; }
+
+    const_iterator_t cbegin() const { return begin(); }
+
+    const_iterator_t cend() const { return end(); }
+
+private:
+    std::vector<std::uint8_t, ctrl_allocator_t> m_ctrl;
+    std::vector<slot, slot_allocator_t> m_slots;
+    std::size_t m_size      = 0;
+    std::size_t m_deleted   = 0;
+    float m_max_load_factor = 0.875F;
+    [[no_unique_address]] mutable Stats m_stats;
+
+    [[nodiscard]] std::size_t capacity() const { return m_ctrl.size(); }
+
+    [[nodiscard]] std::size_t group_mask() const { return capacity() / detail::flat_group_size - 1; }
+
+    static std::size_t round_capacity(std::size_t bucket_count) {
+        return std::bit_ceil(std::max(bucket_count, detail::flat_group_size));
+    }
+
+    /**
+     * @brief Finds the slot of a key.
+     *
+     * @tparam Data The comptime data.
+     * @param key The key.
+     * @param hash The hash of the key.
+     * @param adapter Key adapter for comparison.
+     * @return The index of the slot, or `npos` if the key is not present.
+     */
+    template <comptime_t Data>
+    [[nodiscard]] std::size_t find_slot(const key_t& key, std::size_t hash, adapter_t adapter) const {
+        const std::uint64_t mixed      = detail::mix_hash(hash);
+        const std::uint8_t fingerprint = detail::hash_fingerprint(mixed);
+
+        std::size_t group = static_cast<std::size_t>(mixed >> 7) & group_mask();
+        for (std::size_t probe = 1;; ++probe) {
+            const std::size_t first = group * detail::flat_group_size;
+            const detail::ctrl_group ctrl(m_ctrl.data() + first);
+
+            for (std::uint32_t match = ctrl.match(fingerprint); match != 0; match &= match - 1) {
+                const std::size_t pos = first + static_cast<std::size_t>(std::countr_zero(match));
+                if (m_slots[pos].hash != hash) {
+                    m_stats.hash_rejected();
+                    continue;
+                }
+
+                m_stats.adapter_called();
+                if (adapter.template eql<Data>(key, m_slots[pos].id)) {
+                    return pos;
+                }
+            }
+
+            if (ctrl.match_empty() != 0 || probe > group_mask()) {
+                return npos;
+            }
+
+            group = (group + probe) & group_mask();
+        }
+    }
+
+    /**
+     * @brief Looks up keys in groups of `detail::lookup_batch_size`.
+     *
+     * The keys of a group are hashed and their first probed groups prefetched, then they are searched.
+     *
+     * @tparam Data The comptime data.
+     * @tparam Fn The type of the result callback.
+     * @param keys The keys.
+     * @param adapter Key adapter for comparison.
+     * @param fn Callback invoked with the index of the key and the index of its slot, or `npos`.
+     */
+    template <comptime_t Data, typename Fn>
+    void lookup_batch(std::span<const key_t> keys, adapter_t adapter, Fn&& fn) const {
+        std::array<std::size_t, detail::lookup_batch_size> hashes;
+
+        for (std::size_t first = 0; first < keys.size(); first += detail::lookup_batch_size) {
+            const std::size_t count = std::min(detail::lookup_batch_size, keys.size() - first);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                hashes[i] = hash_t().template hash<Data>(keys[first + i]);
+
+                const std::size_t group = static_cast<std::size_t>(detail::mix_hash(hashes[i]) >> 7) & group_mask();
+                detail::prefetch(m_ctrl.data() + group * detail::flat_group_size);
+                detail::prefetch(m_slots.data() + group * detail::flat_group_size);
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                fn(first + i, find_slot<Data>(keys[first + i], hashes[i], adapter));
+            }
+        }
+    }
+
+    /**
+     * @brief Finds the first slot without an element in the probe sequence of a hash.
+     *
+     * @param mixed The mixed hash.
+     * @return The index of the slot.
+     */
+    [[nodiscard]] std::size_t find_free(std::uint64_t mixed) const {
+        std::size_t group = static_cast<std::size_t>(mixed >> 7) & group_mask();
+        for (std::size_t probe = 1;; ++probe) {
+            const std::size_t first  = group * detail::flat_group_size;
+            const std::uint32_t free = detail::ctrl_group(m_ctrl.data() + first).match_free();
+            if (free != 0) {
+                return first + static_cast<std::size_t>(std::countr_zero(free));
+            }
+
+            assert(probe <= group_mask());
+            group = (group + probe) & group_mask();
+        }
+    }
+
+    /**
+     * @brief Rebuilds the table, it doubles the capacity unless most of the used slots are deleted.
+     */
+    void grow() {
+        const std::size_t new_capacity = m_size * 2 < capacity() ? capacity() : capacity() * 2;
+
+        std::vector<std::uint8_t, ctrl_allocator_t> old_ctrl(new_capacity, detail::ctrl_empty);
+        std::vector<slot, slot_allocator_t> old_slots(new_capacity);
+        old_ctrl.swap(m_ctrl);
+        old_slots.swap(m_slots);
+        m_deleted = 0;
+
+        for (std::size_t i = 0; i < old_ctrl.size(); ++i) {
+            if ((old_ctrl[i] & 0x80) != 0) {
+                continue;
+            }
+
+            const std::uint64_t mixed = detail::mix_hash(old_slots[i].hash);
+            const std::size_t pos     = find_free(mixed);
+            m_ctrl[pos]               = old_ctrl[i];
+            m_slots[pos]              = std::move(old_slots[i]);
+        }
+    }
+};
+
+/**
+ * @brief A hash array with open addressing in one flat slot array.
+ *
+ * It has the interface of `hash_array` and the storage of `flat_template_hash_array`.
+ *
+ * @tparam Key The key type.
+ * @tparam KeyID The key ID type.
+ * @tparam KeyAdapter The key adapter type.
+ * @tparam Hash The hash function type.
+ * @tparam Allocator The allocator type.
+ * @tparam Stats The probe statistics policy.
+ */
+template <
+    typename Key,
+    typename KeyID,
+    is_key_adapter<Key, KeyID> KeyAdapter,
+    is_hash<Key> Hash    = std::hash<Key>,
+    typename Allocator   = std::allocator<std::byte>,
+    is_probe_stats Stats = no_probe_stats>
+class flat_hash_array {
+private:
+    using key_t     = Key;
+    using key_id_t  = KeyID;
+    using adapter_t = KeyAdapter;
+
+    struct adapter_wrapper {
+        template <bool> bool eql(const key_t& key, const key_id_t& id) const { return adapter.eql(key, id); }
+
+        adapter_t adapter;
+    };
+
+    struct hash_wrapper {
+        template <bool> std::size_t hash(const key_t& key) { return Hash()(key); }
+    };
+
+    constexpr static bool comptime_value = true;
+
+    using storage_t
+        = flat_template_hash_array<key_t, key_id_t, bool, adapter_wrapper, hash_wrapper, Allocator, Stats>;
+
+public:
+    using iterator_t       = storage_t::iterator_t;
+    using const_iterator_t = storage_t::const_iterator_t;
+
+    /**
+     * @brief Default constructor.
+     */
+    flat_hash_array() = default;
+
+    /**
+     * @brief Constructor with bucket count.
+     *
+     * @param bucket_count Minimal number of slots.
+     */
+    flat_hash_array(std::size_t bucket_count)
+        : m_storage(bucket_count) { }
+
+    /**
+     * @brief Check if the hash_array is empty.
+     * @return bool True if empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_storage.empty(); }
+
+    /**
+     * @brief Get the number of elements in the hash_array.
+     * @return std::size_t Number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_storage.size(); }
+
+    /**
+     * @brief Returns the number of slots.
+     * @return std::size_t Number of slots.
+     */
+    [[nodiscard]] std::size_t bucket_count() const { return m_storage.bucket_count(); }
+
+    /**
+     * @brief Returns the maximum load factor.
+     * @return float Maximum load factor.
+     */
+    [[nodiscard]] float max_load_factor() const { return m_storage.max_load_factor(); }
+
+    /**
+     * @brief Sets a new maximum load factor.
+     * @param factor New maximum load factor.
+     */
+    void set_max_load_factor(float factor) { m_storage.set_max_load_factor(factor); }
+
+    /**
+     * @brief Clear all elements from the hash_array.
+     */
+    void clear() { m_storage.clear(); }
+
+    /**
+     * @brief Returns the probe statistics.
+     * @return const Stats& The statistics.
+     */
+    [[nodiscard]] const Stats& stats() const { return m_storage.stats(); }
+
+    /**
+     * @brief Resets the probe statistics.
+     */
+    void reset_stats() { m_storage.reset_stats(); }
+
+    /**
+     * @brief Try to insert a key and key ID into the hash_array.
+     * @param key The key to insert.
+     * @param key_id The key ID to insert.
+     * @return bool True if the key is not inside hash_array, false otherwise.
+     */
+    bool try_insert(const key_t& key, const key_id_t& key_id, adapter_t adapter) {
+        return m_storage.template try_insert<comptime_value>(key, key_id, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Try to set new key ID.
+     * @param key The key.
+     * @param new_key_id The new key ID.
+     * @return bool True if the key ID was changed, false otherwise.
+     */
+    bool try_set(const key_t& key, const key_id_t& new_key_id, adapter_t adapter) {
+        return m_storage.template try_set<comptime_value>(key, new_key_id, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Erases an element from the hash table.
+     *
+     * @param key Key of the element to erase.
+     * @param adapter Key adapter for comparison.
+     */
+    void erase(const key_t& key, adapter_t adapter) {
+        m_storage.template erase<comptime_value>(key, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Finds an element in the hash table.
+     *
+     * @param key Key of the element to find.
+     * @param adapter Key adapter for comparison.
+     * @return iterator_t The iterator with found element, if not found end() is returned.
+     */
+    iterator_t find(const key_t& key, adapter_t adapter) {
+        return m_storage.template find<comptime_value>(key, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Finds an element in the hash table.
+     *
+     * @param key Key of the element to find.
+     * @param adapter Key adapter for comparison.
+     * @return const_iterator_t The iterator with found element, if not found end() is returned.
+     */
+    const_iterator_t find(const key_t& key, adapter_t adapter) const {
+        return m_storage.template find<comptime_value>(key, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * @param keys Keys of the elements to find.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    void find_batch(std::span<const key_t> keys, std::span<iterator_t> out, adapter_t adapter) {
+        m_storage.template find_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * @param keys Keys of the elements to find.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    void find_batch(std::span<const key_t> keys, std::span<const_iterator_t> out, adapter_t adapter) const {
+        m_storage.template find_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Checks which keys of a batch are in the hash table.
+     *
+     * @param keys The keys.
+     * @param out The flags of found keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     * @return std::size_t The number of found keys.
+     */
+    std::size_t contains_batch(std::span<const key_t> keys, std::span<bool> out, adapter_t adapter) const {
+        return m_storage.template contains_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
+    iterator_t begin() { return m_storage.begin(); }
+
+    iterator_t end() { return m_storage.end(); }
+
+    const_iterator_t begin() const { return m_storage.begin(); }
+
+    const_iterator_t end() const { return m_storage.end(); }
+
+    const_iterator_t cbegin() const { return m_storage.cbegin(); }
+
+    const_iterator_t cend() const { return m_storage.cend(); }
+
+private:
+    storage_t m_storage;
+};
+
+}
+
+#endif
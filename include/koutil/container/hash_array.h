@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <functional>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -38,13 +39,18 @@ concept is_key_adapter = requires(const Key& key, T adapter, const KeyID& index)
 };
 
 /**
- * @brief A hash array with open addressing and linear probing.
+ * @brief A hash array with separate chaining.
+ *
+ * Every bucket is a sequence of stored hashes and key IDs. `flat_hash_array` keeps all elements in one slot array.
+ *
  * @tparam Key The key type.
  * @tparam KeyID The key ID type.
  * @tparam KeyAdapter The key adapter type.
  * @tparam Hash The hash function type.
  * @tparam Bucket The bucket type.
  * @tparam Allocator The allocator type.
+ * @tparam Stats The probe statistics policy.
+ * @tparam BucketPolicy The policy mapping hashes to buckets.
  */
 template <
     typename Key,
@@ -52,7 +58,9 @@ template <
     is_key_adapter<Key, KeyID> KeyAdapter,
     is_hash<Key> Hash              = std::hash<Key>,
     is_bucket<KeyID> Bucket        = std::vector<std::pair<std::size_t, KeyID>>,
-    is_allocator<Bucket> Allocator = std::allocator<Bucket>>
+    is_allocator<Bucket> Allocator = std::allocator<Bucket>,
+    is_probe_stats Stats           = no_probe_stats,
+    is_bucket_policy BucketPolicy  = fibonacci_bucket_policy>
 class hash_array {
 private:
     using key_t       = Key;
@@ -78,8 +86,16 @@ class hash_array {
 
     constexpr static bool comptime_value = true;
 
-    using template_hash_array_t
-        = template_hash_array<key_t, key_id_t, bool, adapter_wrapper, hash_wrapper, bucket_t, allocator_t>;
+    using template_hash_array_t = template_hash_array<
+        key_t,
+        key_id_t,
+        bool,
+        adapter_wrapper,
+        hash_wrapper,
+        bucket_t,
+        allocator_t,
+        Stats,
+        BucketPolicy>;
 
 public:
     using iterator_t       = template_hash_array_t::iterator_t;
@@ -93,7 +109,7 @@ class hash_array {
     /**
      * @brief Constructor with bucket count.
      *
-     * @param bucket_count Number of buckets.
+     * @param bucket_count Number of buckets, it is rounded up to a count supported by the bucket policy.
      */
     hash_array(std::size_t bucket_count)
         : m_storage(bucket_count) { }
@@ -169,11 +185,41 @@ class hash_array {
         m_storage.set_max_load_factor(factor);
     }
 
+    /**
+     * @brief Returns the number of old buckets migrated by every insert and erase during a rehash.
+     * @return std::size_t The number of buckets, zero if the table is rehashed at once.
+     */
+    [[nodiscard]] std::size_t rehash_step() const { return m_storage.rehash_step(); }
+
+    /**
+     * @brief Selects between rehashing at once and incremental rehashing.
+     *
+     * @param step The number of buckets migrated by a mutation, zero to rehash at once.
+     */
+    void set_rehash_step(std::size_t step) { m_storage.set_rehash_step(step); }
+
+    /**
+     * @brief Checks if an incremental rehash is in progress.
+     * @return bool True if the old table still holds elements, false otherwise.
+     */
+    [[nodiscard]] bool is_rehashing() const { return m_storage.is_rehashing(); }
+
     /**
      * @brief Clear all elements from the hash_array.
      */
     void clear() { m_storage.clear(); }
 
+    /**
+     * @brief Returns the probe statistics.
+     * @return const Stats& The statistics.
+     */
+    [[nodiscard]] const Stats& stats() const { return m_storage.stats(); }
+
+    /**
+     * @brief Resets the probe statistics.
+     */
+    void reset_stats() { m_storage.reset_stats(); }
+
     /**
      * @brief Try to insert a key and key ID into the hash_array.
      * @param key The key to insert.
@@ -228,6 +274,42 @@ class hash_array {
         return m_storage.template find<comptime_value>(key, adapter_wrapper { adapter });
     }
 
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * All keys of a group are hashed and their buckets prefetched before they are probed.
+     *
+     * @param keys Keys of the elements to find.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    void find_batch(std::span<const key_t> keys, std::span<iterator_t> out, adapter_t adapter) {
+        m_storage.template find_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * @param keys Keys of the elements to find.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    void find_batch(std::span<const key_t> keys, std::span<const_iterator_t> out, adapter_t adapter) const {
+        m_storage.template find_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
+    /**
+     * @brief Checks which keys of a batch are in the hash table.
+     *
+     * @param keys The keys.
+     * @param out The flags of found keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     * @return std::size_t The number of found keys.
+     */
+    std::size_t contains_batch(std::span<const key_t> keys, std::span<bool> out, adapter_t adapter) const {
+        return m_storage.template contains_batch<comptime_value>(keys, out, adapter_wrapper { adapter });
+    }
+
     /**
      * @brief Get an iterator to the beginning of the hash_array.
      * @return iterator_t Iterator to the beginning.
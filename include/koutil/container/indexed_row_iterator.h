@@ -0,0 +1,118 @@
+#ifndef KOUTIL_CONTAINER_INDEXED_ROW_ITERATOR_H
+#define KOUTIL_CONTAINER_INDEXED_ROW_ITERATOR_H
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace koutil::container {
+
+/**
+ * @brief Random access iterator over the rows of a container whose columns are not contiguous.
+ *
+ * The iterator holds the container and a row index, and dereferences through `Container::at`.
+ *
+ * @tparam Container The type of the container, const-qualified for a constant iterator.
+ */
+template <typename Container> class indexed_row_iterator {
+public:
+    using value_type        = decltype(std::declval<Container&>().at(std::size_t {}));
+    using reference         = value_type;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
+
+    indexed_row_iterator() = default;
+
+    /**
+     * @brief Constructs an iterator pointing to a row.
+     *
+     * @param container The container.
+     * @param pos The index of the row.
+     */
+    indexed_row_iterator(Container* container, std::size_t pos)
+        : m_container(container)
+        , m_pos(pos) { }
+
+    /**
+     * @brief Converts a mutable iterator to a constant iterator.
+     *
+     * @tparam Other The type of the container of the other iterator.
+     * @param other The iterator to convert.
+     */
+    template <typename Other>
+        requires(std::is_const_v<Container> && std::is_same_v<const Other, Container>)
+    indexed_row_iterator(const indexed_row_iterator<Other>& other)
+        : m_container(other.container())
+        , m_pos(other.pos()) { }
+
+    reference operator*() const { return m_container->at(m_pos); }
+
+    reference operator[](difference_type n) const { return *(*this + n); }
+
+    indexed_row_iterator& operator++() { return *this += 1; }
+
+    indexed_row_iterator operator++(int) {
+        indexed_row_iterator tmp = *this;
+        *this += 1;
+        return tmp;
+    }
+
+    indexed_row_iterator& operator--() { return *this -= 1; }
+
+    indexed_row_iterator operator--(int) {
+        indexed_row_iterator tmp = *this;
+        *this -= 1;
+        return tmp;
+    }
+
+    indexed_row_iterator& operator+=(difference_type n) {
+        m_pos = static_cast<std::size_t>(static_cast<difference_type>(m_pos) + n);
+        return *this;
+    }
+
+    indexed_row_iterator& operator-=(difference_type n) { return *this += -n; }
+
+    indexed_row_iterator operator+(difference_type n) const {
+        indexed_row_iterator tmp = *this;
+        return tmp += n;
+    }
+
+    friend indexed_row_iterator operator+(difference_type n, const indexed_row_iterator& it) { return it + n; }
+
+    indexed_row_iterator operator-(difference_type n) const {
+        indexed_row_iterator tmp = *this;
+        return tmp -= n;
+    }
+
+    difference_type operator-(const indexed_row_iterator& other) const {
+        return static_cast<difference_type>(m_pos) - static_cast<difference_type>(other.m_pos);
+    }
+
+    bool operator==(const indexed_row_iterator& other) const { return m_pos == other.m_pos; }
+
+    auto operator<=>(const indexed_row_iterator& other) const { return m_pos <=> other.m_pos; }
+
+    /**
+     * @brief Returns the container.
+     *
+     * @return Pointer to the container.
+     */
+    [[nodiscard]] Container* container() const { return m_container; }
+
+    /**
+     * @brief Returns the index of the row.
+     *
+     * @return The index of the row.
+     */
+    [[nodiscard]] std::size_t pos() const { return m_pos; }
+
+private:
+    Container* m_container = nullptr;
+    std::size_t m_pos      = 0;
+};
+
+}
+
+#endif
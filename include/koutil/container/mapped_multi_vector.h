@@ -0,0 +1,616 @@
+#ifndef KOUTIL_CONTAINER_MAPPED_MULTI_VECTOR_H
+#define KOUTIL_CONTAINER_MAPPED_MULTI_VECTOR_H
+
+#include "koutil/container/bit_column.h"
+#include "koutil/container/indexed_row_iterator.h"
+#include "koutil/container/multi_vector.h"
+#include "koutil/util/utils.h"
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <source_location>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(OS_LINUX)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace koutil::container {
+
+/**
+ * @brief Enumerates the errors of saving and mapping a multi_vector file.
+ */
+enum class MappedError {
+    NONE, /**< No error. */
+    OPEN_FAIL, /**< The file could not be opened. */
+    WRITE_FAIL, /**< The file could not be written. */
+    MAP_FAIL, /**< The file could not be mapped. */
+    FORMAT_MISMATCH, /**< The file is not a multi_vector file with the requested columns. */
+    UNSUPPORTED, /**< Mapping files is not supported on the platform. */
+};
+
+namespace detail {
+
+    /**
+     * @brief Alignment of the column blocks in a multi_vector file.
+     *
+     * Every column starts on its own page, so its elements are aligned in the mapping.
+     */
+    inline constexpr std::size_t mapped_block_alignment = 4096;
+
+    inline constexpr std::array<char, 8> mapped_magic   = { 'K', 'O', 'U', 'T', 'I', 'L', 'M', 'V' };
+    inline constexpr std::uint32_t mapped_version       = 2;
+    inline constexpr std::uint32_t mapped_byte_order    = 0x01020304;
+
+    /**
+     * @brief Header at the beginning of a multi_vector file.
+     */
+    struct mapped_header {
+        std::array<char, 8> magic;
+        std::uint32_t version;
+        std::uint32_t byte_order;
+        std::uint64_t size;
+        std::uint64_t column_count;
+    };
+
+    /**
+     * @brief Description of a column following the header.
+     */
+    struct mapped_column {
+        std::uint32_t kind;
+        std::uint32_t element_size;
+        std::uint64_t fingerprint;
+        std::uint64_t offset;
+        std::uint64_t bytes;
+    };
+
+    /**
+     * @brief Returns the code describing the kind of an element type.
+     *
+     * @tparam T The element type.
+     * @return The code.
+     */
+    template <typename T> consteval std::uint32_t mapped_kind() {
+        if constexpr (std::is_same_v<T, packed_bool>) {
+            return 1;
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return 2;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return 3;
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+            return 4;
+        } else if constexpr (std::is_integral_v<T>) {
+            return 5;
+        } else if constexpr (std::is_enum_v<T>) {
+            return 6;
+        } else if constexpr (std::is_class_v<T> || std::is_union_v<T>) {
+            return 7;
+        } else {
+            return 0;
+        }
+    }
+
+    inline constexpr std::uint64_t fnv_offset = 14695981039346656037ULL;
+    inline constexpr std::uint64_t fnv_prime  = 1099511628211ULL;
+
+    /**
+     * @brief Appends bytes to an FNV-1a hash.
+     *
+     * @param hash The hash.
+     * @param bytes The bytes.
+     * @return The new hash.
+     */
+    constexpr std::uint64_t fnv_append(std::uint64_t hash, std::string_view bytes) {
+        for (const char byte : bytes) {
+            hash = (hash ^ static_cast<unsigned char>(byte)) * fnv_prime;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Appends the bytes of a value in little-endian order to an FNV-1a hash.
+     *
+     * @param hash The hash.
+     * @param value The value.
+     * @return The new hash.
+     */
+    constexpr std::uint64_t fnv_append(std::uint64_t hash, std::uint64_t value) {
+        for (std::size_t i = 0; i < sizeof(value); ++i) {
+            hash = (hash ^ ((value >> (i * 8)) & 0xFF)) * fnv_prime;
+        }
+        return hash;
+    }
+
+    /**
+     * @brief Returns the name of a type as spelled by the compiler.
+     *
+     * The name is cut out of the signature of the function, so GCC and Clang produce the same name.
+     *
+     * @tparam T The type.
+     * @return The name of the type.
+     */
+    template <typename T> consteval std::string_view mapped_type_name() {
+        constexpr std::string_view marker = "T = ";
+
+        const std::string_view signature = std::source_location::current().function_name();
+        const std::size_t begin          = signature.find(marker);
+        if (begin == std::string_view::npos) {
+            return signature;
+        }
+
+        const std::string_view name = signature.substr(begin + marker.size());
+        return name.substr(0, name.find_first_of(";]"));
+    }
+
+    /**
+     * @brief Returns the fingerprint of an element type stored in a column description.
+     *
+     * The fingerprint covers the kind and the alignment of the type, and the name of enums and classes, so a file
+     * saved with one struct or enum is not opened as another one with the same size.
+     *
+     * @tparam T The element type.
+     * @return The fingerprint.
+     */
+    template <typename T> consteval std::uint64_t mapped_fingerprint() {
+        std::uint64_t hash = fnv_append(fnv_offset, std::uint64_t { mapped_kind<T>() });
+
+        if constexpr (!std::is_same_v<T, packed_bool>) {
+            hash = fnv_append(hash, std::uint64_t { alignof(T) });
+
+            if constexpr (std::is_enum_v<T> || std::is_class_v<T> || std::is_union_v<T>) {
+                hash = fnv_append(hash, mapped_type_name<T>());
+            }
+        }
+
+        return hash;
+    }
+
+    /**
+     * @brief Returns the description of a column without its position in the file.
+     *
+     * @tparam T The element type.
+     * @param size The number of elements.
+     * @return The description of the column.
+     */
+    template <typename T> constexpr mapped_column mapped_column_of(std::size_t size) {
+        if constexpr (std::is_same_v<T, packed_bool>) {
+            return { mapped_kind<T>(), 0, mapped_fingerprint<T>(), 0, bit_word_count(size) * sizeof(bit_word) };
+        } else {
+            return { mapped_kind<T>(), sizeof(T), mapped_fingerprint<T>(), 0, size * sizeof(T) };
+        }
+    }
+
+    /**
+     * @brief Checks if a column with a number of elements can fit into a file, without overflowing its byte size.
+     *
+     * @tparam T The element type.
+     * @param size The number of elements.
+     * @param bytes The size of the file.
+     * @return True if the elements can fit into the file, false otherwise.
+     */
+    template <typename T> constexpr bool mapped_column_fits(std::uint64_t size, std::size_t bytes) {
+        if constexpr (std::is_same_v<T, packed_bool>) {
+            return size / bit_word_bits <= bytes / sizeof(bit_word);
+        } else {
+            return size <= bytes / sizeof(T);
+        }
+    }
+
+    /**
+     * @brief Concept to check if a type can be stored in a multi_vector file.
+     *
+     * Pointers are rejected, the addresses they hold are meaningless in another process.
+     *
+     * @tparam T The type to check.
+     */
+    template <typename T>
+    concept is_mapped_element = std::is_same_v<T, packed_bool> || std::is_void_v<T>
+        || (std::is_trivially_copyable_v<T> && !std::is_pointer_v<T> && !std::is_member_pointer_v<T>
+            && alignof(T) <= mapped_block_alignment);
+
+    constexpr std::uint64_t align_block(std::uint64_t offset) {
+        return (offset + mapped_block_alignment - 1) / mapped_block_alignment * mapped_block_alignment;
+    }
+
+    /**
+     * @brief Writes the bytes of an object or an array.
+     *
+     * @param out The output stream.
+     * @param data Pointer to the first byte.
+     * @param bytes The number of bytes.
+     */
+    inline void write_bytes(std::ofstream& out, const void* data, std::size_t bytes) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        out.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+    }
+
+    /**
+     * @brief Writes zero bytes up to an offset.
+     *
+     * @param out The output stream.
+     * @param from The current offset.
+     * @param to The offset to pad to.
+     */
+    inline void write_padding(std::ofstream& out, std::uint64_t from, std::uint64_t to) {
+        constexpr std::array<char, mapped_block_alignment> zeros {};
+        assert(to - from <= zeros.size());
+        out.write(zeros.data(), static_cast<std::streamsize>(to - from));
+    }
+
+}
+
+/**
+ * @brief Writes a multi_vector to a file which can be mapped by `open_mapped`.
+ *
+ * The file starts with a header describing the used types, followed by one block per column aligned to a page.
+ * Only trivially copyable elements other than pointers and packed bool columns are supported.
+ *
+ * @tparam Layout The storage layout of the multi_vector.
+ * @tparam Types The types of elements stored in the multi_vector.
+ * @param vec The multi_vector.
+ * @param path The path of the file.
+ * @return The error, `MappedError::NONE` on success.
+ */
+template <is_multi_vector_layout Layout, is_multi_vector_element... Types>
+    requires(detail::is_mapped_element<Types> && ...)
+MappedError save(const basic_multi_vector<Layout, Types...>& vec, const std::filesystem::path& path) {
+    using used_types = typename basic_multi_vector<Layout, Types...>::used_types;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        return MappedError::OPEN_FAIL;
+    }
+
+    std::array<detail::mapped_column, used_types::size> columns;
+    std::uint64_t offset = sizeof(detail::mapped_header) + sizeof(columns);
+
+    std::size_t column = 0;
+    auto describe      = [&]<typename T>(std::type_identity<T> /*unused*/) {
+        if constexpr (!std::is_void_v<T>) {
+            columns[column]        = detail::mapped_column_of<T>(vec.size());
+            columns[column].offset = detail::align_block(offset);
+            offset                 = columns[column].offset + columns[column].bytes;
+            column += 1;
+        }
+    };
+    (describe(std::type_identity<Types>()), ...);
+
+    const detail::mapped_header header {
+        detail::mapped_magic, detail::mapped_version, detail::mapped_byte_order, vec.size(), used_types::size,
+    };
+
+    detail::write_bytes(out, &header, sizeof(header));
+    detail::write_bytes(out, columns.data(), sizeof(columns));
+
+    column = 0;
+    offset = sizeof(header) + sizeof(columns);
+
+    auto write_column = [&]<std::size_t I>(std::integral_constant<std::size_t, I> /*unused*/) {
+        using element = std::tuple_element_t<I, std::tuple<Types...>>;
+
+        if constexpr (!std::is_void_v<element>) {
+            detail::write_padding(out, offset, columns[column].offset);
+
+            const auto container = vec.template get_container<I>();
+            if constexpr (std::is_same_v<element, packed_bool>) {
+                detail::write_bytes(out, container.words().data(), columns[column].bytes);
+            } else {
+                detail::write_bytes(out, container.data(), columns[column].bytes);
+            }
+
+            offset = columns[column].offset + columns[column].bytes;
+            column += 1;
+        }
+    };
+
+    [&]<std::size_t... I>(std::index_sequence<I...> /*unused*/) {
+        (write_column(std::integral_constant<std::size_t, I>()), ...);
+    }(std::index_sequence_for<Types...>());
+
+    out.flush();
+    return out ? MappedError::NONE : MappedError::WRITE_FAIL;
+}
+
+/**
+ * @brief Read-only multi_vector whose columns point into a file mapped into memory.
+ *
+ * Nothing is copied when the file is opened, the pages of a column are read by the kernel when they are first touched.
+ *
+ * @tparam Types The used types of the saved multi_vector.
+ */
+template <typename... Types>
+    requires(sizeof...(Types) != 0 && ((detail::is_mapped_element<Types> && !std::is_void_v<Types>) && ...))
+class mapped_multi_vector {
+private:
+    static constexpr std::size_t column_count = sizeof...(Types);
+
+    static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+public:
+    using value_ref_t       = std::tuple<typename column_traits<const Types>::reference...>;
+    using const_value_ref_t = value_ref_t;
+    using value_t           = std::tuple<typename column_traits<Types>::value_type...>;
+
+    using iterator_t       = indexed_row_iterator<const mapped_multi_vector>;
+    using const_iterator_t = iterator_t;
+
+    mapped_multi_vector() = default;
+
+    mapped_multi_vector(const mapped_multi_vector&)            = delete;
+    mapped_multi_vector& operator=(const mapped_multi_vector&) = delete;
+
+    mapped_multi_vector(mapped_multi_vector&& other)
+        : m_mapping(std::exchange(other.m_mapping, nullptr))
+        , m_bytes(std::exchange(other.m_bytes, 0))
+        , m_size(std::exchange(other.m_size, 0))
+        , m_columns(other.m_columns) { }
+
+    mapped_multi_vector& operator=(mapped_multi_vector&& other) {
+        if (&other != this) {
+            close();
+            m_mapping = std::exchange(other.m_mapping, nullptr);
+            m_bytes   = std::exchange(other.m_bytes, 0);
+            m_size    = std::exchange(other.m_size, 0);
+            m_columns = other.m_columns;
+        }
+        return *this;
+    }
+
+    ~mapped_multi_vector() { close(); }
+
+    /**
+     * @brief Maps a file written by `save`.
+     *
+     * The previously mapped file is unmapped first.
+     *
+     * @param path The path of the file.
+     * @return The error, `MappedError::NONE` on success.
+     */
+    MappedError open(const std::filesystem::path& path) {
+        close();
+
+#if defined(OS_LINUX)
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return MappedError::OPEN_FAIL;
+        }
+
+        struct stat info { };
+        if (::fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(detail::mapped_header)) {
+            ::close(fd);
+            return MappedError::FORMAT_MISMATCH;
+        }
+
+        const auto bytes = static_cast<std::size_t>(info.st_size);
+        void* mapping    = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+
+        // the mapping keeps the file alive
+        ::close(fd);
+
+        if (mapping == MAP_FAILED) {
+            return MappedError::MAP_FAIL;
+        }
+
+        m_mapping = static_cast<const std::byte*>(mapping);
+        m_bytes   = bytes;
+
+        if (!read_layout()) {
+            close();
+            return MappedError::FORMAT_MISMATCH;
+        }
+
+        return MappedError::NONE;
+#else
+        (void)path;
+        return MappedError::UNSUPPORTED;
+#endif
+    }
+
+    /**
+     * @brief Unmaps the file.
+     */
+    void close() {
+#if defined(OS_LINUX)
+        if (m_mapping != nullptr) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            ::munmap(const_cast<std::byte*>(m_mapping), m_bytes);
+        }
+#endif
+        m_mapping = nullptr;
+        m_bytes   = 0;
+        m_size    = 0;
+    }
+
+    /**
+     * @brief Checks if a file is mapped.
+     *
+     * @return True if a file is mapped, false otherwise.
+     */
+    [[nodiscard]] bool is_open() const { return m_mapping != nullptr; }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Checks if the multi_vector is empty.
+     *
+     * @return True if the multi_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the elements of a column.
+     *
+     * @tparam I The index of the column.
+     * @return The span over the mapped elements.
+     */
+    template <std::size_t I> auto get_container() const {
+        return typename column_traits<const element_t<I>>::span(data<I>(), m_size);
+    }
+
+    /**
+     * @brief Returns a const reference to the first element.
+     *
+     * @return Const reference to the first element.
+     */
+    value_ref_t front() const {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a const reference to the last element.
+     *
+     * @return Const reference to the last element.
+     */
+    value_ref_t back() const {
+        assert(!empty());
+        return at(m_size - 1);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    value_ref_t at(std::size_t pos) const {
+        assert(pos < m_size);
+        return get_all(pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    iterator_t begin() const { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    iterator_t end() const { return iterator_t(this, m_size); }
+
+private:
+    const std::byte* m_mapping = nullptr;
+    std::size_t m_bytes        = 0;
+    std::size_t m_size         = 0;
+    std::array<std::size_t, column_count> m_columns {};
+
+    template <std::size_t I> typename column_traits<const element_t<I>>::pointer data() const {
+        if constexpr (std::is_same_v<element_t<I>, packed_bool>) {
+            return bit_pointer<const detail::bit_word>(
+                // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+                reinterpret_cast<const detail::bit_word*>(m_mapping + m_columns[I]), 0
+            );
+        } else {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<const element_t<I>*>(m_mapping + m_columns[I]);
+        }
+    }
+
+    template <std::size_t... I> value_ref_t get_all(std::size_t pos, std::index_sequence<I...> /*unused*/) const {
+        return value_ref_t { data<I>()[static_cast<std::ptrdiff_t>(pos)]... };
+    }
+
+    /**
+     * @brief Validates the header against the types and reads the positions of the columns.
+     *
+     * @return True if the header describes the types, false otherwise.
+     */
+    bool read_layout() {
+        constexpr std::size_t table_end = sizeof(detail::mapped_header) + column_count * sizeof(detail::mapped_column);
+
+        detail::mapped_header header {};
+        if (m_bytes < table_end) {
+            return false;
+        }
+        std::memcpy(&header, m_mapping, sizeof(header));
+
+        if (header.magic != detail::mapped_magic || header.version != detail::mapped_version
+            || header.byte_order != detail::mapped_byte_order || header.column_count != column_count) {
+            return false;
+        }
+
+        // a crafted size must not wrap around when the byte sizes of the columns are computed
+        if (!(detail::mapped_column_fits<Types>(header.size, m_bytes) && ...)) {
+            return false;
+        }
+
+        const auto size = static_cast<std::size_t>(header.size);
+
+        std::size_t column = 0;
+        auto check         = [&]<typename T>(std::type_identity<T> /*unused*/) {
+            detail::mapped_column stored {};
+            std::memcpy(
+                &stored, m_mapping + sizeof(header) + column * sizeof(detail::mapped_column), sizeof(stored)
+            );
+
+            const detail::mapped_column expected = detail::mapped_column_of<T>(size);
+
+            const bool valid = stored.kind == expected.kind && stored.element_size == expected.element_size
+                && stored.fingerprint == expected.fingerprint && stored.bytes == expected.bytes
+                && stored.offset % detail::mapped_block_alignment == 0 && stored.offset <= m_bytes
+                && stored.bytes <= m_bytes - stored.offset;
+
+            m_columns[column] = static_cast<std::size_t>(stored.offset);
+            column += 1;
+            return valid;
+        };
+
+        if (!(check(std::type_identity<Types>()) && ...)) {
+            return false;
+        }
+
+        m_size = size;
+        return true;
+    }
+};
+
+/**
+ * @brief Maps a file written by `save`.
+ *
+ * @tparam Types The used types of the saved multi_vector.
+ * @param path The path of the file.
+ * @return The mapped multi_vector, or an empty optional if the file could not be mapped.
+ */
+template <typename... Types>
+std::optional<mapped_multi_vector<Types...>> open_mapped(const std::filesystem::path& path) {
+    mapped_multi_vector<Types...> vec;
+    if (vec.open(path) != MappedError::NONE) {
+        return std::nullopt;
+    }
+
+    return vec;
+}
+
+}
+
+#endif
@@ -1,11 +1,19 @@
 #ifndef KOUTIL_CONTAINER_MULTI_VECTOR_H
 #define KOUTIL_CONTAINER_MULTI_VECTOR_H
 
+#include "koutil/container/multi_vector_storage.h"
+#include "koutil/container/permutation.h"
 #include "koutil/type/types.h"
+#include <algorithm>
 #include <cassert>
+#include <concepts>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <ranges>
 #include <span>
 #include <tuple>
 #include <type_traits>
@@ -23,349 +31,315 @@ template <typename T>
 concept is_multi_vector_element = !std::is_reference_v<T>;
 
 /**
- * @brief Class representing a multi_vector.
+ * @brief Random access iterator over the rows of a multi_vector.
  *
- * @tparam Types The types of elements stored in the multi_vector.
+ * The iterator holds one pointer per column and advances all of them together, so dereferencing does not go through
+ * the container. Packed bool columns are referenced through bit pointers.
+ *
+ * @tparam T The types of the referenced columns, const-qualified for a constant iterator.
  */
-template <is_multi_vector_element... Types>
-    requires(type::types_remove_t<type::types<Types...>, void>::size != 0)
-class multi_vector {
-private:
-    template <typename T, typename Allocator = std::allocator<T>> class single_vector {
-    public:
-        single_vector(std::size_t n)
-            : m_data(Allocator().allocate(n))
-            , m_capacity(n)
-            , m_size(n) {
-            std::uninitialized_fill_n(m_data, n, T());
-        }
-
-        single_vector(std::size_t n, const T& value)
-            : m_data(Allocator().allocate(n))
-            , m_capacity(n)
-            , m_size(n) {
-            std::uninitialized_fill_n(m_data, n, value);
-        }
-
-        single_vector() = default;
-
-        single_vector(const single_vector& other)
-            : m_data(Allocator().allocate(other.m_capacity))
-            , m_capacity(other.m_capacity)
-            , m_size(other.m_size) {
-            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
-        }
-
-        ~single_vector() {
-            if (m_capacity != 0) {
-                std::destroy_n(m_data, m_size);
-                Allocator().deallocate(m_data, m_capacity);
-            }
-        }
-
-        single_vector(single_vector&& other)
-            : m_data(other.m_data)
-            , m_capacity(other.m_capacity)
-            , m_size(other.m_size) {
-            other.m_capacity = 0;
-            other.m_size     = 0;
-            other.m_data     = nullptr;
-        }
-
-        single_vector& operator=(single_vector&& other) {
-            if (m_capacity != 0) {
-                std::destroy_n(m_data, m_size);
-                Allocator().deallocate(m_data, m_capacity);
-            }
-
-            m_size     = other.m_size;
-            m_capacity = other.m_capacity;
-            m_data     = other.m_data;
-
-            other.m_size     = 0;
-            other.m_capacity = 0;
-            other.m_data     = nullptr;
-
-            return *this;
-        }
-
-        single_vector& operator=(const single_vector& other) {
-            if (&other == this) {
-                return *this;
-            }
-
-            std::destroy_n(m_data, m_size);
-            if (m_capacity != other.m_capacity) {
-                auto alloc = Allocator();
-
-                alloc.deallocate(m_data, m_capacity);
-
-                m_data = new (alloc.allocate(other.m_capacity)) T[other.m_capacity];
-            }
-
-            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
-
-            m_capacity = other.m_capacity;
-            m_size     = other.m_size;
-
-            return *this;
-        }
-
-        void clear() { m_size = 0; }
-
-        void swap(single_vector& other) {
-            std::swap(m_data, other.m_data);
-            std::swap(m_size, other.m_size);
-            std::swap(m_capacity, other.m_capacity);
-        }
-
-        void push_back(const T& value) {
-            try_update_capacity();
-
-            m_data[m_size] = value;
-            m_size += 1;
-        }
-
-        void push_back(T&& value) {
-            try_update_capacity();
-
-            m_data[m_size] = std::move(value);
-            m_size += 1;
-        }
-
-        template <typename Arg> T& emplace_back(Arg&& arg) {
-            try_update_capacity();
-
-            m_data[m_size] = T(std::forward<decltype(arg)>(arg));
-            m_size += 1;
-
-            return m_data[m_size - 1];
-        }
-
-        T* erase(const T* element) {
-            assert(element <= m_data + m_size && element >= m_data);
-
-            // last element
-            if (m_data + m_size == element) {
-                m_size -= 1;
-                return m_data + m_size;
-            }
-
-            m_size -= 1;
-            if (m_size == m_capacity / 2) {
-                m_capacity /= 2;
-            }
-
-            const auto index = static_cast<std::size_t>(element - m_data);
-
-            realloc_without(m_capacity, index);
-
-            return m_data + index;
-        }
-
-        void pop_back() {
-            assert(m_size > 0);
-            m_size -= 1;
-        }
-
-        void resize(std::size_t n) { resize(n, {}); }
-
-        void resize(std::size_t n, const T& value) {
-            if (m_size >= n) {
-                m_size = n;
-                return;
-            }
+template <typename... T> class multi_vector_iterator {
+public:
+    using value_type        = std::tuple<typename column_traits<T>::reference...>;
+    using reference         = value_type;
+    using difference_type   = std::ptrdiff_t;
+    using iterator_category = std::random_access_iterator_tag;
 
-            if (m_capacity >= n) {
-                std::uninitialized_fill_n(m_data + m_size, m_capacity - m_size, value);
-            } else {
-                realloc_with_value(n, value);
-            }
-            m_size = n;
-        }
+    multi_vector_iterator()                                        = default;
+    multi_vector_iterator(const multi_vector_iterator&)            = default;
+    multi_vector_iterator(multi_vector_iterator&&)                 = default;
+    multi_vector_iterator& operator=(const multi_vector_iterator&) = default;
+    multi_vector_iterator& operator=(multi_vector_iterator&&)      = default;
 
-        void reserve(std::size_t n) {
-            if (n <= m_capacity) {
-                return;
-            }
+    /**
+     * @brief Constructs an iterator from a pointer into every column.
+     *
+     * @param ptrs The pointers to the current element of every column.
+     */
+    explicit multi_vector_iterator(typename column_traits<T>::pointer... ptrs)
+        : m_ptrs(ptrs...) { }
 
-            realloc(n);
-        }
+    /**
+     * @brief Converts a mutable iterator to a constant iterator.
+     *
+     * @tparam U The types of the columns of the other iterator.
+     * @param other The iterator to convert.
+     */
+    template <typename... U>
+        requires(
+            (std::is_convertible_v<typename column_traits<U>::pointer, typename column_traits<T>::pointer> && ...)
+            && !(std::is_same_v<U, T> && ...)
+        )
+    multi_vector_iterator(const multi_vector_iterator<U...>& other)
+        : m_ptrs(other.m_ptrs) { }
 
-        T& at(std::size_t i) { return m_data[i]; }
+    reference operator*() const {
+        return std::apply([](const auto&... ptrs) { return reference(*ptrs...); }, m_ptrs);
+    }
 
-        [[nodiscard]] const T& at(std::size_t i) const { return m_data[i]; }
+    reference operator[](difference_type n) const { return *(*this + n); }
 
-        T* data() { return m_data; }
+    multi_vector_iterator& operator++() { return *this += 1; }
 
-        [[nodiscard]] const T* data() const { return m_data; }
+    multi_vector_iterator operator++(int) {
+        multi_vector_iterator tmp = *this;
+        *this += 1;
+        return tmp;
+    }
 
-        [[nodiscard]] std::size_t size() const { return m_size; }
+    multi_vector_iterator& operator--() { return *this -= 1; }
 
-        T* begin() { return m_data; }
+    multi_vector_iterator operator--(int) {
+        multi_vector_iterator tmp = *this;
+        *this -= 1;
+        return tmp;
+    }
 
-        const T* begin() const { return m_data; }
+    multi_vector_iterator& operator+=(difference_type n) {
+        std::apply([n](auto&... ptrs) { ((ptrs += n), ...); }, m_ptrs);
+        return *this;
+    }
 
-        T* end() { return m_data + m_size; }
+    multi_vector_iterator& operator-=(difference_type n) { return *this += -n; }
 
-        const T* end() const { return m_data + m_size; }
+    multi_vector_iterator operator+(difference_type n) const {
+        multi_vector_iterator tmp = *this;
+        return tmp += n;
+    }
 
-    private:
-        T* m_data              = nullptr;
-        std::size_t m_capacity = 0;
-        std::size_t m_size     = 0;
+    friend multi_vector_iterator operator+(difference_type n, const multi_vector_iterator& it) { return it + n; }
 
-        [[nodiscard]] std::size_t next_capacity() const {
-            if (m_capacity == 0) {
-                return 1;
-            } else [[likely]] {
-                return m_capacity * 2;
-            }
-        }
+    multi_vector_iterator operator-(difference_type n) const {
+        multi_vector_iterator tmp = *this;
+        return tmp -= n;
+    }
 
-        void try_update_capacity() {
-            if (m_size + 1 <= m_capacity) {
-                return;
-            }
-            realloc(next_capacity());
-        }
+    difference_type operator-(const multi_vector_iterator& other) const {
+        return std::get<0>(m_ptrs) - std::get<0>(other.m_ptrs);
+    }
 
-        void realloc(std::size_t capacity) {
-            const std::size_t old_capacity = m_capacity;
-            m_capacity                     = capacity;
+    bool operator==(const multi_vector_iterator& other) const {
+        return std::get<0>(m_ptrs) == std::get<0>(other.m_ptrs);
+    }
 
-            auto alloc     = Allocator();
-            auto* new_data = new (alloc.allocate(m_capacity)) T[m_capacity];
+    auto operator<=>(const multi_vector_iterator& other) const {
+        return std::get<0>(m_ptrs) <=> std::get<0>(other.m_ptrs);
+    }
 
-            std::uninitialized_move(m_data, m_data + m_size, new_data);
+    /**
+     * @brief Returns the pointer into a column.
+     *
+     * @tparam I The index of the column.
+     * @return The pointer to the current element of the column.
+     */
+    template <std::size_t I> auto column() const { return std::get<I>(m_ptrs); }
 
-            std::destroy_n(m_data, m_size);
-            alloc.deallocate(m_data, old_capacity);
-            m_data = new_data;
-        }
+private:
+    std::tuple<typename column_traits<T>::pointer...> m_ptrs;
 
-        void realloc_with_value(std::size_t capacity, const T& value = {}) {
-            realloc(capacity);
-            std::uninitialized_fill_n(m_data + m_size, m_capacity - m_size, value);
-        }
+    template <typename... U> friend class multi_vector_iterator;
+};
 
-        void realloc_without(std::size_t capacity, std::size_t index) {
-            const std::size_t old_capacity = m_capacity;
-            m_capacity                     = capacity;
+/**
+ * @brief Class representing a multi_vector with a configurable storage layout.
+ *
+ * @tparam Layout The storage layout of the columns.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <is_multi_vector_layout Layout, is_multi_vector_element... Types>
+    requires(type::types_remove_t<type::types<Types...>, void>::size != 0)
+class basic_multi_vector {
+private:
+    struct layout_storage {
+        template <typename... T> using transform = typename Layout::template storage<T...>;
+    };
 
-            auto alloc  = Allocator();
-            T* new_data = nullptr;
+    struct packed_storage_transform {
+        template <typename... T> using transform = detail::packed_storage<Layout, T...>;
+    };
 
-            if (m_capacity != 0) {
-                new_data = new (alloc.allocate(m_capacity)) T[m_capacity];
-                std::uninitialized_move_n(m_data, index, new_data);
-                std::uninitialized_move_n(m_data + index + 1, m_size - index, new_data);
-            }
+    struct iterator_transform {
+        template <typename... T> using transform = multi_vector_iterator<T...>;
+    };
 
-            std::destroy_n(m_data, m_size + 1);
-            alloc.deallocate(m_data, old_capacity);
-            m_data = new_data;
-        }
+    struct reference_transform {
+        template <typename... T> using transform = std::tuple<typename column_traits<T>::reference...>;
     };
 
-    struct single_vector_container {
-        template <typename T> using container = single_vector<T>;
+    struct value_transform {
+        template <typename... T> using transform = std::tuple<typename column_traits<T>::value_type...>;
     };
 
     using transforms = type::types_transforms;
     using containers = type::types_containers;
 
-    template <type::types_concept T, type::types_container Container>
-    using to_containers_t = type::types_to_containers_t<T, Container>;
-
     template <type::types_concept T, type::types_transform Transform>
     using transform_types_t = type::types_transform_t<T, Transform>;
 
     using all_types = type::types<Types...>;
     using types     = type::types_remove_t<all_types, void>;
 
-    using storage_t = transform_types_t<to_containers_t<types, single_vector_container>, transforms::tuple>;
+    static constexpr bool has_packed = type::types_count<types>::template value<packed_bool> != 0;
+
+    using storage_t = std::conditional_t<
+        has_packed,
+        transform_types_t<types, packed_storage_transform>,
+        transform_types_t<types, layout_storage>>;
 
     static constexpr auto helper_seq = std::make_index_sequence<types::size>();
 
-public:
     /**
-     * @brief Nested iterator class for multi_vector.
+     * @brief Maps an index into `Types` to an index into the used types.
      *
-     * @tparam is_const Whether the iterator is const.
+     * @tparam I The index into `Types`.
+     * @return The index of the column.
      */
-    template <bool is_const> class iterator;
+    template <std::size_t I> static consteval std::size_t column_index() {
+        static_assert(!std::is_same_v<type::types_get_t<all_types, I>, void>, "This type was removed");
+
+        if constexpr (I == 0) {
+            return 0;
+        } else {
+            // the view contains the first I types
+            using view                       = type::types_view_t<all_types, I>;
+            constexpr std::size_t count_void = type::types_count<view>::template value<void>;
+            return view::size - count_void;
+        }
+    }
+
+public:
+    using used_types     = types;
+    using layout_type    = Layout;
+    using allocator_type = Layout::allocator_type;
 
-    using used_types = types;
+    using value_ref_t       = transform_types_t<types, reference_transform>;
+    using const_value_ref_t = transform_types_t<transform_types_t<types, transforms::constant>, reference_transform>;
 
-    using value_ref_t = transform_types_t<transform_types_t<types, transforms::reference>, transforms::tuple>;
-    using const_value_ref_t
-        = transform_types_t<transform_types_t<types, transforms::constant_reference>, transforms::tuple>;
+    using value_t = transform_types_t<types, value_transform>;
 
-    using value_t = transform_types_t<types, transforms::tuple>;
+    using iterator_t       = transform_types_t<types, iterator_transform>;
+    using const_iterator_t = transform_types_t<transform_types_t<types, transforms::constant>, iterator_transform>;
 
-    using iterator_t       = iterator<false>;
-    using const_iterator_t = iterator<true>;
+    basic_multi_vector()                          = default;
+    basic_multi_vector(const basic_multi_vector&) = default;
+    basic_multi_vector(basic_multi_vector&&)      = default;
 
-    multi_vector()                    = default;
-    multi_vector(const multi_vector&) = default;
-    multi_vector(multi_vector&&)      = default;
+    /**
+     * @brief Constructs an empty multi_vector using an allocator.
+     *
+     * @param alloc The allocator used by every column.
+     */
+    explicit basic_multi_vector(const allocator_type& alloc)
+        : m_storage(alloc) { }
 
     /**
      * @brief Constructs a multi_vector with a specified size and initial value.
      *
      * @param count The number of elements.
      * @param value The initial value for the elements.
+     * @param alloc The allocator used by every column.
      */
-    multi_vector(std::size_t count, const value_t& value) { init_vector(count, value); }
+    basic_multi_vector(std::size_t count, const value_t& value, const allocator_type& alloc = allocator_type())
+        : m_storage(count, value, alloc) { }
 
     /**
      * @brief Constructs a multi_vector with a specified size and default-initialized elements.
      *
      * @param count The number of elements.
+     * @param alloc The allocator used by every column.
      */
-    explicit multi_vector(std::size_t count) { init_vector_default(count); }
+    explicit basic_multi_vector(std::size_t count, const allocator_type& alloc = allocator_type())
+        : m_storage(count, alloc) { }
+
+    basic_multi_vector& operator=(const basic_multi_vector& other) = default;
 
-    multi_vector& operator=(const multi_vector& other) = default;
+    basic_multi_vector& operator=(basic_multi_vector&&) = default;
 
-    multi_vector& operator=(multi_vector&&) = default;
+    /**
+     * @brief Returns the allocator used by the columns.
+     *
+     * @return The allocator.
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return m_storage.get_allocator(); }
 
     template <std::size_t I> decltype(auto) get_container() {
+        constexpr std::size_t index = column_index<I>();
 
-        static_assert(!std::is_same_v<type::types_get_t<all_types, I>, void>, "This type was removed");
+        using element = type::types_get_t<used_types, index>;
+
+        return typename column_traits<element>::span(m_storage.template data<index>(), size());
+    }
 
-        using view                       = type::types_view_t<all_types, I>;
-        constexpr std::size_t count_void = type::types_count<view>::template value<void>;
-        constexpr std::size_t index      = view::size - count_void;
+    template <std::size_t I> decltype(auto) get_container() const {
+        constexpr std::size_t index = column_index<I>();
 
         using element = type::types_get_t<used_types, index>;
 
-        auto& container = std::get<index>(m_storage);
-
-        if constexpr (std::is_same_v<element, bool>) {
-            return std::span<bool>(container.begin(), container.end());
-        } else {
-            return std::span { container };
-        }
+        return typename column_traits<const element>::span(m_storage.template data<index>(), size());
     }
 
-    template <std::size_t I> decltype(auto) get_container() const {
+    /**
+     * @brief Returns a view over a subset of the columns.
+     *
+     * Iterating the view touches only the selected columns.
+     *
+     * @tparam I The indices of the columns.
+     * @return The view yielding tuples of references to the selected columns.
+     */
+    template <std::size_t... I>
+        requires(sizeof...(I) > 0)
+    auto view() {
+        using iter = multi_vector_iterator<type::types_get_t<used_types, column_index<I>()>...>;
+
+        return std::ranges::subrange<iter>(
+            iter { m_storage.template data<column_index<I>()>()... },
+            iter { (m_storage.template data<column_index<I>()>() + size())... }
+        );
+    }
 
-        static_assert(!std::is_same_v<type::types_get_t<all_types, I>, void>, "This type was removed");
+    /**
+     * @brief Returns a constant view over a subset of the columns.
+     *
+     * @tparam I The indices of the columns.
+     * @return The view yielding tuples of const references to the selected columns.
+     */
+    template <std::size_t... I>
+        requires(sizeof...(I) > 0)
+    auto view() const {
+        using iter = multi_vector_iterator<const type::types_get_t<used_types, column_index<I>()>...>;
+
+        return std::ranges::subrange<iter>(
+            iter { m_storage.template data<column_index<I>()>()... },
+            iter { (m_storage.template data<column_index<I>()>() + size())... }
+        );
+    }
 
-        using view                       = type::types_view_t<all_types, I>;
-        constexpr std::size_t count_void = type::types_count<view>::template value<void>;
-        constexpr std::size_t index      = view::size - count_void;
+    /**
+     * @brief Calls a function for every row selected by a packed bool column.
+     *
+     * The mask is scanned a word at a time, so rows in runs of cleared bits are skipped without being touched.
+     *
+     * @tparam M The index of the packed bool column used as the mask.
+     * @tparam Fn The type of the function.
+     * @param fn The function called with a tuple of references to the row.
+     */
+    template <std::size_t M, typename Fn> void for_each_where(Fn fn) {
+        static_assert(std::is_same_v<type::types_get_t<all_types, M>, packed_bool>, "The mask must be a packed column");
 
-        using element = type::types_get_t<used_types, index>;
+        std::as_const(*this).template get_container<M>().for_each_set([&](std::size_t pos) { fn(at(pos)); });
+    }
 
-        const auto& container = std::get<index>(m_storage);
+    /**
+     * @brief Calls a function for every row selected by a packed bool column.
+     *
+     * @tparam M The index of the packed bool column used as the mask.
+     * @tparam Fn The type of the function.
+     * @param fn The function called with a tuple of const references to the row.
+     */
+    template <std::size_t M, typename Fn> void for_each_where(Fn fn) const {
+        static_assert(std::is_same_v<type::types_get_t<all_types, M>, packed_bool>, "The mask must be a packed column");
 
-        if constexpr (std::is_same_v<element, bool>) {
-            return std::span<bool>(container.begin(), container.end());
-        } else {
-            return std::span { container };
-        }
+        get_container<M>().for_each_set([&](std::size_t pos) { fn(at(pos)); });
     }
 
     /**
@@ -451,7 +425,7 @@ class multi_vector {
      *
      * @return The number of elements.
      */
-    [[nodiscard]] std::size_t size() const { return std::get<0>(m_storage).size(); }
+    [[nodiscard]] std::size_t size() const { return m_storage.size(); }
 
     /**
      * @brief Checks if the multi_vector is empty.
@@ -460,24 +434,31 @@ class multi_vector {
      */
     [[nodiscard]] bool empty() const { return size() == 0; }
 
+    /**
+     * @brief Returns the number of elements that can be held without reallocation.
+     *
+     * @return The capacity.
+     */
+    [[nodiscard]] std::size_t capacity() const { return m_storage.capacity(); }
+
     /**
      * @brief Clears the multi_vector.
      */
-    void clear() { clear_all(helper_seq); }
+    void clear() { m_storage.clear(); }
 
     /**
      * @brief Swaps the contents of two multi_vectors.
      *
      * @param other The other multi_vector.
      */
-    void swap(multi_vector& other) { std::swap(other.m_storage, m_storage); }
+    void swap(basic_multi_vector& other) { m_storage.swap(other.m_storage); }
 
     /**
      * @brief Resizes the multi_vector to a specified size.
      *
      * @param size The new size.
      */
-    void resize(std::size_t size) { resize_all(size, helper_seq); }
+    void resize(std::size_t size) { m_storage.resize(size); }
 
     /**
      * @brief Resizes the multi_vector to a specified size and initializes new elements with a specified value.
@@ -485,19 +466,22 @@ class multi_vector {
      * @param size The new size.
      * @param value The value for new elements.
      */
-    void resize(std::size_t size, const value_t& value) { resize_all_with(size, value, helper_seq); }
+    void resize(std::size_t size, const value_t& value) { m_storage.resize(size, value); }
 
     /**
      * @brief Reserves storage for the multi_vector.
      *
      * @param size The amount of storage to reserve.
      */
-    void reserve(std::size_t size) { reserve_impl(size, helper_seq); }
+    void reserve(std::size_t size) { m_storage.reserve(size); }
 
     /**
      * @brief Removes the last element from the multi_vector.
      */
-    void pop_back() { pop_back_impl(helper_seq); }
+    void pop_back() {
+        assert(!empty());
+        m_storage.pop_back();
+    }
 
     /**
      * @brief Adds a new element to the end of the multi_vector.
@@ -509,7 +493,8 @@ class multi_vector {
     template <typename... Args>
         requires(sizeof...(Args) == types::size)
     value_ref_t emplace_back(Args&&... args) {
-        return emplace_back_impl(helper_seq, std::forward<decltype(args)>(args)...);
+        m_storage.emplace_back(std::forward<decltype(args)>(args)...);
+        return back();
     }
 
     /**
@@ -517,19 +502,70 @@ class multi_vector {
      *
      * @param value The value to add.
      */
-    void push_back(const value_t& value) { push_back_impl(value, helper_seq); }
+    void push_back(const value_t& value) { m_storage.push_back(value); }
 
     /**
      * @brief Adds a new element to the end of the multi_vector.
      *
      * @param value The value to add.
      */
-    void push_back(value_t&& value) { push_back_impl(std::move(value), helper_seq); }
+    void push_back(value_t&& value) { m_storage.push_back(std::move(value)); }
+
+    /**
+     * @brief Appends rows given column by column.
+     *
+     * Every column grows once and contiguous ranges of trivially copyable elements are copied with a single memcpy.
+     *
+     * @tparam Columns The types of the ranges, one for every used column.
+     * @param columns The ranges of the new elements, all of the same size.
+     */
+    template <std::ranges::sized_range... Columns>
+        requires(sizeof...(Columns) == types::size)
+    void append(const Columns&... columns) {
+        insert_columns(size(), columns...);
+    }
+
+    /**
+     * @brief Inserts rows given column by column at a specified position.
+     *
+     * @tparam Columns The types of the ranges, one for every used column.
+     * @param pos The position of the first inserted row.
+     * @param columns The ranges of the new elements, all of the same size.
+     * @return An iterator to the first inserted row.
+     */
+    template <std::ranges::sized_range... Columns>
+        requires(sizeof...(Columns) == types::size)
+    iterator_t insert(const_iterator_t pos, const Columns&... columns) {
+        const auto index = static_cast<std::size_t>(pos - cbegin());
+        insert_columns(index, columns...);
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Inserts copies of a row at a specified position.
+     *
+     * @param pos The position of the first inserted row.
+     * @param count The number of inserted rows.
+     * @param value The value of the inserted rows.
+     * @return An iterator to the first inserted row.
+     */
+    iterator_t insert(const_iterator_t pos, std::size_t count, const value_t& value) {
+        const auto index = static_cast<std::size_t>(pos - cbegin());
+
+        if (count != 0) {
+            m_storage.insert_rows(index, count, [&](auto column, auto gap) {
+                fill_column(gap, count, std::get<column>(value));
+            });
+        }
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
 
     /**
      * @brief Shrinks the capacity of the multi_vector to fit its size.
      */
-    void shrink_to_fit() { shrink_to_fit_impl(helper_seq); }
+    void shrink_to_fit() { m_storage.shrink_to_fit(); }
 
     /**
      * @brief Erases an element at a specified position.
@@ -538,14 +574,90 @@ class multi_vector {
      * @return An iterator to the element following the erased element.
      */
     iterator_t erase(const_iterator_t pos) {
-        erase_impl(pos);
+        const auto index = static_cast<std::size_t>(pos - cbegin());
+        m_storage.erase(index);
 
-        const auto dist = static_cast<std::size_t>(pos - begin());
-        if (dist >= size()) {
-            return end();
-        } else {
-            return iterator_t { this, dist };
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Erases an element at a specified position by replacing it with the last element.
+     *
+     * The order of the elements is not preserved, but the erase runs in constant time.
+     *
+     * @param pos The position of the element to erase.
+     * @return An iterator to the element which took the place of the erased element.
+     */
+    iterator_t erase_unordered(const_iterator_t pos) {
+        const auto index = static_cast<std::size_t>(pos - cbegin());
+        assert(index < size());
+
+        const std::size_t last = size() - 1;
+        if (index != last) {
+            move_row(last, index, helper_seq);
+        }
+        m_storage.pop_back();
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Erases all elements satisfying a predicate.
+     *
+     * The order of the remaining elements is preserved. Every column is compacted in a single pass without allocating.
+     *
+     * @tparam Pred The type of the predicate.
+     * @param pred The predicate called with a tuple of const references to the element.
+     * @return The number of erased elements.
+     */
+    template <typename Pred>
+        requires std::predicate<Pred&, const_value_ref_t>
+    std::size_t erase_if(Pred pred) {
+        const std::size_t count = size();
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (pred(std::as_const(*this).at(i))) {
+                continue;
+            }
+
+            if (kept != i) {
+                move_row(i, kept, helper_seq);
+            }
+            kept += 1;
         }
+
+        m_storage.truncate(kept);
+        return count - kept;
+    }
+
+    /**
+     * @brief Sorts the elements by the values of a key column.
+     *
+     * The permutation is computed from the key column alone and then applied to every column with one gather per
+     * column. Arithmetic keys compared with `std::less` are sorted with an LSD radix sort.
+     *
+     * @tparam I The index of the key column.
+     * @tparam Compare The type of the comparator.
+     * @param cmp The comparator of the keys.
+     */
+    template <std::size_t I, typename Compare = std::less<>> void sort_by(Compare cmp = Compare()) {
+        constexpr std::size_t index = column_index<I>();
+
+        permute(detail::sort_permutation<false>(m_storage.template data<index>(), size(), cmp), helper_seq);
+    }
+
+    /**
+     * @brief Sorts the elements by the values of a key column and preserves the order of equal keys.
+     *
+     * @tparam I The index of the key column.
+     * @tparam Compare The type of the comparator.
+     * @param cmp The comparator of the keys.
+     */
+    template <std::size_t I, typename Compare = std::less<>> void stable_sort_by(Compare cmp = Compare()) {
+        constexpr std::size_t index = column_index<I>();
+
+        permute(detail::sort_permutation<true>(m_storage.template data<index>(), size(), cmp), helper_seq);
     }
 
     /**
@@ -553,79 +665,46 @@ class multi_vector {
      *
      * @return An iterator to the beginning of the multi_vector.
      */
-    iterator_t begin() { return iterator_t { this, 0 }; }
+    iterator_t begin() { return make_iterator<iterator_t>(*this, 0, helper_seq); }
 
     /**
      * @brief Returns a const iterator to the beginning of the multi_vector.
      *
      * @return A const iterator to the beginning of the multi_vector.
      */
-    const_iterator_t begin() const { return const_iterator_t { this, 0 }; }
+    const_iterator_t begin() const { return make_iterator<const_iterator_t>(*this, 0, helper_seq); }
 
     /**
      * @brief Returns a const iterator to the beginning of the multi_vector.
      *
      * @return A const iterator to the beginning of the multi_vector.
      */
-    const_iterator_t cbegin() const { return const_iterator_t { this, 0 }; }
+    const_iterator_t cbegin() const { return begin(); }
 
     /**
      * @brief Returns an iterator to the end of the multi_vector.
      *
      * @return An iterator to the end of the multi_vector.
      */
-    iterator_t end() { return iterator_t { this, size() }; }
+    iterator_t end() { return make_iterator<iterator_t>(*this, size(), helper_seq); }
 
     /**
      * @brief Returns a const iterator to the end of the multi_vector.
      *
      * @return A const iterator to the end of the multi_vector.
      */
-    const_iterator_t end() const { return const_iterator_t { this, size() }; }
+    const_iterator_t end() const { return make_iterator<const_iterator_t>(*this, size(), helper_seq); }
 
     /**
      * @brief Returns a const iterator to the end of the multi_vector.
      *
      * @return A const iterator to the end of the multi_vector.
      */
-    const_iterator_t cend() const { return const_iterator_t { this, size() }; }
+    const_iterator_t cend() const { return end(); }
 
 private:
     storage_t m_storage;
 
-    /**
-     * @brief Initializes the multi_vector with a specified size and value.
-     *
-     * @tparam I The index of the type to initialize.
-     * @param count The number of elements.
-     * @param value The value to initialize the elements with.
-     */
-    template <std::size_t I = 0> void init_vector(std::size_t count, const value_t& value) {
-        using vector_element = type::types_get_t<types, I>;
-
-        std::get<I>(m_storage) = single_vector<vector_element>(count, std::get<I>(value));
-
-        if constexpr (I + 1 < types::size) {
-            init_vector<I + 1>(count, value);
-        }
-    }
-
-    /**
-     * @brief Initializes the multi_vector with a specified size and default values.
-     *
-     * @tparam I The index of the type to initialize.
-     * @param count The number of elements.
-     */
-    template <std::size_t I = 0> void init_vector_default(std::size_t count) {
-        using vector_element = type::types_get_t<types, I>;
-
-        std::get<I>(m_storage) = single_vector<vector_element>(count);
-
-        if constexpr (I + 1 < types::size) {
-            init_vector_default<I + 1>(count);
-        }
-    }
-
     /**
      * @brief Returns a reference to a single element at a specified position.
      *
@@ -633,7 +712,7 @@ class multi_vector {
      * @param pos The position of the element.
      * @return Reference to the element.
      */
-    template <std::size_t I> auto& get_single(std::size_t pos) { return std::get<I>(m_storage).at(pos); }
+    template <std::size_t I> decltype(auto) get_single(std::size_t pos) { return m_storage.template data<I>()[pos]; }
 
     /**
      * @brief Returns a const reference to a single element at a specified position.
@@ -642,7 +721,9 @@ class multi_vector {
      * @param pos The position of the element.
      * @return Const reference to the element.
      */
-    template <std::size_t I> const auto& get_single(std::size_t pos) const { return std::get<I>(m_storage).at(pos); }
+    template <std::size_t I> decltype(auto) get_single(std::size_t pos) const {
+        return m_storage.template data<I>()[pos];
+    }
 
     /**
      * @brief Returns a tuple of references to all elements at a specified position.
@@ -667,211 +748,172 @@ class multi_vector {
     }
 
     /**
-     * @brief Clears all containers in the multi_vector.
+     * @brief Creates an iterator pointing to a specified position.
      *
-     * @tparam I The indices of the types to clear.
+     * @tparam Iter The type of the iterator.
+     * @tparam Self The type of the multi_vector.
+     * @tparam I The indices of the columns.
+     * @param self The multi_vector.
+     * @param pos The position.
+     * @return The iterator.
      */
-    template <std::size_t... I> void clear_all(std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).clear(), ...);
+    template <typename Iter, typename Self, std::size_t... I>
+    static Iter make_iterator(Self& self, std::size_t pos, std::index_sequence<I...> /*unused*/) {
+        return Iter { (self.m_storage.template data<I>() + pos)... };
     }
 
     /**
-     * @brief Resizes all containers in the multi_vector.
+     * @brief Move assigns all elements at one position to another position.
      *
-     * @tparam I The indices of the types to resize.
-     * @param size The new size.
+     * @tparam I The indices of the types to move.
+     * @param from The position of the source elements.
+     * @param to The position of the destination elements.
      */
-    template <std::size_t... I> void resize_all(std::size_t size, std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).resize(size), ...);
+    template <std::size_t... I> void move_row(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+        ((get_single<I>(to) = std::move(get_single<I>(from))), ...);
     }
 
     /**
-     * @brief Resizes all containers in the multi_vector and initializes new elements with a specified value.
+     * @brief Inserts rows given column by column.
      *
-     * @tparam I The indices of the types to resize.
-     * @param size The new size.
-     * @param value The value for new elements.
+     * @tparam Columns The types of the ranges.
+     * @param pos The position of the first inserted row.
+     * @param columns The ranges of the new elements.
      */
-    template <std::size_t... I>
-    void resize_all_with(std::size_t size, const value_t& value, std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).resize(size, std::get<I>(value)), ...);
-    }
+    template <typename... Columns> void insert_columns(std::size_t pos, const Columns&... columns) {
+        const auto sources = std::forward_as_tuple(columns...);
 
-    /**
-     * @brief Removes the last element from all containers in the multi_vector.
-     *
-     * @tparam I The indices of the types to pop back.
-     */
-    template <std::size_t... I> void pop_back_impl(std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).pop_back(), ...);
-    }
+        const auto count = static_cast<std::size_t>(std::ranges::size(std::get<0>(sources)));
+        assert(((static_cast<std::size_t>(std::ranges::size(columns)) == count) && ...));
 
-    /**
-     * @brief Adds a new element to the end of all containers in the multi_vector.
-     *
-     * @tparam Value The type of the value to add.
-     * @tparam I The indices of the types to push back.
-     * @param value The value to add.
-     */
-    template <typename Value, std::size_t... I>
-    void push_back_impl(Value&& value, std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).push_back(std::get<I>(std::forward<decltype(value)>(value))), ...);
-    }
+        if (count == 0) {
+            return;
+        }
 
-    /**
-     * @brief Adds a new element to the end of all containers in the multi_vector.
-     *
-     * @tparam Args The types of the arguments.
-     * @tparam I The indices of the types to emplace back.
-     * @param args The arguments to construct the new elements.
-     * @return A tuple of references to the newly added elements.
-     */
-    template <typename... Args, std::size_t... I>
-    value_ref_t emplace_back_impl(std::index_sequence<I...> /*unused*/, Args&&... args) {
-        return std::forward_as_tuple(std::get<I>(m_storage).emplace_back(std::forward<decltype(args)>(args))...);
+        m_storage.insert_rows(pos, count, [&](auto column, auto gap) {
+            copy_column(gap, count, std::get<column>(sources));
+        });
     }
 
     /**
-     * @brief Shrinks the capacity of all containers in the multi_vector to fit their size.
+     * @brief Copies elements of a range into the uninitialized gap of a column.
      *
-     * @tparam I The indices of the types to shrink to fit.
+     * @tparam Ptr The pointer type of the column.
+     * @tparam Range The type of the range.
+     * @param gap Pointer to the gap.
+     * @param count The number of elements.
+     * @param range The range.
      */
-    template <std::size_t... I> void shrink_to_fit_impl(std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).shrink_to_fit(), ...);
+    template <typename Ptr, typename Range> static void copy_column(Ptr gap, std::size_t count, const Range& range) {
+        if constexpr (std::is_pointer_v<Ptr>) {
+            using element_t = std::remove_pointer_t<Ptr>;
+
+            if constexpr (
+                std::ranges::contiguous_range<Range> && std::is_trivially_copyable_v<element_t>
+                && std::is_same_v<std::ranges::range_value_t<Range>, element_t>
+            ) {
+                std::memcpy(static_cast<void*>(gap), std::ranges::data(range), count * sizeof(element_t));
+            } else {
+                std::uninitialized_copy_n(std::ranges::begin(range), count, gap);
+            }
+        } else {
+            std::copy_n(std::ranges::begin(range), count, gap);
+        }
     }
 
     /**
-     * @brief Reserves storage for all containers in the multi_vector.
+     * @brief Fills the uninitialized gap of a column with copies of a value.
      *
-     * @tparam I The indices of the types to reserve.
-     * @param size The amount of storage to reserve.
+     * @tparam Ptr The pointer type of the column.
+     * @tparam Value The type of the value.
+     * @param gap Pointer to the gap.
+     * @param count The number of elements.
+     * @param value The value.
      */
-    template <std::size_t... I> void reserve_impl(std::size_t size, std::index_sequence<I...> /*unused*/) {
-        (std::get<I>(m_storage).reserve(size), ...);
+    template <typename Ptr, typename Value> static void fill_column(Ptr gap, std::size_t count, const Value& value) {
+        if constexpr (std::is_pointer_v<Ptr>) {
+            std::uninitialized_fill_n(gap, count, value);
+        } else {
+            std::fill_n(gap, count, value);
+        }
     }
 
     /**
-     * @brief Erases an element at a specified position from all containers in the multi_vector.
+     * @brief Reorders every column by a permutation.
      *
-     * @tparam I The index of the type to erase.
-     * @param pos The position of the element to erase.
+     * @tparam I The indices of the columns.
+     * @param permutation The permutation, where `permutation[i]` is the former position of the element at `i`.
      */
-    template <std::size_t I = 0> void erase_impl(const_iterator_t pos) {
-        auto& vec = std::get<I>(m_storage);
-        vec.erase(vec.begin() + pos.m_index);
+    template <std::size_t... I>
+    void permute(const std::vector<std::size_t>& permutation, std::index_sequence<I...> /*unused*/) {
+        const allocator_type alloc = get_allocator();
 
-        if constexpr (I + 1 < types::size) {
-            erase_impl<I + 1>(pos);
-        }
+        (detail::apply_permutation(m_storage.template data<I>(), permutation, alloc), ...);
     }
 };
 
 /**
- * @brief Nested iterator class for multi_vector.
+ * @brief Class representing a multi_vector.
+ *
+ * Every column is stored in its own allocation.
  *
- * @tparam T The types of elements stored in the multi_vector.
- * @tparam is_const Whether the iterator is const.
+ * @tparam Types The types of elements stored in the multi_vector.
  */
-template <is_multi_vector_element... T>
-    requires(type::types_remove_t<type::types<T...>, void>::size != 0)
-template <bool is_const>
-class multi_vector<T...>::iterator {
-private:
-    using vec_ptr_t = std::conditional_t<is_const, const multi_vector*, multi_vector*>;
-
-public:
-    using value_type        = std::conditional_t<is_const, const_value_ref_t, value_ref_t>;
-    using const_value_type  = const_value_ref_t;
-    using reference         = value_type;
-    using difference_type   = std::ptrdiff_t;
-    using iterator_category = std::random_access_iterator_tag;
-
-    iterator()                           = default;
-    iterator(const iterator&)            = default;
-    iterator(iterator&&)                 = default;
-    iterator& operator=(const iterator&) = default;
-    iterator& operator=(iterator&&)      = default;
-
-    const_value_type operator*() const { return m_ref->at(m_index); }
-
-    value_type operator*()
-        requires(!is_const)
-    {
-        return m_ref->at(m_index);
-    }
-
-    iterator& operator++() {
-        m_index++;
-        return *this;
-    }
-
-    operator iterator<true>() const
-        requires(!is_const)
-    {
-        return iterator<true>(m_ref, m_index);
-    }
-
-    iterator operator++(int) { return { m_ref, m_index++ }; }
+template <is_multi_vector_element... Types> using multi_vector = basic_multi_vector<column_layout, Types...>;
 
-    iterator& operator--() {
-        --m_index;
-        return *this;
-    }
-
-    iterator& operator--(int) { return { m_ref, m_index-- }; }
-
-    difference_type operator-(const iterator& other) const {
-        if (m_index < other.m_index) {
-            return -static_cast<difference_type>(other.m_index - m_index);
-        } else {
-            return static_cast<difference_type>(m_index - other.m_index);
-        }
-    }
-
-    iterator& operator+=(difference_type n) {
-        m_index += n;
-        return *this;
-    }
-
-    iterator& operator-=(difference_type n) {
-        m_index -= n;
-        return *this;
-    }
-
-    iterator operator+(difference_type n) const { return { m_ref, m_index + n }; }
-
-    iterator operator-(difference_type n) const { return { m_ref, m_index - n }; }
-
-    const_value_type operator[](difference_type n) const { return m_ref->at(m_index + n); }
-
-    value_type operator[](difference_type n)
-        requires(!is_const)
-    {
-        return m_ref->at(m_index + n);
-    }
-
-    bool operator==(const iterator& other) const = default;
-    bool operator!=(const iterator& other) const = default;
+/**
+ * @brief Class representing a multi_vector stored in a single allocation.
+ *
+ * All columns share one allocation and every column is aligned to a cache line, so growing, reserving and copying costs
+ * a single allocation.
+ *
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <is_multi_vector_element... Types> using block_multi_vector = basic_multi_vector<block_layout, Types...>;
 
-    bool operator<(const iterator& other) const { return m_index < other.m_index; }
+/**
+ * @brief Class representing a multi_vector keeping up to `N` rows inline.
+ *
+ * No allocation happens until the multi_vector grows past `N` rows.
+ *
+ * @tparam N The number of inline rows.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t N, is_multi_vector_element... Types>
+using small_multi_vector = basic_multi_vector<small_layout<N>, Types...>;
 
-    bool operator<=(const iterator& other) const { return m_index <= other.m_index; }
+namespace pmr {
 
-    bool operator>(const iterator& other) const { return m_index > other.m_index; }
+    /**
+     * @brief multi_vector using a polymorphic allocator.
+     *
+     * @tparam Types The types of elements stored in the multi_vector.
+     */
+    template <is_multi_vector_element... Types>
+    using multi_vector
+        = basic_multi_vector<basic_column_layout<std::pmr::polymorphic_allocator<std::byte>>, Types...>;
 
-    bool operator>=(const iterator& other) const { return m_index >= other.m_index; }
+    /**
+     * @brief block_multi_vector using a polymorphic allocator.
+     *
+     * @tparam Types The types of elements stored in the multi_vector.
+     */
+    template <is_multi_vector_element... Types>
+    using block_multi_vector
+        = basic_multi_vector<basic_block_layout<std::pmr::polymorphic_allocator<std::byte>>, Types...>;
 
-private:
-    vec_ptr_t m_ref     = nullptr;
-    std::size_t m_index = 0;
+    /**
+     * @brief small_multi_vector using a polymorphic allocator.
+     *
+     * @tparam N The number of inline rows.
+     * @tparam Types The types of elements stored in the multi_vector.
+     */
+    template <std::size_t N, is_multi_vector_element... Types>
+    using small_multi_vector
+        = basic_multi_vector<basic_small_layout<N, std::pmr::polymorphic_allocator<std::byte>>, Types...>;
 
-    iterator(vec_ptr_t vec, std::size_t index)
-        : m_ref(vec)
-        , m_index(index) { }
+}
 
-    friend class iterator<true>;
-    friend class multi_vector;
-};
 }
 
 #endif
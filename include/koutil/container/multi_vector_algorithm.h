@@ -0,0 +1,391 @@
+#ifndef KOUTIL_CONTAINER_MULTI_VECTOR_ALGORITHM_H
+#define KOUTIL_CONTAINER_MULTI_VECTOR_ALGORITHM_H
+
+#include "koutil/container/bit_column.h"
+#include "koutil/util/thread_pool.h"
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+namespace detail {
+
+    /**
+     * @brief Minimal number of rows processed by one task.
+     */
+    inline constexpr std::size_t parallel_grain = 4096;
+
+    /**
+     * @brief Returns the maximal number of chunks the rows are split into.
+     *
+     * Each thread gets a few chunks to balance uneven work.
+     *
+     * @param pool The thread pool.
+     * @return The maximal number of chunks.
+     */
+    inline std::size_t max_chunk_count(const util::thread_pool& pool) {
+        constexpr std::size_t chunks_per_thread = 4;
+        return (pool.size() + 1) * chunks_per_thread;
+    }
+
+    template <typename T> inline constexpr bool is_bit_reference_v = false;
+
+    template <typename Word> inline constexpr bool is_bit_reference_v<bit_reference<Word>> = true;
+
+    /**
+     * @brief Checks if a row reference contains an element of a packed column.
+     *
+     * @tparam Row The row reference type.
+     */
+    template <typename Row> inline constexpr bool has_packed_column_v = false;
+
+    template <typename... T>
+    inline constexpr bool has_packed_column_v<std::tuple<T...>> = (is_bit_reference_v<T> || ...);
+
+    /**
+     * @brief Returns the number of rows a chunk boundary must be a multiple of.
+     *
+     * Rows of a packed column share words, so chunks writing to it must not split a word between threads.
+     *
+     * @tparam Packed True if the written rows contain a packed column.
+     * @return The number of rows.
+     */
+    template <bool Packed> consteval std::size_t chunk_granularity() { return Packed ? bit_word_bits : 1; }
+
+    /**
+     * @brief Element type of a column returned by `get_container`, `bool` for a packed column.
+     *
+     * @tparam Column The type of the column.
+     */
+    template <typename Column> using column_element_t = std::iter_value_t<decltype(std::declval<Column&>().begin())>;
+
+    /**
+     * @brief Splits rows into chunks and processes them on a thread pool.
+     *
+     * Small ranges are processed as a single chunk.
+     *
+     * @tparam Granularity The number of rows every chunk boundary is a multiple of.
+     * @tparam Fn The type of the function.
+     * @param pool The thread pool.
+     * @param count The number of rows.
+     * @param fn The function called with the chunk index and the row range of the chunk.
+     * @return The number of chunks.
+     */
+    template <std::size_t Granularity = 1, typename Fn>
+    std::size_t for_each_chunk(util::thread_pool& pool, std::size_t count, Fn&& fn) {
+        const std::size_t chunks = std::max<std::size_t>(
+            1, std::min(max_chunk_count(pool), (count + parallel_grain - 1) / parallel_grain)
+        );
+        const std::size_t chunk_size = ((count + chunks - 1) / chunks + Granularity - 1) / Granularity * Granularity;
+
+        pool.run(chunks, [&](std::size_t chunk) {
+            const std::size_t begin = std::min(count, chunk * chunk_size);
+            const std::size_t end   = std::min(count, begin + chunk_size);
+            fn(chunk, begin, end);
+        });
+
+        return chunks;
+    }
+
+    template <typename T> struct sum_result {
+        using type = T;
+    };
+
+    template <std::floating_point T> struct sum_result<T> {
+        using type = double;
+    };
+
+    template <std::signed_integral T> struct sum_result<T> {
+        using type = std::int64_t;
+    };
+
+    template <std::unsigned_integral T> struct sum_result<T> {
+        using type = std::uint64_t;
+    };
+
+}
+
+/**
+ * @brief Type of the sum of elements, integers are widened to 64 bits and floating-point numbers to double.
+ *
+ * @tparam T The type of the elements.
+ */
+template <typename T> using sum_result_t = typename detail::sum_result<T>::type;
+
+/**
+ * @brief Calls a function for every row in parallel.
+ *
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Fn The type of the function.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @param fn The function called with a tuple of references to the row.
+ */
+template <typename Vec, typename Fn> void for_each_row(util::thread_pool& pool, Vec& vec, Fn fn) {
+    auto first = vec.begin();
+
+    constexpr std::size_t granularity
+        = detail::chunk_granularity<detail::has_packed_column_v<std::iter_reference_t<decltype(first)>>>();
+
+    detail::for_each_chunk<granularity>(
+        pool,
+        vec.size(),
+        [&](std::size_t /*unused*/, std::size_t begin, std::size_t end) {
+            const auto offset = static_cast<std::ptrdiff_t>(begin);
+            std::for_each(first + offset, first + static_cast<std::ptrdiff_t>(end), fn);
+        }
+    );
+}
+
+/**
+ * @brief Calls a function for every row in parallel using the default thread pool.
+ *
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Fn The type of the function.
+ * @param vec The multi_vector.
+ * @param fn The function called with a tuple of references to the row.
+ */
+template <typename Vec, typename Fn> void for_each_row(Vec& vec, Fn fn) {
+    for_each_row(util::default_thread_pool(), vec, std::move(fn));
+}
+
+/**
+ * @brief Replaces every element of a column with the result of a function in parallel.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Fn The type of the function.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @param fn The function called with a const reference to the element.
+ */
+template <std::size_t I, typename Vec, typename Fn> void transform_column(util::thread_pool& pool, Vec& vec, Fn fn) {
+    auto column     = vec.template get_container<I>();
+    using element_t = detail::column_element_t<decltype(column)>;
+
+    constexpr std::size_t granularity = detail::chunk_granularity<detail::is_bit_reference_v<decltype(column[0])>>();
+
+    detail::for_each_chunk<granularity>(
+        pool,
+        column.size(),
+        [&](std::size_t /*unused*/, std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const element_t& value = column[i];
+                column[i]              = fn(value);
+            }
+        }
+    );
+}
+
+/**
+ * @brief Replaces every element of a column with the result of a function in parallel using the default thread pool.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Fn The type of the function.
+ * @param vec The multi_vector.
+ * @param fn The function called with a const reference to the element.
+ */
+template <std::size_t I, typename Vec, typename Fn> void transform_column(Vec& vec, Fn fn) {
+    transform_column<I>(util::default_thread_pool(), vec, std::move(fn));
+}
+
+/**
+ * @brief Reduces the elements of a column in parallel.
+ *
+ * The chunk results are combined in order, so the operation must be associative but does not have to be commutative.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Op The type of the operation.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @param op The binary operation.
+ * @return The result, or an empty optional if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec, typename Op> auto reduce_column(util::thread_pool& pool, const Vec& vec, Op op) {
+    auto column     = vec.template get_container<I>();
+    using element_t = detail::column_element_t<decltype(column)>;
+
+    std::vector<std::optional<element_t>> partials(detail::max_chunk_count(pool));
+
+    const std::size_t chunks
+        = detail::for_each_chunk(pool, column.size(), [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              if (begin == end) {
+                  return;
+              }
+
+              element_t acc = column[begin];
+              for (std::size_t i = begin + 1; i < end; ++i) {
+                  acc = op(std::move(acc), static_cast<const element_t&>(column[i]));
+              }
+              partials[chunk] = std::move(acc);
+          });
+
+    std::optional<element_t> result;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        if (!partials[chunk].has_value()) {
+            continue;
+        }
+
+        result = result.has_value() ? op(std::move(*result), *partials[chunk]) : std::move(*partials[chunk]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Sums the elements of a column in parallel.
+ *
+ * The elements are added in `sum_result_t` of the element type, so small integers do not overflow.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @return The sum, or a value-initialized result if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto sum(util::thread_pool& pool, const Vec& vec) {
+    auto column     = vec.template get_container<I>();
+    using element_t = detail::column_element_t<decltype(column)>;
+    using result_t  = sum_result_t<element_t>;
+
+    std::vector<result_t> partials(detail::max_chunk_count(pool));
+
+    const std::size_t chunks
+        = detail::for_each_chunk(pool, column.size(), [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              result_t acc {};
+              for (std::size_t i = begin; i < end; ++i) {
+                  acc = std::move(acc) + static_cast<result_t>(static_cast<const element_t&>(column[i]));
+              }
+              partials[chunk] = std::move(acc);
+          });
+
+    result_t result {};
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        result = std::move(result) + partials[chunk];
+    }
+
+    return result;
+}
+
+/**
+ * @brief Sums the elements of a column in parallel using the default thread pool.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The sum, or a value-initialized result if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto sum(const Vec& vec) { return sum<I>(util::default_thread_pool(), vec); }
+
+/**
+ * @brief Finds the smallest element of a column in parallel.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @return The smallest element, or an empty optional if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto minimum(util::thread_pool& pool, const Vec& vec) {
+    return reduce_column<I>(pool, vec, [](const auto& lhs, const auto& rhs) { return rhs < lhs ? rhs : lhs; });
+}
+
+/**
+ * @brief Finds the smallest element of a column in parallel using the default thread pool.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The smallest element, or an empty optional if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto minimum(const Vec& vec) {
+    return minimum<I>(util::default_thread_pool(), vec);
+}
+
+/**
+ * @brief Finds the largest element of a column in parallel.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @return The largest element, or an empty optional if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto maximum(util::thread_pool& pool, const Vec& vec) {
+    return reduce_column<I>(pool, vec, [](const auto& lhs, const auto& rhs) { return lhs < rhs ? rhs : lhs; });
+}
+
+/**
+ * @brief Finds the largest element of a column in parallel using the default thread pool.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The largest element, or an empty optional if the multi_vector is empty.
+ */
+template <std::size_t I, typename Vec> auto maximum(const Vec& vec) {
+    return maximum<I>(util::default_thread_pool(), vec);
+}
+
+/**
+ * @brief Counts the elements of a column satisfying a predicate in parallel.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Pred The type of the predicate.
+ * @param pool The thread pool.
+ * @param vec The multi_vector.
+ * @param pred The predicate called with a const reference to the element.
+ * @return The number of elements satisfying the predicate.
+ */
+template <std::size_t I, typename Vec, typename Pred>
+std::size_t count_if(util::thread_pool& pool, const Vec& vec, Pred pred) {
+    auto column = vec.template get_container<I>();
+
+    std::vector<std::size_t> partials(detail::max_chunk_count(pool));
+
+    const std::size_t chunks
+        = detail::for_each_chunk(pool, column.size(), [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+              partials[chunk] = static_cast<std::size_t>(std::count_if(
+                  column.begin() + static_cast<std::ptrdiff_t>(begin),
+                  column.begin() + static_cast<std::ptrdiff_t>(end),
+                  pred
+              ));
+          });
+
+    std::size_t total = 0;
+    for (std::size_t chunk = 0; chunk < chunks; ++chunk) {
+        total += partials[chunk];
+    }
+
+    return total;
+}
+
+/**
+ * @brief Counts the elements of a column satisfying a predicate in parallel using the default thread pool.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Pred The type of the predicate.
+ * @param vec The multi_vector.
+ * @param pred The predicate called with a const reference to the element.
+ * @return The number of elements satisfying the predicate.
+ */
+template <std::size_t I, typename Vec, typename Pred> std::size_t count_if(const Vec& vec, Pred pred) {
+    return count_if<I>(util::default_thread_pool(), vec, std::move(pred));
+}
+
+}
+
+#endif
@@ -0,0 +1,341 @@
+#ifndef KOUTIL_CONTAINER_MULTI_VECTOR_JOIN_H
+#define KOUTIL_CONTAINER_MULTI_VECTOR_JOIN_H
+
+#include "koutil/container/hash_array.h"
+#include "koutil/container/multi_vector.h"
+#include "koutil/container/multi_vector_algorithm.h"
+#include "koutil/container/multi_vector_query.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Type of the elements of a column of a multi_vector.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ */
+template <std::size_t I, typename Vec>
+using column_value_t = std::remove_cvref_t<decltype(std::declval<const Vec&>().template get_container<I>()[0])>;
+
+/**
+ * @brief Pairs of rows with equal keys produced by `hash_join`.
+ *
+ * `left[i]` and `right[i]` are the indices of the i-th matching pair, they can be materialized with `gather`.
+ */
+struct join_result {
+    selection_vector left;
+    selection_vector right;
+};
+
+namespace detail {
+
+    /**
+     * @brief Key adapter comparing a key with the key of a row of a column.
+     *
+     * @tparam T The type of the key.
+     */
+    template <typename T> struct row_key_adapter {
+        std::span<const T> keys;
+
+        [[nodiscard]] bool eql(const T& key, std::uint32_t row) const { return std::equal_to<T>()(key, keys[row]); }
+    };
+
+    /**
+     * @brief Key adapter comparing a key with the key of the first row of a group.
+     *
+     * @tparam T The type of the key.
+     */
+    template <typename T> struct group_key_adapter {
+        std::span<const T> keys;
+        const std::uint32_t* first_rows;
+
+        [[nodiscard]] bool eql(const T& key, std::uint32_t group) const {
+            return std::equal_to<T>()(key, keys[first_rows[group]]);
+        }
+    };
+
+    /**
+     * @brief Rows of a multi_vector assigned to groups of equal keys.
+     */
+    struct group_index {
+        /**
+         * @brief The group of every row.
+         */
+        std::vector<std::uint32_t> group_of;
+
+        /**
+         * @brief The first row of every group, groups are numbered in the order of their first rows.
+         */
+        std::vector<std::uint32_t> first_rows;
+    };
+
+    /**
+     * @brief Assigns the rows of a key column to groups of equal keys.
+     *
+     * The keys are looked up in batches of `lookup_batch_size` with `find_batch`, the rows of unknown keys then create
+     * their groups one by one, since an earlier row of the same batch may have created the group already.
+     *
+     * @tparam T The type of the key.
+     * @param keys The key column.
+     * @return The groups.
+     */
+    template <typename T> group_index group_rows(std::span<const T> keys) {
+        using adapter_t = group_key_adapter<T>;
+        using table_t   = hash_array<T, std::uint32_t, adapter_t>;
+
+        assert(keys.size() < std::numeric_limits<std::uint32_t>::max());
+
+        constexpr std::uint32_t no_group = std::numeric_limits<std::uint32_t>::max();
+
+        group_index index;
+        index.group_of.resize(keys.size());
+
+        // the adapter keeps a pointer to the first rows, they must not be reallocated
+        index.first_rows.reserve(keys.size());
+        const adapter_t adapter { keys, index.first_rows.data() };
+
+        table_t groups(keys.size() / 8 + 1);
+        std::array<typename table_t::iterator_t, lookup_batch_size> found;
+
+        for (std::size_t first = 0; first < keys.size(); first += lookup_batch_size) {
+            const std::size_t count = std::min(lookup_batch_size, keys.size() - first);
+            groups.find_batch(keys.subspan(first, count), found, adapter);
+
+            // the iterators are read before any insert can invalidate them
+            for (std::size_t i = 0; i < count; ++i) {
+                index.group_of[first + i] = found[i] != groups.end() ? *found[i] : no_group;
+            }
+
+            for (std::size_t row = first; row < first + count; ++row) {
+                if (index.group_of[row] != no_group) {
+                    continue;
+                }
+
+                const auto group = static_cast<std::uint32_t>(index.first_rows.size());
+                index.first_rows.push_back(static_cast<std::uint32_t>(row));
+
+                if (groups.try_insert(keys[row], group, adapter)) {
+                    index.group_of[row] = group;
+                } else {
+                    index.first_rows.pop_back();
+                    index.group_of[row] = *groups.find(keys[row], adapter);
+                }
+            }
+        }
+
+        return index;
+    }
+
+}
+
+/**
+ * @brief Finds the pairs of rows of two multi_vectors with equal keys.
+ *
+ * A hash_array indexing the rows of the smaller side is built and probed with the keys of the other side in batches
+ * of `detail::lookup_batch_size`. Keys occurring several times on the build side are chained, so every matching pair
+ * is reported. The pairs are ordered by the probe side, and within a probe row by the build rows.
+ *
+ * @tparam LeftKey The index of the key column of the left multi_vector.
+ * @tparam RightKey The index of the key column of the right multi_vector.
+ * @tparam Left The type of the left multi_vector.
+ * @tparam Right The type of the right multi_vector.
+ * @param left The left multi_vector.
+ * @param right The right multi_vector.
+ * @return The matching pairs.
+ */
+template <std::size_t LeftKey, std::size_t RightKey = LeftKey, typename Left, typename Right>
+join_result hash_join(const Left& left, const Right& right) {
+    using key_t = column_value_t<LeftKey, Left>;
+    static_assert(std::is_same_v<key_t, column_value_t<RightKey, Right>>, "The key columns must have the same type");
+
+    using adapter_t = detail::row_key_adapter<key_t>;
+
+    const std::span<const key_t> left_keys  = left.template get_container<LeftKey>();
+    const std::span<const key_t> right_keys = right.template get_container<RightKey>();
+
+    const bool build_left  = left_keys.size() < right_keys.size();
+    const auto& build_keys = build_left ? left_keys : right_keys;
+    const auto& probe_keys = build_left ? right_keys : left_keys;
+    const adapter_t adapter { build_keys };
+
+    assert(build_keys.size() < std::numeric_limits<std::uint32_t>::max());
+    assert(probe_keys.size() <= std::numeric_limits<std::uint32_t>::max());
+
+    constexpr std::uint32_t chain_end = std::numeric_limits<std::uint32_t>::max();
+
+    // the table holds the last row of every key, `next` links it to the previous rows with the same key
+    hash_array<key_t, std::uint32_t, adapter_t> table(build_keys.size() + 1);
+    std::vector<std::uint32_t> next(build_keys.size(), chain_end);
+
+    for (std::size_t row = 0; row < build_keys.size(); ++row) {
+        const auto id = static_cast<std::uint32_t>(row);
+        if (!table.try_insert(build_keys[row], id, adapter)) {
+            auto it   = table.find(build_keys[row], adapter);
+            next[row] = *it;
+            *it       = id;
+        }
+    }
+
+    join_result result;
+    selection_vector& build_rows = build_left ? result.left : result.right;
+    selection_vector& probe_rows = build_left ? result.right : result.left;
+
+    const auto& probe_table = table;
+    std::array<typename decltype(table)::const_iterator_t, detail::lookup_batch_size> found;
+
+    std::vector<std::uint32_t> chain;
+    for (std::size_t first = 0; first < probe_keys.size(); first += detail::lookup_batch_size) {
+        const std::size_t count = std::min(detail::lookup_batch_size, probe_keys.size() - first);
+        probe_table.find_batch(probe_keys.subspan(first, count), found, adapter);
+
+        for (std::size_t i = 0; i < count; ++i) {
+            auto it = found[i];
+            if (it == probe_table.end()) {
+                continue;
+            }
+
+            // the chain runs from the last build row to the first
+            chain.clear();
+            for (std::uint32_t match = *it; match != chain_end; match = next[match]) {
+                chain.push_back(match);
+            }
+
+            build_rows.insert(build_rows.end(), chain.rbegin(), chain.rend());
+            probe_rows.insert(probe_rows.end(), chain.size(), static_cast<std::uint32_t>(first + i));
+        }
+    }
+
+    return result;
+}
+
+namespace aggregate {
+
+    /**
+     * @brief Aggregation counting the rows of a group.
+     */
+    struct count {
+        template <typename Vec> using result_t = std::size_t;
+
+        template <typename Vec, typename Out>
+        static void apply(const Vec& /*unused*/, const detail::group_index& index, Out out) {
+            for (const std::uint32_t group : index.group_of) {
+                out[group] += 1;
+            }
+        }
+    };
+
+    /**
+     * @brief Aggregation summing a column over a group.
+     *
+     * The sum has the type `sum_result_t` of the column, so small integers do not overflow.
+     *
+     * @tparam I The index of the column.
+     */
+    template <std::size_t I> struct sum {
+        template <typename Vec> using result_t = sum_result_t<column_value_t<I, Vec>>;
+
+        template <typename Vec, typename Out>
+        static void apply(const Vec& vec, const detail::group_index& index, Out out) {
+            const auto column = vec.template get_container<I>();
+            for (std::size_t row = 0; row < column.size(); ++row) {
+                out[index.group_of[row]] += static_cast<result_t<Vec>>(column[row]);
+            }
+        }
+    };
+
+    /**
+     * @brief Aggregation finding the smallest element of a column in a group.
+     *
+     * @tparam I The index of the column.
+     */
+    template <std::size_t I> struct min {
+        template <typename Vec> using result_t = column_value_t<I, Vec>;
+
+        template <typename Vec, typename Out>
+        static void apply(const Vec& vec, const detail::group_index& index, Out out) {
+            const auto column = vec.template get_container<I>();
+            for (std::size_t group = 0; group < index.first_rows.size(); ++group) {
+                out[group] = column[index.first_rows[group]];
+            }
+            for (std::size_t row = 0; row < column.size(); ++row) {
+                auto& acc = out[index.group_of[row]];
+                if (column[row] < acc) {
+                    acc = column[row];
+                }
+            }
+        }
+    };
+
+    /**
+     * @brief Aggregation finding the largest element of a column in a group.
+     *
+     * @tparam I The index of the column.
+     */
+    template <std::size_t I> struct max {
+        template <typename Vec> using result_t = column_value_t<I, Vec>;
+
+        template <typename Vec, typename Out>
+        static void apply(const Vec& vec, const detail::group_index& index, Out out) {
+            const auto column = vec.template get_container<I>();
+            for (std::size_t group = 0; group < index.first_rows.size(); ++group) {
+                out[group] = column[index.first_rows[group]];
+            }
+            for (std::size_t row = 0; row < column.size(); ++row) {
+                auto& acc = out[index.group_of[row]];
+                if (acc < column[row]) {
+                    acc = column[row];
+                }
+            }
+        }
+    };
+
+}
+
+/**
+ * @brief Groups the rows of a multi_vector by a key column and aggregates every group.
+ *
+ * The rows are assigned to groups with a hash_array in one pass over the key column, then every aggregation makes
+ * one pass over its own column.
+ *
+ * @tparam Key The index of the key column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Aggs The types of the aggregations, from the `aggregate` namespace.
+ * @param vec The multi_vector.
+ * @param aggs The aggregations.
+ * @return The multi_vector with the key and the aggregated values of every group, in the order of first occurrence.
+ */
+template <std::size_t Key, typename Vec, typename... Aggs> auto group_by(const Vec& vec, Aggs... aggs) {
+    using key_t    = column_value_t<Key, Vec>;
+    using result_t = multi_vector<key_t, typename Aggs::template result_t<Vec>...>;
+
+    const std::span<const key_t> keys = vec.template get_container<Key>();
+    const detail::group_index index   = detail::group_rows(keys);
+
+    result_t result(index.first_rows.size());
+
+    auto out_keys = result.template get_container<0>();
+    for (std::size_t group = 0; group < index.first_rows.size(); ++group) {
+        out_keys[group] = keys[index.first_rows[group]];
+    }
+
+    [&]<std::size_t... I>(std::index_sequence<I...> /*unused*/) {
+        (aggs.apply(vec, index, result.template get_container<I + 1>()), ...);
+    }(std::index_sequence_for<Aggs...>());
+
+    return result;
+}
+
+}
+
+#endif
@@ -0,0 +1,498 @@
+#ifndef KOUTIL_CONTAINER_MULTI_VECTOR_QUERY_H
+#define KOUTIL_CONTAINER_MULTI_VECTOR_QUERY_H
+
+#include "koutil/container/bit_column.h"
+#include "koutil/container/multi_vector.h"
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <ranges>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace koutil::container {
+
+/**
+ * @brief Ascending indices of the rows selected by a query.
+ */
+using selection_vector = std::vector<std::uint32_t>;
+
+/**
+ * @brief Enumerates the comparisons of a column element with a value.
+ */
+enum class CompareOp {
+    EQUAL, /**< `element == value` */
+    NOT_EQUAL, /**< `element != value` */
+    LESS, /**< `element < value` */
+    LESS_EQUAL, /**< `element <= value` */
+    GREATER, /**< `element > value` */
+    GREATER_EQUAL, /**< `element >= value` */
+};
+
+/**
+ * @brief Predicate comparing a column element with a value.
+ *
+ * Unlike an arbitrary predicate, the comparison is known to `select_where`, which evaluates it several elements at a
+ * time for integers, `float` and `double`. SSE2 cannot order 64-bit integers, they are vectorized only for `EQUAL` and
+ * `NOT_EQUAL`.
+ *
+ * @tparam T The type of the column elements.
+ */
+template <typename T> struct column_compare {
+    CompareOp op;
+    T value;
+
+    bool operator()(const T& element) const {
+        switch (op) {
+        case CompareOp::EQUAL:
+            return std::equal_to<T>()(element, value);
+        case CompareOp::NOT_EQUAL:
+            return std::not_equal_to<T>()(element, value);
+        case CompareOp::LESS:
+            return element < value;
+        case CompareOp::LESS_EQUAL:
+            return element <= value;
+        case CompareOp::GREATER:
+            return element > value;
+        case CompareOp::GREATER_EQUAL:
+            return element >= value;
+        }
+        return false;
+    }
+};
+
+namespace detail {
+
+    /**
+     * @brief Number of row indices collected before they are appended to the selection vector.
+     */
+    inline constexpr std::size_t selection_block = 1024;
+
+    /**
+     * @brief Collects row indices in a fixed buffer and appends them to a selection vector in blocks.
+     *
+     * Writing the index of every row and advancing only for selected ones keeps the loop free of branches.
+     */
+    class selection_writer {
+    public:
+        explicit selection_writer(selection_vector& out)
+            : m_out(out) { }
+
+        selection_writer(const selection_writer&)            = delete;
+        selection_writer& operator=(const selection_writer&) = delete;
+
+        ~selection_writer() { flush(); }
+
+        /**
+         * @brief Writes an index which is kept only if it is selected.
+         *
+         * @param index The index of the row.
+         * @param selected Whether the row is selected.
+         */
+        void write(std::uint32_t index, bool selected) {
+            m_buffer[m_count] = index;
+            m_count += static_cast<std::size_t>(selected);
+
+            if (m_count == selection_block) {
+                flush();
+            }
+        }
+
+        /**
+         * @brief Writes the indices of the rows selected by a bit mask.
+         *
+         * @param base The index of the row of the lowest bit.
+         * @param mask The mask of selected rows.
+         */
+        void write_mask(std::uint32_t base, unsigned mask) {
+            for (; mask != 0; mask &= mask - 1) {
+                write(base + static_cast<std::uint32_t>(std::countr_zero(mask)), true);
+            }
+        }
+
+        void flush() {
+            m_out.insert(m_out.end(), m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t>(m_count));
+            m_count = 0;
+        }
+
+    private:
+        selection_vector& m_out;
+        std::array<std::uint32_t, selection_block> m_buffer;
+        std::size_t m_count = 0;
+    };
+
+    template <typename Column, typename Pred>
+    void select_scalar(const Column& column, std::size_t first, Pred& pred, selection_writer& out) {
+        for (std::size_t i = first; i < column.size(); ++i) {
+            out.write(static_cast<std::uint32_t>(i), pred(column[i]));
+        }
+    }
+
+#if defined(__SSE2__)
+
+    template <typename T>
+    inline constexpr bool has_simd_compare_v = (std::is_integral_v<T> && !std::is_same_v<T, bool>)
+        || std::is_same_v<T, float> || std::is_same_v<T, double>;
+
+    /**
+     * @brief Fills a register with an integer.
+     *
+     * Unsigned integers narrower than 64 bits get their sign bit flipped, since SSE2 orders signed integers only and
+     * the flip preserves the unsigned order.
+     *
+     * @tparam T The type of the integer.
+     * @param value The integer.
+     * @return The register.
+     */
+    template <typename T> __m128i simd_splat(T value) {
+        if constexpr (sizeof(T) == 8) {
+            return _mm_set1_epi64x(static_cast<long long>(value));
+        } else {
+            using unsigned_t = std::make_unsigned_t<T>;
+
+            auto bits = static_cast<unsigned_t>(value);
+            if constexpr (std::is_unsigned_v<T>) {
+                bits ^= static_cast<unsigned_t>(unsigned_t { 1 } << (sizeof(T) * 8 - 1));
+            }
+
+            const auto lane = std::bit_cast<std::make_signed_t<T>>(bits);
+            if constexpr (sizeof(T) == 1) {
+                return _mm_set1_epi8(lane);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_set1_epi16(lane);
+            } else {
+                return _mm_set1_epi32(lane);
+            }
+        }
+    }
+
+    /**
+     * @brief Compares the integer lanes of two registers.
+     *
+     * @tparam T The type of the integers.
+     * @tparam Op The comparison, `EQUAL`, `LESS` or `GREATER`.
+     * @param lhs The elements.
+     * @param rhs The values.
+     * @return The register with all bits of the matching lanes set.
+     */
+    template <typename T, CompareOp Op> __m128i simd_compare_lanes(__m128i lhs, __m128i rhs) {
+        if constexpr (sizeof(T) == 8) {
+            static_assert(Op == CompareOp::EQUAL, "SSE2 cannot order 64-bit integers");
+
+            // both 32-bit halves of a lane must be equal
+            const __m128i halves = _mm_cmpeq_epi32(lhs, rhs);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        } else if constexpr (Op == CompareOp::EQUAL) {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_cmpeq_epi8(lhs, rhs);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_cmpeq_epi16(lhs, rhs);
+            } else {
+                return _mm_cmpeq_epi32(lhs, rhs);
+            }
+        } else if constexpr (Op == CompareOp::LESS) {
+            if constexpr (sizeof(T) == 1) {
+                return _mm_cmplt_epi8(lhs, rhs);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_cmplt_epi16(lhs, rhs);
+            } else {
+                return _mm_cmplt_epi32(lhs, rhs);
+            }
+        } else {
+            static_assert(Op == CompareOp::GREATER);
+            if constexpr (sizeof(T) == 1) {
+                return _mm_cmpgt_epi8(lhs, rhs);
+            } else if constexpr (sizeof(T) == 2) {
+                return _mm_cmpgt_epi16(lhs, rhs);
+            } else {
+                return _mm_cmpgt_epi32(lhs, rhs);
+            }
+        }
+    }
+
+    /**
+     * @brief Collects one bit per integer lane of a comparison result.
+     *
+     * @tparam T The type of the integers.
+     * @param result The comparison result.
+     * @return The bit mask with one bit per lane.
+     */
+    template <typename T> unsigned simd_lane_mask(__m128i result) {
+        if constexpr (sizeof(T) == 1) {
+            return static_cast<unsigned>(_mm_movemask_epi8(result));
+        } else if constexpr (sizeof(T) == 2) {
+            // saturating to bytes keeps the lanes as 0 or -1
+            return static_cast<unsigned>(_mm_movemask_epi8(_mm_packs_epi16(result, _mm_setzero_si128())));
+        } else if constexpr (sizeof(T) == 4) {
+            return static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(result)));
+        } else {
+            return static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(result)));
+        }
+    }
+
+    /**
+     * @brief Compares a register of elements with a register of values.
+     *
+     * SSE2 has no integer `LESS_EQUAL`, `GREATER_EQUAL` and `NOT_EQUAL`, they are the complement of another comparison.
+     *
+     * @tparam T The type of the elements.
+     * @tparam Op The comparison.
+     * @param lhs The elements.
+     * @param rhs The values.
+     * @return The bit mask with one bit per element.
+     */
+    template <typename T, CompareOp Op> unsigned simd_compare_mask(const T* lhs, auto rhs) {
+        if constexpr (std::is_same_v<T, float>) {
+            const __m128 elements = _mm_loadu_ps(lhs);
+            if constexpr (Op == CompareOp::EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpeq_ps(elements, rhs)));
+            } else if constexpr (Op == CompareOp::NOT_EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpneq_ps(elements, rhs)));
+            } else if constexpr (Op == CompareOp::LESS) {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmplt_ps(elements, rhs)));
+            } else if constexpr (Op == CompareOp::LESS_EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmple_ps(elements, rhs)));
+            } else if constexpr (Op == CompareOp::GREATER) {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpgt_ps(elements, rhs)));
+            } else {
+                return static_cast<unsigned>(_mm_movemask_ps(_mm_cmpge_ps(elements, rhs)));
+            }
+        } else if constexpr (std::is_same_v<T, double>) {
+            const __m128d elements = _mm_loadu_pd(lhs);
+            if constexpr (Op == CompareOp::EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpeq_pd(elements, rhs)));
+            } else if constexpr (Op == CompareOp::NOT_EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpneq_pd(elements, rhs)));
+            } else if constexpr (Op == CompareOp::LESS) {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmplt_pd(elements, rhs)));
+            } else if constexpr (Op == CompareOp::LESS_EQUAL) {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmple_pd(elements, rhs)));
+            } else if constexpr (Op == CompareOp::GREATER) {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpgt_pd(elements, rhs)));
+            } else {
+                return static_cast<unsigned>(_mm_movemask_pd(_mm_cmpge_pd(elements, rhs)));
+            }
+        } else {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            __m128i elements = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs));
+            if constexpr (std::is_unsigned_v<T> && sizeof(T) < 8) {
+                // SSE2 compares signed integers only, the splat of an unsigned zero holds the sign bits to flip
+                elements = _mm_xor_si128(elements, simd_splat<T>(0));
+            }
+
+            __m128i result;
+            if constexpr (Op == CompareOp::EQUAL || Op == CompareOp::NOT_EQUAL) {
+                result = simd_compare_lanes<T, CompareOp::EQUAL>(elements, rhs);
+            } else if constexpr (Op == CompareOp::LESS || Op == CompareOp::GREATER_EQUAL) {
+                result = simd_compare_lanes<T, CompareOp::LESS>(elements, rhs);
+            } else {
+                result = simd_compare_lanes<T, CompareOp::GREATER>(elements, rhs);
+            }
+
+            constexpr unsigned all_lanes = (1U << (16 / sizeof(T))) - 1;
+            constexpr bool complement
+                = Op == CompareOp::NOT_EQUAL || Op == CompareOp::GREATER_EQUAL || Op == CompareOp::LESS_EQUAL;
+
+            const unsigned mask = simd_lane_mask<T>(result);
+            return complement ? mask ^ all_lanes : mask;
+        }
+    }
+
+    /**
+     * @brief Selects the rows of a column matching a comparison a register at a time.
+     *
+     * @tparam Op The comparison.
+     * @tparam T The type of the elements.
+     * @param data The elements.
+     * @param size The number of elements.
+     * @param value The value compared with.
+     * @param out The writer of the selected indices.
+     * @return The number of elements processed, the rest is left for the scalar loop.
+     */
+    template <CompareOp Op, typename T>
+    std::size_t select_simd(const T* data, std::size_t size, T value, selection_writer& out) {
+        constexpr std::size_t lanes = 16 / sizeof(T);
+
+        if constexpr (std::is_integral_v<T> && sizeof(T) == 8 && Op != CompareOp::EQUAL && Op != CompareOp::NOT_EQUAL) {
+            // left for the scalar loop
+            return 0;
+        } else {
+            const auto values = [&] {
+                if constexpr (std::is_same_v<T, float>) {
+                    return _mm_set1_ps(value);
+                } else if constexpr (std::is_same_v<T, double>) {
+                    return _mm_set1_pd(value);
+                } else {
+                    return simd_splat(value);
+                }
+            }();
+
+            std::size_t i = 0;
+            for (; i + lanes <= size; i += lanes) {
+                out.write_mask(static_cast<std::uint32_t>(i), simd_compare_mask<T, Op>(data + i, values));
+            }
+            return i;
+        }
+    }
+
+    template <typename T>
+    std::size_t select_simd(const T* data, std::size_t size, const column_compare<T>& pred, selection_writer& out) {
+        switch (pred.op) {
+        case CompareOp::EQUAL:
+            return select_simd<CompareOp::EQUAL>(data, size, pred.value, out);
+        case CompareOp::NOT_EQUAL:
+            return select_simd<CompareOp::NOT_EQUAL>(data, size, pred.value, out);
+        case CompareOp::LESS:
+            return select_simd<CompareOp::LESS>(data, size, pred.value, out);
+        case CompareOp::LESS_EQUAL:
+            return select_simd<CompareOp::LESS_EQUAL>(data, size, pred.value, out);
+        case CompareOp::GREATER:
+            return select_simd<CompareOp::GREATER>(data, size, pred.value, out);
+        case CompareOp::GREATER_EQUAL:
+            return select_simd<CompareOp::GREATER_EQUAL>(data, size, pred.value, out);
+        }
+        return 0;
+    }
+
+#endif
+
+}
+
+/**
+ * @brief Selects the rows whose element of a column satisfies a predicate.
+ *
+ * The loop over the column is branch-free, a `column_compare` on integers, `float` or `double` is evaluated with SSE2
+ * when it is available.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Pred The type of the predicate.
+ * @param vec The multi_vector.
+ * @param pred The predicate called with a const reference to the element.
+ * @return The indices of the selected rows.
+ */
+template <std::size_t I, typename Vec, typename Pred> selection_vector select_where(const Vec& vec, Pred pred) {
+    const auto column = vec.template get_container<I>();
+    assert(column.size() <= std::numeric_limits<std::uint32_t>::max());
+
+    selection_vector selection;
+    {
+        detail::selection_writer out(selection);
+        std::size_t first = 0;
+
+#if defined(__SSE2__)
+        using element_t = std::remove_cvref_t<decltype(column[0])>;
+        if constexpr (std::is_same_v<Pred, column_compare<element_t>> && detail::has_simd_compare_v<element_t>) {
+            first = detail::select_simd(column.data(), column.size(), pred, out);
+        }
+#endif
+
+        detail::select_scalar(column, first, pred, out);
+    }
+
+    return selection;
+}
+
+/**
+ * @brief Keeps the selected rows whose element of a column satisfies a predicate.
+ *
+ * Used to chain filters, the predicate is evaluated only for rows which are already selected.
+ *
+ * @tparam I The index of the column.
+ * @tparam Vec The type of the multi_vector.
+ * @tparam Pred The type of the predicate.
+ * @param vec The multi_vector.
+ * @param selection The selection to refine.
+ * @param pred The predicate called with a const reference to the element.
+ */
+template <std::size_t I, typename Vec, typename Pred>
+void refine_where(const Vec& vec, selection_vector& selection, Pred pred) {
+    const auto column = vec.template get_container<I>();
+
+    std::size_t kept = 0;
+    for (const std::uint32_t row : selection) {
+        selection[kept] = row;
+        kept += static_cast<std::size_t>(pred(column[row]));
+    }
+    selection.resize(kept);
+}
+
+/**
+ * @brief Selects the rows whose bit in a packed bool column is set.
+ *
+ * @tparam M The index of the packed bool column.
+ * @tparam Vec The type of the multi_vector.
+ * @param vec The multi_vector.
+ * @return The indices of the selected rows.
+ */
+template <std::size_t M, typename Vec> selection_vector select_mask(const Vec& vec) {
+    const auto mask = vec.template get_container<M>();
+
+    selection_vector selection;
+    selection.reserve(mask.count());
+    mask.for_each_set([&](std::size_t pos) { selection.push_back(static_cast<std::uint32_t>(pos)); });
+
+    return selection;
+}
+
+/**
+ * @brief Copies the selected rows into a new multi_vector.
+ *
+ * Every column is gathered separately and copy-constructed in place by one `append`, so each pass reads one source
+ * column and the elements do not have to be default constructible.
+ *
+ * @tparam Layout The storage layout of the multi_vector.
+ * @tparam Types The types of elements stored in the multi_vector.
+ * @param vec The multi_vector.
+ * @param selection The indices of the rows to copy.
+ * @return The multi_vector holding the selected rows in the order of the selection.
+ */
+template <is_multi_vector_layout Layout, is_multi_vector_element... Types>
+basic_multi_vector<Layout, Types...>
+gather(const basic_multi_vector<Layout, Types...>& vec, const selection_vector& selection) {
+    // indices of the columns which are not void
+    static constexpr auto columns = [] {
+        constexpr std::array<bool, sizeof...(Types)> is_void = { std::is_void_v<Types>... };
+
+        std::array<std::size_t, (static_cast<std::size_t>(!std::is_void_v<Types>) + ...)> indices {};
+        for (std::size_t i = 0, used = 0; i < is_void.size(); ++i) {
+            if (!is_void[i]) {
+                indices[used++] = i;
+            }
+        }
+        return indices;
+    }();
+
+    auto gather_column = [&]<std::size_t I>(std::integral_constant<std::size_t, I> /*unused*/) {
+        // the elements are referenced, not copied, until they are constructed in the result
+        return std::views::transform(
+            selection,
+            [from = vec.template get_container<I>()](std::uint32_t row) -> decltype(auto) {
+                assert(row < from.size());
+                return from[row];
+            }
+        );
+    };
+
+    basic_multi_vector<Layout, Types...> result(vec.get_allocator());
+
+    [&]<std::size_t... J>(std::index_sequence<J...> /*unused*/) {
+        result.append(gather_column(std::integral_constant<std::size_t, columns[J]>())...);
+    }(std::make_index_sequence<columns.size()>());
+
+    return result;
+}
+
+}
+
+#endif
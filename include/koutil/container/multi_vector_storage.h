@@ -0,0 +1,1961 @@
+#ifndef KOUTIL_CONTAINER_MULTI_VECTOR_STORAGE_H
+#define KOUTIL_CONTAINER_MULTI_VECTOR_STORAGE_H
+
+#include "koutil/container/bit_column.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace koutil::container {
+
+/**
+ * @brief Trait to check if a type can be relocated with a plain byte copy.
+ *
+ * Relocating means moving an object to new storage and ending the lifetime of the old one. Types which are not
+ * trivially copyable but do not depend on their own address (e.g. most `std::unique_ptr`-like handles) can specialize
+ * this trait to get the `memcpy` fast path.
+ *
+ * @tparam T The type to check.
+ */
+template <typename T> struct is_trivially_relocatable : std::is_trivially_copyable<T> { };
+
+template <typename T> inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+    /**
+     * @brief Size of a cache line used for aligning columns.
+     */
+    inline constexpr std::size_t cache_line_size = 64;
+
+    /**
+     * @brief Relocates elements into uninitialized storage.
+     *
+     * @tparam T The type of the elements.
+     * @param from Pointer to the first element to relocate.
+     * @param count The number of elements.
+     * @param to Pointer to the uninitialized destination, must not overlap the source.
+     */
+    template <typename T> void relocate_n(T* from, std::size_t count, T* to) {
+        if (count == 0) {
+            return;
+        }
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), count * sizeof(T));
+        } else {
+            std::uninitialized_move_n(from, count, to);
+            std::destroy_n(from, count);
+        }
+    }
+
+    /**
+     * @brief Removes an element and shifts the following elements one position to the left.
+     *
+     * @tparam T The type of the elements.
+     * @param data Pointer to the first element.
+     * @param size The number of elements.
+     * @param index The index of the element to remove.
+     */
+    template <typename T> void erase_shift(T* data, std::size_t size, std::size_t index) {
+        assert(index < size);
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::destroy_at(data + index);
+            std::memmove(
+                static_cast<void*>(data + index),
+                static_cast<const void*>(data + index + 1),
+                (size - index - 1) * sizeof(T)
+            );
+        } else {
+            std::move(data + index + 1, data + size, data + index);
+            std::destroy_at(data + size - 1);
+        }
+    }
+
+    /**
+     * @brief Shifts the elements starting at a position to the right, leaving uninitialized storage behind them.
+     *
+     * @tparam T The type of the elements.
+     * @param data Pointer to the first element, with room for `size + count` elements.
+     * @param size The number of elements.
+     * @param pos The position of the gap.
+     * @param count The size of the gap.
+     */
+    template <typename T> void open_gap(T* data, std::size_t size, std::size_t pos, std::size_t count) {
+        assert(pos <= size);
+
+        if (pos == size || count == 0) {
+            return;
+        }
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            std::memmove(
+                static_cast<void*>(data + pos + count), static_cast<const void*>(data + pos), (size - pos) * sizeof(T)
+            );
+        } else {
+            for (std::size_t i = size; i-- > pos;) {
+                std::construct_at(data + i + count, std::move(data[i]));
+                std::destroy_at(data + i);
+            }
+        }
+    }
+
+    /**
+     * @brief Storage for a single column.
+     *
+     * @tparam T The type of the elements.
+     * @tparam Allocator The allocator type.
+     */
+    template <typename T, typename Allocator = std::allocator<T>> class single_vector {
+    private:
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+    public:
+        using allocator_type = Allocator;
+
+        single_vector() = default;
+
+        explicit single_vector(const Allocator& alloc)
+            : m_alloc(alloc) { }
+
+        single_vector(std::size_t n, const Allocator& alloc = Allocator())
+            : m_alloc(alloc)
+            , m_data(allocate(n))
+            , m_capacity(n)
+            , m_size(n) {
+            std::uninitialized_value_construct_n(m_data, n);
+        }
+
+        single_vector(std::size_t n, const T& value, const Allocator& alloc = Allocator())
+            : m_alloc(alloc)
+            , m_data(allocate(n))
+            , m_capacity(n)
+            , m_size(n) {
+            std::uninitialized_fill_n(m_data, n, value);
+        }
+
+        single_vector(const single_vector& other)
+            : m_alloc(allocator_traits::select_on_container_copy_construction(other.m_alloc))
+            , m_data(allocate(other.m_capacity))
+            , m_capacity(other.m_capacity)
+            , m_size(other.m_size) {
+            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+        }
+
+        ~single_vector() { destroy(); }
+
+        single_vector(single_vector&& other)
+            : m_alloc(std::move(other.m_alloc))
+            , m_data(other.m_data)
+            , m_capacity(other.m_capacity)
+            , m_size(other.m_size) {
+            other.m_capacity = 0;
+            other.m_size     = 0;
+            other.m_data     = nullptr;
+        }
+
+        single_vector& operator=(single_vector&& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            if constexpr (!allocator_traits::propagate_on_container_move_assignment::value) {
+                if (m_alloc != other.m_alloc) {
+                    // the memory cannot be adopted, so the elements are moved one by one
+                    clear();
+                    reserve(other.m_size);
+                    relocate_n(other.m_data, other.m_size, m_data);
+
+                    m_size       = other.m_size;
+                    other.m_size = 0;
+                    return *this;
+                }
+            }
+
+            destroy();
+
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                m_alloc = std::move(other.m_alloc);
+            }
+
+            m_size     = other.m_size;
+            m_capacity = other.m_capacity;
+            m_data     = other.m_data;
+
+            other.m_size     = 0;
+            other.m_capacity = 0;
+            other.m_data     = nullptr;
+
+            return *this;
+        }
+
+        single_vector& operator=(const single_vector& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc != other.m_alloc) {
+                    destroy();
+                }
+                m_alloc = other.m_alloc;
+            }
+
+            clear();
+            if (m_capacity < other.m_size) {
+                deallocate(m_data, m_capacity);
+                m_data     = allocate(other.m_capacity);
+                m_capacity = other.m_capacity;
+            }
+
+            std::uninitialized_copy_n(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+
+            return *this;
+        }
+
+        [[nodiscard]] Allocator get_allocator() const { return m_alloc; }
+
+        void clear() {
+            std::destroy_n(m_data, m_size);
+            m_size = 0;
+        }
+
+        void swap(single_vector& other) {
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                std::swap(m_alloc, other.m_alloc);
+            } else {
+                assert(m_alloc == other.m_alloc);
+            }
+
+            std::swap(m_data, other.m_data);
+            std::swap(m_size, other.m_size);
+            std::swap(m_capacity, other.m_capacity);
+        }
+
+        void push_back(const T& value) {
+            try_update_capacity();
+
+            std::construct_at(m_data + m_size, value);
+            m_size += 1;
+        }
+
+        void push_back(T&& value) {
+            try_update_capacity();
+
+            std::construct_at(m_data + m_size, std::move(value));
+            m_size += 1;
+        }
+
+        template <typename Arg> T& emplace_back(Arg&& arg) {
+            try_update_capacity();
+
+            std::construct_at(m_data + m_size, std::forward<decltype(arg)>(arg));
+            m_size += 1;
+
+            return m_data[m_size - 1];
+        }
+
+        /**
+         * @brief Inserts elements constructed by a function into a gap at a position.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted element.
+         * @param count The number of inserted elements.
+         * @param init The function constructing the elements in the uninitialized gap.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            if (m_size + count > m_capacity) {
+                realloc(std::max(m_size + count, next_capacity()));
+            }
+
+            open_gap(m_data, m_size, pos, count);
+            init(m_data + pos);
+            m_size += count;
+        }
+
+        T* erase(const T* element) {
+            assert(element < m_data + m_size && element >= m_data);
+
+            const auto index = static_cast<std::size_t>(element - m_data);
+
+            erase_shift(m_data, m_size, index);
+            m_size -= 1;
+
+            return m_data + index;
+        }
+
+        void pop_back() {
+            assert(m_size > 0);
+            m_size -= 1;
+            std::destroy_at(m_data + m_size);
+        }
+
+        void truncate(std::size_t n) {
+            assert(n <= m_size);
+            std::destroy(m_data + n, m_data + m_size);
+            m_size = n;
+        }
+
+        void resize(std::size_t n) {
+            if (m_size >= n) {
+                truncate(n);
+                return;
+            }
+
+            reserve(n);
+            std::uninitialized_value_construct(m_data + m_size, m_data + n);
+            m_size = n;
+        }
+
+        void resize(std::size_t n, const T& value) {
+            if (m_size >= n) {
+                truncate(n);
+                return;
+            }
+
+            reserve(n);
+            std::uninitialized_fill(m_data + m_size, m_data + n, value);
+            m_size = n;
+        }
+
+        void reserve(std::size_t n) {
+            if (n <= m_capacity) {
+                return;
+            }
+
+            realloc(n);
+        }
+
+        void shrink_to_fit() {
+            if (m_size == m_capacity) {
+                return;
+            }
+
+            realloc(m_size);
+        }
+
+        T& at(std::size_t i) { return m_data[i]; }
+
+        [[nodiscard]] const T& at(std::size_t i) const { return m_data[i]; }
+
+        T* data() { return m_data; }
+
+        [[nodiscard]] const T* data() const { return m_data; }
+
+        [[nodiscard]] std::size_t size() const { return m_size; }
+
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+
+        T* begin() { return m_data; }
+
+        const T* begin() const { return m_data; }
+
+        T* end() { return m_data + m_size; }
+
+        const T* end() const { return m_data + m_size; }
+
+    private:
+        [[no_unique_address]] Allocator m_alloc;
+        T* m_data              = nullptr;
+        std::size_t m_capacity = 0;
+        std::size_t m_size     = 0;
+
+        T* allocate(std::size_t n) {
+            if (n == 0) {
+                return nullptr;
+            }
+
+            return allocator_traits::allocate(m_alloc, n);
+        }
+
+        void deallocate(T* data, std::size_t n) {
+            if (data != nullptr) {
+                allocator_traits::deallocate(m_alloc, data, n);
+            }
+        }
+
+        void destroy() {
+            std::destroy_n(m_data, m_size);
+            deallocate(m_data, m_capacity);
+
+            m_data     = nullptr;
+            m_capacity = 0;
+            m_size     = 0;
+        }
+
+        [[nodiscard]] std::size_t next_capacity() const {
+            if (m_capacity == 0) {
+                return 1;
+            } else [[likely]] {
+                return m_capacity * 2;
+            }
+        }
+
+        void try_update_capacity() {
+            if (m_size + 1 <= m_capacity) {
+                return;
+            }
+            realloc(next_capacity());
+        }
+
+        void realloc(std::size_t capacity) {
+            assert(capacity >= m_size);
+
+            T* new_data = allocate(capacity);
+            relocate_n(m_data, m_size, new_data);
+
+            deallocate(m_data, m_capacity);
+            m_data     = new_data;
+            m_capacity = capacity;
+        }
+    };
+
+    /**
+     * @brief Storage keeping every column in its own allocation.
+     *
+     * @tparam Allocator The allocator type, rebound for every column.
+     * @tparam Types The types of the columns.
+     */
+    template <typename Allocator, typename... Types> class column_storage {
+    private:
+        template <typename T> using column_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        template <typename T> using column_t = single_vector<T, column_allocator_t<T>>;
+
+    public:
+        using value_t        = std::tuple<Types...>;
+        using allocator_type = Allocator;
+
+        column_storage() = default;
+
+        /**
+         * @brief Constructs an empty storage using an allocator.
+         *
+         * @param alloc The allocator.
+         */
+        explicit column_storage(const Allocator& alloc)
+            : m_columns(column_t<Types>(column_allocator_t<Types>(alloc))...) { }
+
+        /**
+         * @brief Constructs a storage with a specified size and default-initialized elements.
+         *
+         * @param count The number of elements.
+         * @param alloc The allocator.
+         */
+        explicit column_storage(std::size_t count, const Allocator& alloc = Allocator())
+            : m_columns(column_t<Types>(count, column_allocator_t<Types>(alloc))...) { }
+
+        /**
+         * @brief Constructs a storage with a specified size and initial value.
+         *
+         * @param count The number of elements.
+         * @param value The initial value for the elements.
+         * @param alloc The allocator.
+         */
+        column_storage(std::size_t count, const value_t& value, const Allocator& alloc = Allocator())
+            : column_storage(count, value, alloc, helper_seq) { }
+
+        /**
+         * @brief Returns the allocator.
+         *
+         * @return The allocator.
+         */
+        [[nodiscard]] Allocator get_allocator() const { return Allocator(std::get<0>(m_columns).get_allocator()); }
+
+        /**
+         * @brief Returns the number of rows.
+         *
+         * @return The number of rows.
+         */
+        [[nodiscard]] std::size_t size() const { return std::get<0>(m_columns).size(); }
+
+        /**
+         * @brief Returns the number of rows that fit into the allocated storage.
+         *
+         * @return The capacity.
+         */
+        [[nodiscard]] std::size_t capacity() const { return std::get<0>(m_columns).capacity(); }
+
+        /**
+         * @brief Returns a pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Pointer to the first element.
+         */
+        template <std::size_t I> auto* data() { return std::get<I>(m_columns).data(); }
+
+        /**
+         * @brief Returns a const pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Const pointer to the first element.
+         */
+        template <std::size_t I> const auto* data() const { return std::get<I>(m_columns).data(); }
+
+        void clear() { clear_all(helper_seq); }
+
+        void swap(column_storage& other) { swap_impl(other, helper_seq); }
+
+        void truncate(std::size_t size) { truncate_all(size, helper_seq); }
+
+        void resize(std::size_t size) { resize_all(size, helper_seq); }
+
+        void resize(std::size_t size, const value_t& value) { resize_all_with(size, value, helper_seq); }
+
+        void reserve(std::size_t size) { reserve_impl(size, helper_seq); }
+
+        void shrink_to_fit() { shrink_to_fit_impl(helper_seq); }
+
+        void pop_back() { pop_back_impl(helper_seq); }
+
+        template <typename Value> void push_back(Value&& value) {
+            push_back_impl(std::forward<decltype(value)>(value), helper_seq);
+        }
+
+        template <typename... Args> void emplace_back(Args&&... args) {
+            emplace_back_impl(helper_seq, std::forward<decltype(args)>(args)...);
+        }
+
+        void erase(std::size_t pos) { erase_impl(pos, helper_seq); }
+
+        /**
+         * @brief Inserts rows whose columns are constructed by a function.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted row.
+         * @param count The number of inserted rows.
+         * @param init The function called with the column index and a pointer to the uninitialized gap of the column.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            insert_rows_impl(pos, count, init, helper_seq);
+        }
+
+    private:
+        static constexpr auto helper_seq = std::make_index_sequence<sizeof...(Types)>();
+
+        std::tuple<column_t<Types>...> m_columns;
+
+        template <typename Init, std::size_t... I>
+        void insert_rows_impl(std::size_t pos, std::size_t count, Init& init, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).insert_rows(
+                 pos, count, [&](auto* gap) { init(std::integral_constant<std::size_t, I>(), gap); }
+             ),
+             ...);
+        }
+
+        template <std::size_t... I>
+        column_storage(
+            std::size_t count, const value_t& value, const Allocator& alloc, std::index_sequence<I...> /*unused*/
+        )
+            : m_columns(column_t<Types>(count, std::get<I>(value), column_allocator_t<Types>(alloc))...) { }
+
+        template <std::size_t... I> void swap_impl(column_storage& other, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).swap(std::get<I>(other.m_columns)), ...);
+        }
+
+        template <std::size_t... I> void clear_all(std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).clear(), ...);
+        }
+
+        template <std::size_t... I> void truncate_all(std::size_t size, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).truncate(size), ...);
+        }
+
+        template <std::size_t... I> void resize_all(std::size_t size, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).resize(size), ...);
+        }
+
+        template <std::size_t... I>
+        void resize_all_with(std::size_t size, const value_t& value, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).resize(size, std::get<I>(value)), ...);
+        }
+
+        template <std::size_t... I> void pop_back_impl(std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).pop_back(), ...);
+        }
+
+        template <typename Value, std::size_t... I>
+        void push_back_impl(Value&& value, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).push_back(std::get<I>(std::forward<decltype(value)>(value))), ...);
+        }
+
+        template <typename... Args, std::size_t... I>
+        void emplace_back_impl(std::index_sequence<I...> /*unused*/, Args&&... args) {
+            (std::get<I>(m_columns).emplace_back(std::forward<decltype(args)>(args)), ...);
+        }
+
+        template <std::size_t... I> void shrink_to_fit_impl(std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).shrink_to_fit(), ...);
+        }
+
+        template <std::size_t... I> void reserve_impl(std::size_t size, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).reserve(size), ...);
+        }
+
+        template <std::size_t... I> void erase_impl(std::size_t pos, std::index_sequence<I...> /*unused*/) {
+            (std::get<I>(m_columns).erase(std::get<I>(m_columns).begin() + pos), ...);
+        }
+    };
+
+    /**
+     * @brief Storage keeping all columns in one contiguous allocation.
+     *
+     * Columns are placed one after another and every column starts on a cache line. The capacity is always a multiple
+     * of `row_granularity`, so the byte size of every column is a multiple of the alignment and the offset of a column
+     * is `capacity * column_offsets[I]`.
+     *
+     * @tparam Allocator The allocator type, rebound to cache lines.
+     * @tparam Types The types of the columns.
+     */
+    template <typename Allocator, typename... Types> class block_storage {
+    private:
+        static constexpr std::size_t column_count = sizeof...(Types);
+
+        static constexpr std::size_t alignment = std::max({ cache_line_size, alignof(Types)... });
+
+        static constexpr std::size_t row_granularity = [] {
+            std::size_t granularity = 1;
+            ((granularity = std::lcm(granularity, alignment / std::gcd(alignment, sizeof(Types)))), ...);
+            return granularity;
+        }();
+
+        static constexpr std::array<std::size_t, column_count + 1> column_offsets = [] {
+            constexpr std::array<std::size_t, column_count> sizes = { sizeof(Types)... };
+
+            std::array<std::size_t, column_count + 1> offsets {};
+            std::partial_sum(sizes.begin(), sizes.end(), offsets.begin() + 1);
+            return offsets;
+        }();
+
+        static constexpr std::size_t row_size = column_offsets[column_count];
+
+        static constexpr bool trivially_copyable = (std::is_trivially_copyable_v<Types> && ...);
+
+        struct alignas(alignment) line {
+            std::byte bytes[alignment];
+        };
+
+        using allocator_t      = std::allocator_traits<Allocator>::template rebind_alloc<line>;
+        using allocator_traits = std::allocator_traits<allocator_t>;
+
+        template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    public:
+        using value_t        = std::tuple<Types...>;
+        using allocator_type = Allocator;
+
+        block_storage() = default;
+
+        /**
+         * @brief Constructs an empty storage using an allocator.
+         *
+         * @param alloc The allocator.
+         */
+        explicit block_storage(const Allocator& alloc)
+            : m_alloc(alloc) { }
+
+        /**
+         * @brief Constructs a storage with a specified size and default-initialized elements.
+         *
+         * @param count The number of elements.
+         * @param alloc The allocator.
+         */
+        explicit block_storage(std::size_t count, const Allocator& alloc = Allocator())
+            : m_alloc(alloc)
+            , m_block(allocate(round_capacity(count)))
+            , m_capacity(round_capacity(count))
+            , m_size(count) {
+            init_default(helper_seq);
+        }
+
+        /**
+         * @brief Constructs a storage with a specified size and initial value.
+         *
+         * @param count The number of elements.
+         * @param value The initial value for the elements.
+         * @param alloc The allocator.
+         */
+        block_storage(std::size_t count, const value_t& value, const Allocator& alloc = Allocator())
+            : m_alloc(alloc)
+            , m_block(allocate(round_capacity(count)))
+            , m_capacity(round_capacity(count))
+            , m_size(count) {
+            init_value(value, helper_seq);
+        }
+
+        block_storage(const block_storage& other)
+            : m_alloc(allocator_traits::select_on_container_copy_construction(other.m_alloc))
+            , m_block(allocate(other.m_capacity))
+            , m_capacity(other.m_capacity)
+            , m_size(other.m_size) {
+            copy_from(other, helper_seq);
+        }
+
+        block_storage(block_storage&& other)
+            : m_alloc(std::move(other.m_alloc))
+            , m_block(other.m_block)
+            , m_capacity(other.m_capacity)
+            , m_size(other.m_size) {
+            other.m_block    = nullptr;
+            other.m_capacity = 0;
+            other.m_size     = 0;
+        }
+
+        ~block_storage() { destroy(); }
+
+        block_storage& operator=(const block_storage& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                m_alloc = other.m_alloc;
+            }
+
+            m_block    = allocate(other.m_capacity);
+            m_capacity = other.m_capacity;
+            m_size     = other.m_size;
+
+            copy_from(other, helper_seq);
+
+            return *this;
+        }
+
+        block_storage& operator=(block_storage&& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+
+            if constexpr (!allocator_traits::propagate_on_container_move_assignment::value) {
+                if (m_alloc != other.m_alloc) {
+                    // the block cannot be adopted, so the elements are relocated into a new one
+                    m_block    = allocate(other.m_capacity);
+                    m_capacity = other.m_capacity;
+                    m_size     = other.m_size;
+
+                    relocate_from(other, helper_seq);
+
+                    other.m_size = 0;
+                    return *this;
+                }
+            } else {
+                m_alloc = std::move(other.m_alloc);
+            }
+
+            m_block    = other.m_block;
+            m_capacity = other.m_capacity;
+            m_size     = other.m_size;
+
+            other.m_block    = nullptr;
+            other.m_capacity = 0;
+            other.m_size     = 0;
+
+            return *this;
+        }
+
+        /**
+         * @brief Returns the allocator.
+         *
+         * @return The allocator.
+         */
+        [[nodiscard]] Allocator get_allocator() const { return Allocator(m_alloc); }
+
+        /**
+         * @brief Returns the number of rows.
+         *
+         * @return The number of rows.
+         */
+        [[nodiscard]] std::size_t size() const { return m_size; }
+
+        /**
+         * @brief Returns the number of rows that fit into the allocated block.
+         *
+         * @return The capacity.
+         */
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+
+        /**
+         * @brief Returns a pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Pointer to the first element.
+         */
+        template <std::size_t I> element_t<I>* data() { return column<I>(m_block, m_capacity); }
+
+        /**
+         * @brief Returns a const pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Const pointer to the first element.
+         */
+        template <std::size_t I> const element_t<I>* data() const { return column<I>(m_block, m_capacity); }
+
+        void clear() {
+            destroy_range(0, m_size, helper_seq);
+            m_size = 0;
+        }
+
+        void swap(block_storage& other) {
+            if constexpr (allocator_traits::propagate_on_container_swap::value) {
+                std::swap(m_alloc, other.m_alloc);
+            } else {
+                assert(m_alloc == other.m_alloc);
+            }
+
+            std::swap(m_block, other.m_block);
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_size, other.m_size);
+        }
+
+        void truncate(std::size_t size) {
+            assert(size <= m_size);
+            destroy_range(size, m_size, helper_seq);
+            m_size = size;
+        }
+
+        void resize(std::size_t size) {
+            if (size <= m_size) {
+                destroy_range(size, m_size, helper_seq);
+            } else {
+                reserve(size);
+                construct_default(m_size, size, helper_seq);
+            }
+            m_size = size;
+        }
+
+        void resize(std::size_t size, const value_t& value) {
+            if (size <= m_size) {
+                destroy_range(size, m_size, helper_seq);
+            } else {
+                reserve(size);
+                construct_value(m_size, size, value, helper_seq);
+            }
+            m_size = size;
+        }
+
+        void reserve(std::size_t size) {
+            if (size <= m_capacity) {
+                return;
+            }
+
+            realloc(round_capacity(size));
+        }
+
+        void shrink_to_fit() {
+            const std::size_t capacity = round_capacity(m_size);
+            if (capacity != m_capacity) {
+                realloc(capacity);
+            }
+        }
+
+        void pop_back() {
+            assert(m_size > 0);
+            destroy_range(m_size - 1, m_size, helper_seq);
+            m_size -= 1;
+        }
+
+        template <typename Value> void push_back(Value&& value) {
+            try_update_capacity();
+            push_back_impl(std::forward<decltype(value)>(value), helper_seq);
+            m_size += 1;
+        }
+
+        template <typename... Args> void emplace_back(Args&&... args) {
+            try_update_capacity();
+            emplace_back_impl(helper_seq, std::forward<decltype(args)>(args)...);
+            m_size += 1;
+        }
+
+        void erase(std::size_t pos) {
+            assert(pos < m_size);
+            erase_impl(pos, helper_seq);
+            m_size -= 1;
+        }
+
+        /**
+         * @brief Inserts rows whose columns are constructed by a function.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted row.
+         * @param count The number of inserted rows.
+         * @param init The function called with the column index and a pointer to the uninitialized gap of the column.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            assert(pos <= m_size);
+
+            if (m_size + count > m_capacity) {
+                realloc(round_capacity(std::max(m_size + count, next_capacity())));
+            }
+
+            insert_rows_impl(pos, count, init, helper_seq);
+            m_size += count;
+        }
+
+    private:
+        static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+        [[no_unique_address]] allocator_t m_alloc;
+        line* m_block          = nullptr;
+        std::size_t m_capacity = 0;
+        std::size_t m_size     = 0;
+
+        static constexpr std::size_t round_capacity(std::size_t capacity) {
+            return (capacity + row_granularity - 1) / row_granularity * row_granularity;
+        }
+
+        static constexpr std::size_t line_count(std::size_t capacity) { return capacity * row_size / alignment; }
+
+        line* allocate(std::size_t capacity) {
+            if (capacity == 0) {
+                return nullptr;
+            }
+
+            return allocator_traits::allocate(m_alloc, line_count(capacity));
+        }
+
+        void deallocate(line* block, std::size_t capacity) {
+            if (block != nullptr) {
+                allocator_traits::deallocate(m_alloc, block, line_count(capacity));
+            }
+        }
+
+        template <std::size_t I> static element_t<I>* column(line* block, std::size_t capacity) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<element_t<I>*>(reinterpret_cast<std::byte*>(block) + capacity * column_offsets[I]);
+        }
+
+        template <std::size_t I> static const element_t<I>* column(const line* block, std::size_t capacity) {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<const element_t<I>*>(
+                reinterpret_cast<const std::byte*>(block) + capacity * column_offsets[I]
+            );
+        }
+
+        [[nodiscard]] std::size_t next_capacity() const {
+            if (m_capacity == 0) {
+                return row_granularity;
+            } else [[likely]] {
+                return m_capacity * 2;
+            }
+        }
+
+        void try_update_capacity() {
+            if (m_size + 1 <= m_capacity) {
+                return;
+            }
+            realloc(next_capacity());
+        }
+
+        void realloc(std::size_t capacity) {
+            assert(capacity >= m_size);
+
+            line* new_block = allocate(capacity);
+            relocate_to(new_block, capacity, helper_seq);
+
+            deallocate(m_block, m_capacity);
+            m_block    = new_block;
+            m_capacity = capacity;
+        }
+
+        void destroy() {
+            destroy_range(0, m_size, helper_seq);
+            deallocate(m_block, m_capacity);
+
+            m_block    = nullptr;
+            m_capacity = 0;
+            m_size     = 0;
+        }
+
+        template <std::size_t... I> void init_default(std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_value_construct_n(data<I>(), m_size), ...);
+        }
+
+        template <std::size_t... I> void init_value(const value_t& value, std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_fill_n(data<I>(), m_size, std::get<I>(value)), ...);
+        }
+
+        template <std::size_t... I> void copy_from(const block_storage& other, std::index_sequence<I...> /*unused*/) {
+            if (m_block == nullptr) {
+                return;
+            }
+
+            if constexpr (trivially_copyable) {
+                // the layout depends only on the capacity, so the whole block can be copied at once
+                std::memcpy(m_block, other.m_block, line_count(m_capacity) * sizeof(line));
+            } else {
+                (std::uninitialized_copy_n(other.template data<I>(), m_size, data<I>()), ...);
+            }
+        }
+
+        template <std::size_t... I> void relocate_from(block_storage& other, std::index_sequence<I...> /*unused*/) {
+            (relocate_n(other.template data<I>(), m_size, data<I>()), ...);
+        }
+
+        template <std::size_t... I>
+        void relocate_to(line* block, std::size_t capacity, std::index_sequence<I...> /*unused*/) {
+            (relocate_column<I>(block, capacity), ...);
+        }
+
+        template <std::size_t I> void relocate_column(line* block, std::size_t capacity) {
+            relocate_n(data<I>(), m_size, column<I>(block, capacity));
+        }
+
+        template <std::size_t... I>
+        void destroy_range(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+            (std::destroy(data<I>() + from, data<I>() + to), ...);
+        }
+
+        template <std::size_t... I>
+        void construct_default(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_value_construct(data<I>() + from, data<I>() + to), ...);
+        }
+
+        template <std::size_t... I>
+        void
+        construct_value(std::size_t from, std::size_t to, const value_t& value, std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_fill(data<I>() + from, data<I>() + to, std::get<I>(value)), ...);
+        }
+
+        template <typename Value, std::size_t... I>
+        void push_back_impl(Value&& value, std::index_sequence<I...> /*unused*/) {
+            (std::construct_at(data<I>() + m_size, std::get<I>(std::forward<decltype(value)>(value))), ...);
+        }
+
+        template <typename... Args, std::size_t... I>
+        void emplace_back_impl(std::index_sequence<I...> /*unused*/, Args&&... args) {
+            (std::construct_at(data<I>() + m_size, std::forward<decltype(args)>(args)), ...);
+        }
+
+        template <std::size_t... I> void erase_impl(std::size_t pos, std::index_sequence<I...> /*unused*/) {
+            (erase_shift(data<I>(), m_size, pos), ...);
+        }
+
+        template <typename Init, std::size_t... I>
+        void insert_rows_impl(std::size_t pos, std::size_t count, Init& init, std::index_sequence<I...> /*unused*/) {
+            ((open_gap(data<I>(), m_size, pos, count), init(std::integral_constant<std::size_t, I>(), data<I>() + pos)),
+             ...);
+        }
+    };
+
+    /**
+     * @brief Storage keeping up to `N` rows inline and spilling every column to its own allocation beyond that.
+     *
+     * The storage is inline exactly when the capacity equals `N`.
+     *
+     * @tparam N The number of inline rows.
+     * @tparam Allocator The allocator type, rebound for every column.
+     * @tparam Types The types of the columns.
+     */
+    template <std::size_t N, typename Allocator, typename... Types> class small_storage {
+    private:
+        static_assert(N > 0, "The inline capacity must not be zero");
+
+        template <typename T> using column_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+        using allocator_traits = std::allocator_traits<Allocator>;
+
+        template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+        template <typename T> struct inline_column {
+            alignas(T) std::byte bytes[N * sizeof(T)];
+        };
+
+    public:
+        using value_t        = std::tuple<Types...>;
+        using allocator_type = Allocator;
+
+        small_storage() = default;
+
+        /**
+         * @brief Constructs an empty storage using an allocator.
+         *
+         * @param alloc The allocator.
+         */
+        explicit small_storage(const Allocator& alloc)
+            : m_alloc(alloc) { }
+
+        /**
+         * @brief Constructs a storage with a specified size and default-initialized elements.
+         *
+         * @param count The number of elements.
+         * @param alloc The allocator.
+         */
+        explicit small_storage(std::size_t count, const Allocator& alloc = Allocator())
+            : m_alloc(alloc) {
+            resize(count);
+        }
+
+        /**
+         * @brief Constructs a storage with a specified size and initial value.
+         *
+         * @param count The number of elements.
+         * @param value The initial value for the elements.
+         * @param alloc The allocator.
+         */
+        small_storage(std::size_t count, const value_t& value, const Allocator& alloc = Allocator())
+            : m_alloc(alloc) {
+            resize(count, value);
+        }
+
+        small_storage(const small_storage& other)
+            : m_alloc(allocator_traits::select_on_container_copy_construction(other.m_alloc)) {
+            copy_from(other, helper_seq);
+        }
+
+        small_storage(small_storage&& other)
+            : m_alloc(std::move(other.m_alloc)) {
+            take_from(other);
+        }
+
+        ~small_storage() { destroy(); }
+
+        small_storage& operator=(const small_storage& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+                if (m_alloc != other.m_alloc) {
+                    destroy();
+                }
+                m_alloc = other.m_alloc;
+            }
+
+            clear();
+            copy_from(other, helper_seq);
+
+            return *this;
+        }
+
+        small_storage& operator=(small_storage&& other) {
+            if (&other == this) {
+                return *this;
+            }
+
+            destroy();
+
+            if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+                m_alloc = std::move(other.m_alloc);
+            }
+
+            take_from(other);
+            return *this;
+        }
+
+        /**
+         * @brief Returns the allocator.
+         *
+         * @return The allocator.
+         */
+        [[nodiscard]] Allocator get_allocator() const { return m_alloc; }
+
+        /**
+         * @brief Returns the number of rows.
+         *
+         * @return The number of rows.
+         */
+        [[nodiscard]] std::size_t size() const { return m_size; }
+
+        /**
+         * @brief Returns the number of rows that fit into the inline or allocated storage.
+         *
+         * @return The capacity.
+         */
+        [[nodiscard]] std::size_t capacity() const { return m_capacity; }
+
+        /**
+         * @brief Returns a pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Pointer to the first element.
+         */
+        template <std::size_t I> element_t<I>* data() {
+            return is_inline() ? inline_data<I>() : std::get<I>(m_heap);
+        }
+
+        /**
+         * @brief Returns a const pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Const pointer to the first element.
+         */
+        template <std::size_t I> const element_t<I>* data() const {
+            return is_inline() ? inline_data<I>() : std::get<I>(m_heap);
+        }
+
+        void clear() { truncate(0); }
+
+        void swap(small_storage& other) {
+            if constexpr (!allocator_traits::propagate_on_container_swap::value) {
+                assert(m_alloc == other.m_alloc);
+            }
+
+            // inline rows cannot be exchanged by swapping pointers
+            small_storage tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        void truncate(std::size_t size) {
+            assert(size <= m_size);
+            destroy_range(size, m_size, helper_seq);
+            m_size = size;
+        }
+
+        void resize(std::size_t size) {
+            if (size <= m_size) {
+                truncate(size);
+                return;
+            }
+
+            reserve(size);
+            construct_default(m_size, size, helper_seq);
+            m_size = size;
+        }
+
+        void resize(std::size_t size, const value_t& value) {
+            if (size <= m_size) {
+                truncate(size);
+                return;
+            }
+
+            reserve(size);
+            construct_value(m_size, size, value, helper_seq);
+            m_size = size;
+        }
+
+        void reserve(std::size_t size) {
+            if (size <= m_capacity) {
+                return;
+            }
+
+            realloc(size);
+        }
+
+        void shrink_to_fit() {
+            const std::size_t capacity = std::max(m_size, N);
+            if (capacity != m_capacity) {
+                realloc(capacity);
+            }
+        }
+
+        void pop_back() {
+            assert(m_size > 0);
+            truncate(m_size - 1);
+        }
+
+        template <typename Value> void push_back(Value&& value) {
+            try_update_capacity();
+            push_back_impl(std::forward<decltype(value)>(value), helper_seq);
+            m_size += 1;
+        }
+
+        template <typename... Args> void emplace_back(Args&&... args) {
+            try_update_capacity();
+            emplace_back_impl(helper_seq, std::forward<decltype(args)>(args)...);
+            m_size += 1;
+        }
+
+        void erase(std::size_t pos) {
+            assert(pos < m_size);
+            erase_impl(pos, helper_seq);
+            m_size -= 1;
+        }
+
+        /**
+         * @brief Inserts rows whose columns are constructed by a function.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted row.
+         * @param count The number of inserted rows.
+         * @param init The function called with the column index and a pointer to the uninitialized gap of the column.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            assert(pos <= m_size);
+
+            if (m_size + count > m_capacity) {
+                realloc(std::max(m_size + count, m_capacity * 2));
+            }
+
+            insert_rows_impl(pos, count, init, helper_seq);
+            m_size += count;
+        }
+
+    private:
+        static constexpr auto helper_seq = std::make_index_sequence<sizeof...(Types)>();
+
+        std::tuple<inline_column<Types>...> m_inline;
+        [[no_unique_address]] Allocator m_alloc;
+        std::tuple<Types*...> m_heap {};
+        std::size_t m_capacity = N;
+        std::size_t m_size     = 0;
+
+        [[nodiscard]] bool is_inline() const { return m_capacity == N; }
+
+        template <std::size_t I> element_t<I>* inline_data() {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<element_t<I>*>(std::get<I>(m_inline).bytes);
+        }
+
+        template <std::size_t I> const element_t<I>* inline_data() const {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return reinterpret_cast<const element_t<I>*>(std::get<I>(m_inline).bytes);
+        }
+
+        void try_update_capacity() {
+            if (m_size + 1 <= m_capacity) {
+                return;
+            }
+            realloc(m_capacity * 2);
+        }
+
+        /**
+         * @brief Moves the rows into storage with a new capacity, which is inline if it does not exceed `N`.
+         *
+         * @param capacity The new capacity.
+         */
+        void realloc(std::size_t capacity) {
+            assert(capacity >= m_size);
+
+            capacity = std::max(capacity, N);
+            if (capacity == m_capacity && is_inline()) {
+                return;
+            }
+
+            std::tuple<Types*...> heap {};
+            relocate_all(heap, capacity, helper_seq);
+
+            m_heap     = heap;
+            m_capacity = capacity;
+        }
+
+        template <std::size_t... I>
+        void relocate_all(std::tuple<Types*...>& heap, std::size_t capacity, std::index_sequence<I...> /*unused*/) {
+            (relocate_column<I>(std::get<I>(heap), capacity), ...);
+        }
+
+        template <std::size_t I> void relocate_column(element_t<I>*& heap, std::size_t capacity) {
+            column_allocator_t<element_t<I>> alloc(m_alloc);
+
+            element_t<I>* target = inline_data<I>();
+            if (capacity != N) {
+                heap   = std::allocator_traits<decltype(alloc)>::allocate(alloc, capacity);
+                target = heap;
+            }
+
+            relocate_n(data<I>(), m_size, target);
+
+            if (!is_inline()) {
+                std::allocator_traits<decltype(alloc)>::deallocate(alloc, std::get<I>(m_heap), m_capacity);
+            }
+        }
+
+        /**
+         * @brief Destroys all elements and frees the allocated columns.
+         */
+        void destroy() {
+            clear();
+            shrink_to_fit();
+        }
+
+        /**
+         * @brief Takes the rows of another storage, adopting its columns if they are allocated by an equal allocator.
+         *
+         * @param other The other storage, left empty and inline.
+         */
+        void take_from(small_storage& other) {
+            assert(m_size == 0 && is_inline());
+
+            if (!other.is_inline() && m_alloc == other.m_alloc) {
+                m_heap     = other.m_heap;
+                m_capacity = other.m_capacity;
+                m_size     = other.m_size;
+
+                other.m_heap     = {};
+                other.m_capacity = N;
+                other.m_size     = 0;
+                return;
+            }
+
+            reserve(other.m_size);
+            relocate_from(other, helper_seq);
+
+            m_size       = other.m_size;
+            other.m_size = 0;
+            other.shrink_to_fit();
+        }
+
+        template <std::size_t... I> void copy_from(const small_storage& other, std::index_sequence<I...> /*unused*/) {
+            reserve(other.m_size);
+            (std::uninitialized_copy_n(other.template data<I>(), other.m_size, data<I>()), ...);
+            m_size = other.m_size;
+        }
+
+        template <std::size_t... I> void relocate_from(small_storage& other, std::index_sequence<I...> /*unused*/) {
+            (relocate_n(other.template data<I>(), other.m_size, data<I>()), ...);
+        }
+
+        template <std::size_t... I>
+        void destroy_range(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+            (std::destroy(data<I>() + from, data<I>() + to), ...);
+        }
+
+        template <std::size_t... I>
+        void construct_default(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_value_construct(data<I>() + from, data<I>() + to), ...);
+        }
+
+        template <std::size_t... I>
+        void
+        construct_value(std::size_t from, std::size_t to, const value_t& value, std::index_sequence<I...> /*unused*/) {
+            (std::uninitialized_fill(data<I>() + from, data<I>() + to, std::get<I>(value)), ...);
+        }
+
+        template <typename Value, std::size_t... I>
+        void push_back_impl(Value&& value, std::index_sequence<I...> /*unused*/) {
+            (std::construct_at(data<I>() + m_size, std::get<I>(std::forward<decltype(value)>(value))), ...);
+        }
+
+        template <typename... Args, std::size_t... I>
+        void emplace_back_impl(std::index_sequence<I...> /*unused*/, Args&&... args) {
+            (std::construct_at(data<I>() + m_size, std::forward<decltype(args)>(args)), ...);
+        }
+
+        template <std::size_t... I> void erase_impl(std::size_t pos, std::index_sequence<I...> /*unused*/) {
+            (erase_shift(data<I>(), m_size, pos), ...);
+        }
+
+        template <typename Init, std::size_t... I>
+        void insert_rows_impl(std::size_t pos, std::size_t count, Init& init, std::index_sequence<I...> /*unused*/) {
+            ((open_gap(data<I>(), m_size, pos, count), init(std::integral_constant<std::size_t, I>(), data<I>() + pos)),
+             ...);
+        }
+    };
+
+    /**
+     * @brief Storage for packed bool columns.
+     *
+     * Every column is a vector of words. Bits past the size are kept cleared.
+     *
+     * @tparam Allocator The allocator type, rebound to words.
+     * @tparam Count The number of columns.
+     */
+    template <typename Allocator, std::size_t Count> class bit_storage {
+    private:
+        using word_allocator_t = std::allocator_traits<Allocator>::template rebind_alloc<bit_word>;
+
+        using column_t = single_vector<bit_word, word_allocator_t>;
+
+    public:
+        bit_storage() = default;
+
+        explicit bit_storage(const Allocator& alloc)
+            : m_columns(make_columns(alloc, helper_seq)) { }
+
+        bit_storage(const bit_storage&)            = default;
+        bit_storage& operator=(const bit_storage&) = default;
+
+        bit_storage(bit_storage&& other)
+            : m_columns(std::move(other.m_columns))
+            , m_size(std::exchange(other.m_size, 0)) { }
+
+        bit_storage& operator=(bit_storage&& other) {
+            m_columns = std::move(other.m_columns);
+            m_size    = std::exchange(other.m_size, 0);
+            return *this;
+        }
+
+        ~bit_storage() = default;
+
+        [[nodiscard]] Allocator get_allocator() const { return Allocator(m_columns[0].get_allocator()); }
+
+        [[nodiscard]] std::size_t size() const { return m_size; }
+
+        [[nodiscard]] std::size_t capacity() const { return m_columns[0].capacity() * bit_word_bits; }
+
+        template <std::size_t I> bit_pointer<bit_word> data() { return { m_columns[I].data(), 0 }; }
+
+        template <std::size_t I> bit_pointer<const bit_word> data() const { return { m_columns[I].data(), 0 }; }
+
+        void clear() { truncate(0); }
+
+        void swap(bit_storage& other) {
+            for (std::size_t i = 0; i < Count; ++i) {
+                m_columns[i].swap(other.m_columns[i]);
+            }
+            std::swap(m_size, other.m_size);
+        }
+
+        void truncate(std::size_t size) {
+            assert(size <= m_size);
+
+            const std::size_t tail = size % bit_word_bits;
+            for (auto& column : m_columns) {
+                column.truncate(bit_word_count(size));
+                if (tail != 0) {
+                    column.at(column.size() - 1) &= (bit_word { 1 } << tail) - 1;
+                }
+            }
+            m_size = size;
+        }
+
+        void resize(std::size_t size) {
+            if (size <= m_size) {
+                truncate(size);
+                return;
+            }
+
+            for (auto& column : m_columns) {
+                column.resize(bit_word_count(size), 0);
+            }
+            m_size = size;
+        }
+
+        template <typename Value> void resize(std::size_t size, const Value& value) {
+            const std::size_t old_size = m_size;
+            resize(size);
+            fill_all(old_size, value, helper_seq);
+        }
+
+        void reserve(std::size_t size) {
+            for (auto& column : m_columns) {
+                column.reserve(bit_word_count(size));
+            }
+        }
+
+        void shrink_to_fit() {
+            for (auto& column : m_columns) {
+                column.shrink_to_fit();
+            }
+        }
+
+        void pop_back() {
+            assert(m_size > 0);
+            truncate(m_size - 1);
+        }
+
+        template <typename Value> void push_back(Value&& value) {
+            if (m_size % bit_word_bits == 0) {
+                for (auto& column : m_columns) {
+                    column.push_back(0);
+                }
+            }
+
+            set_all(m_size, value, helper_seq);
+            m_size += 1;
+        }
+
+        void erase(std::size_t pos) {
+            assert(pos < m_size);
+
+            const std::size_t first  = pos / bit_word_bits;
+            const std::size_t last   = bit_word_count(m_size) - 1;
+            const bit_word keep_mask = (bit_word { 1 } << (pos % bit_word_bits)) - 1;
+
+            for (auto& column : m_columns) {
+                bit_word* words = column.data();
+
+                words[first] = (words[first] & keep_mask) | ((words[first] >> 1) & ~keep_mask);
+                for (std::size_t i = first; i < last; ++i) {
+                    words[i] |= words[i + 1] << (bit_word_bits - 1);
+                    words[i + 1] >>= 1;
+                }
+            }
+
+            truncate(m_size - 1);
+        }
+
+        /**
+         * @brief Inserts rows whose bits are set by a function.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted row.
+         * @param count The number of inserted rows.
+         * @param init The function called with the column index and a bit pointer to the gap of the column.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            assert(pos <= m_size);
+
+            const std::size_t old_size = m_size;
+            resize(m_size + count);
+            insert_rows_impl(pos, count, old_size, init, helper_seq);
+        }
+
+    private:
+        static constexpr auto helper_seq = std::make_index_sequence<Count>();
+
+        template <typename Init, std::size_t... I>
+        void insert_rows_impl(
+            std::size_t pos, std::size_t count, std::size_t old_size, Init& init, std::index_sequence<I...> /*unused*/
+        ) {
+            ((std::copy_backward(data<I>() + pos, data<I>() + old_size, data<I>() + old_size + count),
+              init(std::integral_constant<std::size_t, I>(), data<I>() + pos)),
+             ...);
+        }
+
+        std::array<column_t, Count> m_columns;
+        std::size_t m_size = 0;
+
+        template <std::size_t... I>
+        static std::array<column_t, Count> make_columns(const Allocator& alloc, std::index_sequence<I...> /*unused*/) {
+            return { ((void)I, column_t(word_allocator_t(alloc)))... };
+        }
+
+        template <typename Value, std::size_t... I>
+        void set_all(std::size_t pos, const Value& value, std::index_sequence<I...> /*unused*/) {
+            ((data<I>()[static_cast<std::ptrdiff_t>(pos)] = static_cast<bool>(std::get<I>(value))), ...);
+        }
+
+        template <typename Value, std::size_t... I>
+        void fill_all(std::size_t from, const Value& value, std::index_sequence<I...> /*unused*/) {
+            for (std::size_t pos = from; pos < m_size; ++pos) {
+                set_all(pos, value, std::index_sequence<I...>());
+            }
+        }
+    };
+
+    /**
+     * @brief Storage without columns used when every column of a multi_vector is packed.
+     *
+     * @tparam Allocator The allocator type.
+     */
+    template <typename Allocator> class empty_storage {
+    public:
+        using value_t        = std::tuple<>;
+        using allocator_type = Allocator;
+
+        empty_storage() = default;
+
+        explicit empty_storage(const Allocator& /*unused*/) { }
+
+        explicit empty_storage(std::size_t /*unused*/, const Allocator& /*unused*/ = Allocator()) { }
+
+        empty_storage(std::size_t /*unused*/, const value_t& /*unused*/, const Allocator& /*unused*/ = Allocator()) { }
+
+        [[nodiscard]] std::size_t capacity() const { return std::numeric_limits<std::size_t>::max(); }
+
+        void clear() { }
+
+        void swap(empty_storage& /*unused*/) { }
+
+        void truncate(std::size_t /*unused*/) { }
+
+        void resize(std::size_t /*unused*/) { }
+
+        void resize(std::size_t /*unused*/, const value_t& /*unused*/) { }
+
+        void reserve(std::size_t /*unused*/) { }
+
+        void shrink_to_fit() { }
+
+        void pop_back() { }
+
+        template <typename Value> void push_back(Value&& /*unused*/) { }
+
+        void erase(std::size_t /*unused*/) { }
+
+        template <typename Init> void insert_rows(std::size_t /*unused*/, std::size_t /*unused*/, Init&& /*unused*/) { }
+    };
+
+    /**
+     * @brief Storage splitting the columns of a multi_vector into packed bool columns and columns stored by a layout.
+     *
+     * @tparam Layout The layout storing the columns which are not packed.
+     * @tparam Types The types of the columns, `packed_bool` for a packed column.
+     */
+    template <typename Layout, typename... Types> class packed_storage {
+    private:
+        using types_tuple = std::tuple<Types...>;
+
+        static constexpr std::array<bool, sizeof...(Types)> packed = { std::is_same_v<Types, packed_bool>... };
+
+        static constexpr std::size_t bit_count   = std::count(packed.begin(), packed.end(), true);
+        static constexpr std::size_t inner_count = sizeof...(Types) - bit_count;
+
+        /**
+         * @brief Returns the positions of the packed or of the other columns.
+         *
+         * @tparam Packed Whether to return the positions of the packed columns.
+         * @tparam N The number of the columns.
+         * @return The positions.
+         */
+        template <bool Packed, std::size_t N> static consteval std::array<std::size_t, N> positions() {
+            std::array<std::size_t, N> result {};
+
+            std::size_t next = 0;
+            for (std::size_t i = 0; i < packed.size(); ++i) {
+                if (packed[i] == Packed) {
+                    result[next++] = i;
+                }
+            }
+            return result;
+        }
+
+        static constexpr auto inner_positions = positions<false, inner_count>();
+        static constexpr auto bit_positions   = positions<true, bit_count>();
+
+        /**
+         * @brief Maps a column to its index in the bit or the layout storage.
+         *
+         * @tparam I The index of the column.
+         * @return The index in the storage holding the column.
+         */
+        template <std::size_t I> static consteval std::size_t local_index() {
+            return static_cast<std::size_t>(std::count(packed.begin(), packed.begin() + I, packed[I]));
+        }
+
+        template <std::size_t... K>
+        static auto make_inner(std::index_sequence<K...> /*unused*/)
+            -> Layout::template storage<std::tuple_element_t<inner_positions[K], types_tuple>...>;
+
+        using allocator_t = Layout::allocator_type;
+        using inner_t     = std::conditional_t<
+            inner_count == 0,
+            empty_storage<allocator_t>,
+            decltype(make_inner(std::make_index_sequence<inner_count>()))>;
+        using bits_t = bit_storage<allocator_t, bit_count>;
+
+        static constexpr auto inner_seq = std::make_index_sequence<inner_count>();
+        static constexpr auto bit_seq   = std::make_index_sequence<bit_count>();
+
+    public:
+        using allocator_type = allocator_t;
+
+        packed_storage() = default;
+
+        /**
+         * @brief Constructs an empty storage using an allocator.
+         *
+         * @param alloc The allocator.
+         */
+        explicit packed_storage(const allocator_type& alloc)
+            : m_inner(alloc)
+            , m_bits(alloc) { }
+
+        /**
+         * @brief Constructs a storage with a specified size and default-initialized elements.
+         *
+         * @param count The number of elements.
+         * @param alloc The allocator.
+         */
+        explicit packed_storage(std::size_t count, const allocator_type& alloc = allocator_type())
+            : m_inner(count, alloc)
+            , m_bits(alloc) {
+            m_bits.resize(count);
+        }
+
+        /**
+         * @brief Constructs a storage with a specified size and initial value.
+         *
+         * @tparam Value The type of the value.
+         * @param count The number of elements.
+         * @param value The initial value for the elements.
+         * @param alloc The allocator.
+         */
+        template <typename Value>
+        packed_storage(std::size_t count, const Value& value, const allocator_type& alloc = allocator_type())
+            : m_inner(count, inner_values(value, inner_seq), alloc)
+            , m_bits(alloc) {
+            m_bits.resize(count, bit_values(value, bit_seq));
+        }
+
+        [[nodiscard]] allocator_type get_allocator() const { return m_bits.get_allocator(); }
+
+        [[nodiscard]] std::size_t size() const { return m_bits.size(); }
+
+        [[nodiscard]] std::size_t capacity() const { return std::min(m_inner.capacity(), m_bits.capacity()); }
+
+        /**
+         * @brief Returns a pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Pointer to the first element, a `bit_pointer` for a packed column.
+         */
+        template <std::size_t I> auto data() {
+            if constexpr (packed[I]) {
+                return m_bits.template data<local_index<I>()>();
+            } else {
+                return m_inner.template data<local_index<I>()>();
+            }
+        }
+
+        /**
+         * @brief Returns a const pointer to the first element of a column.
+         *
+         * @tparam I The index of the column.
+         * @return Const pointer to the first element, a `bit_pointer` for a packed column.
+         */
+        template <std::size_t I> auto data() const {
+            if constexpr (packed[I]) {
+                return m_bits.template data<local_index<I>()>();
+            } else {
+                return m_inner.template data<local_index<I>()>();
+            }
+        }
+
+        void clear() {
+            m_inner.clear();
+            m_bits.clear();
+        }
+
+        void swap(packed_storage& other) {
+            m_inner.swap(other.m_inner);
+            m_bits.swap(other.m_bits);
+        }
+
+        void truncate(std::size_t size) {
+            m_inner.truncate(size);
+            m_bits.truncate(size);
+        }
+
+        void resize(std::size_t size) {
+            m_inner.resize(size);
+            m_bits.resize(size);
+        }
+
+        template <typename Value> void resize(std::size_t size, const Value& value) {
+            m_inner.resize(size, inner_values(value, inner_seq));
+            m_bits.resize(size, bit_values(value, bit_seq));
+        }
+
+        void reserve(std::size_t size) {
+            m_inner.reserve(size);
+            m_bits.reserve(size);
+        }
+
+        void shrink_to_fit() {
+            m_inner.shrink_to_fit();
+            m_bits.shrink_to_fit();
+        }
+
+        void pop_back() {
+            m_inner.pop_back();
+            m_bits.pop_back();
+        }
+
+        template <typename Value> void push_back(Value&& value) {
+            m_inner.push_back(forward_inner(std::forward<decltype(value)>(value), inner_seq));
+            m_bits.push_back(bit_values(value, bit_seq));
+        }
+
+        template <typename... Args> void emplace_back(Args&&... args) {
+            push_back(std::forward_as_tuple(std::forward<decltype(args)>(args)...));
+        }
+
+        void erase(std::size_t pos) {
+            m_inner.erase(pos);
+            m_bits.erase(pos);
+        }
+
+        /**
+         * @brief Inserts rows whose columns are constructed by a function.
+         *
+         * @tparam Init The type of the function.
+         * @param pos The position of the first inserted row.
+         * @param count The number of inserted rows.
+         * @param init The function called with the column index and a pointer to the gap of the column.
+         */
+        template <typename Init> void insert_rows(std::size_t pos, std::size_t count, Init&& init) {
+            m_inner.insert_rows(pos, count, [&](auto index, auto gap) {
+                init(std::integral_constant<std::size_t, inner_positions[index]>(), gap);
+            });
+            m_bits.insert_rows(pos, count, [&](auto index, auto gap) {
+                init(std::integral_constant<std::size_t, bit_positions[index]>(), gap);
+            });
+        }
+
+    private:
+        inner_t m_inner;
+        bits_t m_bits;
+
+        template <typename Value, std::size_t... K>
+        static typename inner_t::value_t inner_values(const Value& value, std::index_sequence<K...> /*unused*/) {
+            return typename inner_t::value_t(std::get<inner_positions[K]>(value)...);
+        }
+
+        template <typename Value, std::size_t... K>
+        static auto forward_inner(Value&& value, std::index_sequence<K...> /*unused*/) {
+            return std::forward_as_tuple(std::get<inner_positions[K]>(std::forward<decltype(value)>(value))...);
+        }
+
+        template <typename Value, std::size_t... K>
+        static auto bit_values(const Value& value, std::index_sequence<K...> /*unused*/) {
+            return std::array<bool, bit_count> { static_cast<bool>(std::get<bit_positions[K]>(value))... };
+        }
+    };
+
+}
+
+/**
+ * @brief Layout storing every column of a multi_vector in its own allocation.
+ *
+ * @tparam Allocator The allocator type, rebound for every column.
+ */
+template <typename Allocator = std::allocator<std::byte>> struct basic_column_layout {
+    using allocator_type = Allocator;
+
+    template <typename... Types> using storage = detail::column_storage<Allocator, Types...>;
+};
+
+using column_layout = basic_column_layout<>;
+
+/**
+ * @brief Layout storing all columns of a multi_vector in a single allocation.
+ *
+ * Every column starts on a cache line, so a growth step costs one allocation regardless of the number of columns.
+ *
+ * @tparam Allocator The allocator type, rebound to cache lines.
+ */
+template <typename Allocator = std::allocator<std::byte>> struct basic_block_layout {
+    using allocator_type = Allocator;
+
+    template <typename... Types> using storage = detail::block_storage<Allocator, Types...>;
+};
+
+using block_layout = basic_block_layout<>;
+
+/**
+ * @brief Layout storing up to `N` rows of a multi_vector inline in the object.
+ *
+ * Beyond `N` rows every column is moved to its own allocation, and it moves back when shrunk to at most `N` rows.
+ *
+ * @tparam N The number of inline rows.
+ * @tparam Allocator The allocator type, rebound for every column.
+ */
+template <std::size_t N, typename Allocator = std::allocator<std::byte>> struct basic_small_layout {
+    using allocator_type = Allocator;
+
+    template <typename... Types> using storage = detail::small_storage<N, Allocator, Types...>;
+};
+
+template <std::size_t N> using small_layout = basic_small_layout<N>;
+
+/**
+ * @brief Concept to check if a type is a valid multi_vector layout.
+ *
+ * @tparam T The type to check.
+ */
+template <typename T>
+concept is_multi_vector_layout = requires() {
+    typename T::allocator_type;
+    typename T::template storage<int>;
+    typename T::template storage<int, int>;
+};
+
+}
+
+#endif
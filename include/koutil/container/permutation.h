@@ -0,0 +1,247 @@
+#ifndef KOUTIL_CONTAINER_PERMUTATION_H
+#define KOUTIL_CONTAINER_PERMUTATION_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container::detail {
+
+/**
+ * @brief Unsigned integer with the same size as a type.
+ *
+ * @tparam T The type.
+ */
+template <typename T>
+using radix_bits_t = std::conditional_t<
+    sizeof(T) == 1,
+    std::uint8_t,
+    std::conditional_t<
+        sizeof(T) == 2,
+        std::uint16_t,
+        std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>>>;
+
+/**
+ * @brief Checks if keys of a type compared with a comparator can be sorted with the radix sort.
+ *
+ * @tparam Key The key type.
+ * @tparam Compare The comparator type.
+ */
+template <typename Key, typename Compare>
+inline constexpr bool is_radix_sortable_v = std::is_arithmetic_v<Key> && !std::is_same_v<Key, bool>
+    && (sizeof(Key) <= sizeof(std::uint64_t))
+    && (std::is_same_v<Compare, std::less<>> || std::is_same_v<Compare, std::less<Key>>);
+
+/**
+ * @brief Maps a key to an unsigned integer with the same ordering.
+ *
+ * @tparam Key The key type.
+ * @param key The key.
+ * @return The unsigned integer.
+ */
+template <typename Key> constexpr radix_bits_t<Key> radix_key(Key key) {
+    using bits_t = radix_bits_t<Key>;
+
+    constexpr bits_t sign_bit = bits_t { 1 } << (sizeof(Key) * 8 - 1);
+
+    if constexpr (std::is_floating_point_v<Key>) {
+        auto bits = std::bit_cast<bits_t>(key);
+
+        // -0.0 and +0.0 compare equal, so both map to the key of +0.0
+        if (bits == sign_bit) {
+            bits = 0;
+        }
+
+        // negative numbers are ordered in reverse
+        return ((bits & sign_bit) != 0) ? static_cast<bits_t>(~bits) : static_cast<bits_t>(bits | sign_bit);
+    } else if constexpr (std::is_signed_v<Key>) {
+        return static_cast<bits_t>(static_cast<bits_t>(key) ^ sign_bit);
+    } else {
+        return static_cast<bits_t>(key);
+    }
+}
+
+/**
+ * @brief Computes the stable sorting permutation of keys with an LSD radix sort.
+ *
+ * Passes in which every key has the same digit are skipped.
+ *
+ * @tparam Key The key type.
+ * @param keys Pointer to the first key.
+ * @param count The number of keys.
+ * @return The permutation, where `perm[i]` is the index of the key placed at position `i`.
+ */
+template <typename Key> std::vector<std::size_t> radix_sort_permutation(const Key* keys, std::size_t count) {
+    using bits_t = radix_bits_t<Key>;
+
+    constexpr std::size_t digit_bits = 8;
+    constexpr std::size_t radix      = std::size_t { 1 } << digit_bits;
+    constexpr std::size_t passes     = sizeof(Key);
+
+    struct entry {
+        bits_t key;
+        std::size_t index;
+    };
+
+    std::vector<entry> current(count);
+    std::vector<entry> next(count);
+
+    std::array<std::array<std::size_t, radix>, passes> histograms {};
+
+    for (std::size_t i = 0; i < count; ++i) {
+        const bits_t key = radix_key(keys[i]);
+        current[i]       = { key, i };
+
+        for (std::size_t pass = 0; pass < passes; ++pass) {
+            histograms[pass][(key >> (pass * digit_bits)) & (radix - 1)] += 1;
+        }
+    }
+
+    for (std::size_t pass = 0; pass < passes; ++pass) {
+        auto& histogram = histograms[pass];
+
+        if (std::ranges::find(histogram, count) != histogram.end()) {
+            continue;
+        }
+
+        std::exclusive_scan(histogram.begin(), histogram.end(), histogram.begin(), std::size_t { 0 });
+
+        for (const entry& item : current) {
+            const std::size_t digit = (item.key >> (pass * digit_bits)) & (radix - 1);
+            next[histogram[digit]]  = item;
+            histogram[digit] += 1;
+        }
+
+        current.swap(next);
+    }
+
+    std::vector<std::size_t> permutation(count);
+    std::ranges::transform(current, permutation.begin(), &entry::index);
+
+    return permutation;
+}
+
+/**
+ * @brief Computes the permutation sorting keys.
+ *
+ * Arithmetic keys compared with `std::less` are sorted with a radix sort, which is stable, other keys are sorted with
+ * a comparison sort.
+ *
+ * @tparam Stable Whether equal keys must keep their relative order.
+ * @tparam Keys The pointer type of the keys.
+ * @tparam Compare The comparator type.
+ * @param keys Pointer to the first key.
+ * @param count The number of keys.
+ * @param cmp The comparator.
+ * @return The permutation, where `perm[i]` is the index of the key placed at position `i`.
+ */
+template <bool Stable, typename Keys, typename Compare>
+std::vector<std::size_t> sort_permutation(Keys keys, std::size_t count, Compare cmp) {
+    constexpr std::size_t radix_threshold = 256;
+
+    using key_t = std::iter_value_t<Keys>;
+
+    if constexpr (std::is_pointer_v<Keys> && is_radix_sortable_v<key_t, Compare>) {
+        if (count >= radix_threshold) {
+            return radix_sort_permutation(keys, count);
+        }
+    }
+
+    std::vector<std::size_t> permutation(count);
+    std::iota(permutation.begin(), permutation.end(), std::size_t { 0 });
+
+    const auto by_key = [&](std::size_t lhs, std::size_t rhs) {
+        return cmp(static_cast<const key_t&>(keys[lhs]), static_cast<const key_t&>(keys[rhs]));
+    };
+
+    if constexpr (Stable) {
+        std::ranges::stable_sort(permutation, by_key);
+    } else {
+        std::ranges::sort(permutation, by_key);
+    }
+
+    return permutation;
+}
+
+/**
+ * @brief Uninitialized buffer which destroys its constructed elements and releases its memory on scope exit.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Allocator The allocator type, rebound to `T`.
+ */
+template <typename T, typename Allocator> class scratch_buffer {
+public:
+    using allocator_t      = std::allocator_traits<Allocator>::template rebind_alloc<T>;
+    using allocator_traits = std::allocator_traits<allocator_t>;
+
+    scratch_buffer(std::size_t capacity, const Allocator& alloc)
+        : m_alloc(alloc)
+        , m_data(allocator_traits::allocate(m_alloc, capacity))
+        , m_capacity(capacity) { }
+
+    scratch_buffer(const scratch_buffer&)            = delete;
+    scratch_buffer& operator=(const scratch_buffer&) = delete;
+
+    ~scratch_buffer() {
+        std::destroy_n(m_data, m_size);
+        allocator_traits::deallocate(m_alloc, m_data, m_capacity);
+    }
+
+    /**
+     * @brief Constructs an element at the end of the buffer.
+     *
+     * @param args The arguments of the constructor.
+     */
+    template <typename... Args> void emplace_back(Args&&... args) {
+        std::construct_at(m_data + m_size, std::forward<decltype(args)>(args)...);
+        ++m_size;
+    }
+
+    [[nodiscard]] T* data() { return m_data; }
+
+private:
+    allocator_t m_alloc;
+    T* m_data;
+    std::size_t m_capacity;
+    std::size_t m_size = 0;
+};
+
+/**
+ * @brief Reorders elements so that `data[i]` becomes the former `data[permutation[i]]`.
+ *
+ * The elements are gathered into a temporary buffer from the allocator in one pass and moved back. If a move throws,
+ * the buffer is destroyed and released, and the moved-from elements are left in a valid but unspecified state.
+ *
+ * @tparam T The type of the elements.
+ * @tparam Allocator The allocator type, rebound to `T`.
+ * @param data Pointer to the first element.
+ * @param permutation The permutation.
+ * @param alloc The allocator of the temporary buffer.
+ */
+template <typename T, typename Allocator>
+void apply_permutation(T* data, const std::vector<std::size_t>& permutation, const Allocator& alloc) {
+    const std::size_t count = permutation.size();
+    if (count == 0) {
+        return;
+    }
+
+    scratch_buffer<T, Allocator> buffer(count, alloc);
+    for (std::size_t i = 0; i < count; ++i) {
+        buffer.emplace_back(std::move(data[permutation[i]]));
+    }
+
+    std::move(buffer.data(), buffer.data() + count, data);
+}
+
+}
+
+#endif
@@ -0,0 +1,554 @@
+#ifndef KOUTIL_CONTAINER_SEGMENTED_MULTI_VECTOR_H
+#define KOUTIL_CONTAINER_SEGMENTED_MULTI_VECTOR_H
+
+#include "koutil/container/indexed_row_iterator.h"
+#include "koutil/container/multi_vector.h"
+#include "koutil/container/multi_vector_storage.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Default number of rows in a chunk of a segmented_multi_vector.
+ */
+inline constexpr std::size_t default_chunk_size = 65536;
+
+/**
+ * @brief Class representing a multi_vector whose columns are stored in fixed-size chunks.
+ *
+ * Every chunk is one allocation holding `ChunkSize` rows of all columns and the chunks are indexed by a chunk table.
+ * Growing never moves existing elements, so references stay valid until the element is removed.
+ *
+ * @tparam ChunkSize The number of rows in a chunk, a power of two.
+ * @tparam Allocator The allocator type, rebound to cache lines.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t ChunkSize, typename Allocator, is_multi_vector_element... Types>
+    requires(std::has_single_bit(ChunkSize) && sizeof...(Types) != 0 && (!std::is_void_v<Types> && ...))
+class basic_segmented_multi_vector {
+private:
+    static constexpr std::size_t column_count = sizeof...(Types);
+
+    static constexpr std::size_t alignment = std::max({ detail::cache_line_size, alignof(Types)... });
+
+    static_assert(ChunkSize % alignment == 0, "Every column of a chunk must start on a cache line");
+
+    static constexpr std::array<std::size_t, column_count + 1> column_offsets = [] {
+        constexpr std::array<std::size_t, column_count> sizes = { sizeof(Types)... };
+
+        std::array<std::size_t, column_count + 1> offsets {};
+        std::partial_sum(sizes.begin(), sizes.end(), offsets.begin() + 1);
+        return offsets;
+    }();
+
+    static constexpr std::size_t chunk_lines = ChunkSize * column_offsets[column_count] / alignment;
+
+    static constexpr std::size_t chunk_shift = std::countr_zero(ChunkSize);
+
+    struct alignas(alignment) line {
+        std::byte bytes[alignment];
+    };
+
+    using allocator_t      = std::allocator_traits<Allocator>::template rebind_alloc<line>;
+    using allocator_traits = std::allocator_traits<allocator_t>;
+    using chunk_table_t    = std::vector<line*, typename allocator_traits::template rebind_alloc<line*>>;
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+public:
+    using allocator_type = Allocator;
+
+    using value_ref_t       = std::tuple<Types&...>;
+    using const_value_ref_t = std::tuple<const Types&...>;
+    using value_t           = std::tuple<Types...>;
+
+    using iterator_t       = indexed_row_iterator<basic_segmented_multi_vector>;
+    using const_iterator_t = indexed_row_iterator<const basic_segmented_multi_vector>;
+
+    /**
+     * @brief The number of rows in a chunk.
+     */
+    static constexpr std::size_t chunk_size = ChunkSize;
+
+    basic_segmented_multi_vector() = default;
+
+    /**
+     * @brief Constructs an empty multi_vector using an allocator.
+     *
+     * @param alloc The allocator used by the chunks.
+     */
+    explicit basic_segmented_multi_vector(const allocator_type& alloc)
+        : m_alloc(alloc)
+        , m_chunks(m_alloc) { }
+
+    basic_segmented_multi_vector(const basic_segmented_multi_vector& other)
+        : m_alloc(allocator_traits::select_on_container_copy_construction(other.m_alloc))
+        , m_chunks(m_alloc) {
+        copy_from(other);
+    }
+
+    basic_segmented_multi_vector(basic_segmented_multi_vector&& other)
+        : m_alloc(std::move(other.m_alloc))
+        , m_chunks(std::move(other.m_chunks))
+        , m_size(other.m_size) {
+        other.m_chunks.clear();
+        other.m_size = 0;
+    }
+
+    ~basic_segmented_multi_vector() { release(); }
+
+    basic_segmented_multi_vector& operator=(const basic_segmented_multi_vector& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        clear();
+
+        if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+            if (m_alloc != other.m_alloc) {
+                // the chunks have to be returned to the allocator which allocated them
+                release();
+            }
+            m_alloc = other.m_alloc;
+        }
+
+        copy_from(other);
+        return *this;
+    }
+
+    basic_segmented_multi_vector& operator=(basic_segmented_multi_vector&& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        if constexpr (!allocator_traits::propagate_on_container_move_assignment::value) {
+            if (m_alloc != other.m_alloc) {
+                // the chunks cannot be adopted, so the elements are moved one by one
+                clear();
+                for (auto&& row : other) {
+                    std::apply([this](Types&... values) { emplace_back(std::move(values)...); }, row);
+                }
+                other.clear();
+                return *this;
+            }
+        }
+
+        release();
+
+        if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+            m_alloc = std::move(other.m_alloc);
+        }
+
+        m_chunks = std::move(other.m_chunks);
+        m_size   = other.m_size;
+
+        other.m_chunks.clear();
+        other.m_size = 0;
+
+        return *this;
+    }
+
+    /**
+     * @brief Returns the allocator used by the chunks.
+     *
+     * @return The allocator.
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return allocator_type(m_alloc); }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Checks if the multi_vector is empty.
+     *
+     * @return True if the multi_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the number of elements that can be held without allocating a chunk.
+     *
+     * @return The capacity.
+     */
+    [[nodiscard]] std::size_t capacity() const { return m_chunks.size() * ChunkSize; }
+
+    /**
+     * @brief Returns the number of chunks holding at least one element.
+     *
+     * @return The number of chunks.
+     */
+    [[nodiscard]] std::size_t chunk_count() const { return (m_size + ChunkSize - 1) >> chunk_shift; }
+
+    /**
+     * @brief Returns the elements of a column stored in a chunk.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The span over the elements, shorter than `chunk_size` only for the last chunk.
+     */
+    template <std::size_t I> std::span<element_t<I>> chunk(std::size_t chunk) {
+        assert(chunk < chunk_count());
+        return std::span<element_t<I>>(column<I>(m_chunks[chunk]), chunk_rows(chunk));
+    }
+
+    /**
+     * @brief Returns the elements of a column stored in a chunk.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The span over the elements, shorter than `chunk_size` only for the last chunk.
+     */
+    template <std::size_t I> std::span<const element_t<I>> chunk(std::size_t chunk) const {
+        assert(chunk < chunk_count());
+        return std::span<const element_t<I>>(column<I>(m_chunks[chunk]), chunk_rows(chunk));
+    }
+
+    /**
+     * @brief Returns a reference to the first element.
+     *
+     * @return Reference to the first element.
+     */
+    value_ref_t front() {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a const reference to the first element.
+     *
+     * @return Const reference to the first element.
+     */
+    const_value_ref_t front() const {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a reference to the last element.
+     *
+     * @return Reference to the last element.
+     */
+    value_ref_t back() {
+        assert(!empty());
+        return at(m_size - 1);
+    }
+
+    /**
+     * @brief Returns a const reference to the last element.
+     *
+     * @return Const reference to the last element.
+     */
+    const_value_ref_t back() const {
+        assert(!empty());
+        return at(m_size - 1);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t at(std::size_t pos) {
+        assert(pos < m_size);
+        return get_all<value_ref_t>(m_chunks[pos >> chunk_shift], pos & (ChunkSize - 1), helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t at(std::size_t pos) const {
+        assert(pos < m_size);
+        return get_all<const_value_ref_t>(m_chunks[pos >> chunk_shift], pos & (ChunkSize - 1), helper_seq);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Destroys all elements and keeps the chunks for reuse.
+     */
+    void clear() { truncate(0); }
+
+    /**
+     * @brief Swaps the contents of two multi_vectors.
+     *
+     * @param other The other multi_vector.
+     */
+    void swap(basic_segmented_multi_vector& other) {
+        if constexpr (allocator_traits::propagate_on_container_swap::value) {
+            std::swap(m_alloc, other.m_alloc);
+        } else {
+            assert(m_alloc == other.m_alloc);
+        }
+
+        m_chunks.swap(other.m_chunks);
+        std::swap(m_size, other.m_size);
+    }
+
+    /**
+     * @brief Allocates chunks for a specified number of elements.
+     *
+     * @param size The number of elements.
+     */
+    void reserve(std::size_t size) {
+        const std::size_t chunks = (size + ChunkSize - 1) >> chunk_shift;
+
+        m_chunks.reserve(chunks);
+        while (m_chunks.size() < chunks) {
+            m_chunks.push_back(allocator_traits::allocate(m_alloc, chunk_lines));
+        }
+    }
+
+    /**
+     * @brief Frees the chunks which do not hold any element.
+     */
+    void shrink_to_fit() {
+        const std::size_t used = chunk_count();
+        for (std::size_t i = used; i < m_chunks.size(); ++i) {
+            allocator_traits::deallocate(m_alloc, m_chunks[i], chunk_lines);
+        }
+
+        m_chunks.resize(used);
+        m_chunks.shrink_to_fit();
+    }
+
+    /**
+     * @brief Removes the last element.
+     */
+    void pop_back() {
+        assert(!empty());
+        truncate(m_size - 1);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @tparam Args The types of the arguments.
+     * @param args The arguments to construct the new element.
+     * @return A tuple of references to the newly added elements.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == column_count)
+    value_ref_t emplace_back(Args&&... args) {
+        line* block = next_slot();
+        emplace_back_impl(block, m_size & (ChunkSize - 1), helper_seq, std::forward<decltype(args)>(args)...);
+        m_size += 1;
+
+        return back();
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(const value_t& value) {
+        std::apply([this](const Types&... values) { emplace_back(values...); }, value);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(value_t&& value) {
+        std::apply([this](Types&... values) { emplace_back(std::move(values)...); }, value);
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning of the multi_vector.
+     *
+     * @return An iterator to the beginning of the multi_vector.
+     */
+    iterator_t begin() { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t begin() const { return const_iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t cbegin() const { return begin(); }
+
+    /**
+     * @brief Returns an iterator to the end of the multi_vector.
+     *
+     * @return An iterator to the end of the multi_vector.
+     */
+    iterator_t end() { return iterator_t(this, m_size); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t end() const { return const_iterator_t(this, m_size); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t cend() const { return end(); }
+
+private:
+    [[no_unique_address]] allocator_t m_alloc;
+    chunk_table_t m_chunks { m_alloc };
+    std::size_t m_size = 0;
+
+    template <std::size_t I> static element_t<I>* column(line* block) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<element_t<I>*>(reinterpret_cast<std::byte*>(block) + ChunkSize * column_offsets[I]);
+    }
+
+    template <std::size_t I> static const element_t<I>* column(const line* block) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<const element_t<I>*>(
+            reinterpret_cast<const std::byte*>(block) + ChunkSize * column_offsets[I]
+        );
+    }
+
+    [[nodiscard]] std::size_t chunk_rows(std::size_t chunk) const {
+        return std::min(ChunkSize, m_size - (chunk << chunk_shift));
+    }
+
+    /**
+     * @brief Returns the chunk of the next element, allocating it if needed.
+     *
+     * @return The chunk.
+     */
+    line* next_slot() {
+        const std::size_t chunk = m_size >> chunk_shift;
+        if (chunk == m_chunks.size()) {
+            m_chunks.push_back(allocator_traits::allocate(m_alloc, chunk_lines));
+        }
+
+        return m_chunks[chunk];
+    }
+
+    /**
+     * @brief Destroys the elements past a specified size.
+     *
+     * @param size The new size.
+     */
+    void truncate(std::size_t size) {
+        assert(size <= m_size);
+
+        for (std::size_t chunk = size >> chunk_shift; chunk < chunk_count(); ++chunk) {
+            const std::size_t first = std::max(size, chunk << chunk_shift) - (chunk << chunk_shift);
+            destroy_range(m_chunks[chunk], first, chunk_rows(chunk), helper_seq);
+        }
+
+        m_size = size;
+    }
+
+    /**
+     * @brief Destroys all elements and frees all chunks.
+     */
+    void release() {
+        truncate(0);
+        for (line* block : m_chunks) {
+            allocator_traits::deallocate(m_alloc, block, chunk_lines);
+        }
+        m_chunks.clear();
+    }
+
+    void copy_from(const basic_segmented_multi_vector& other) {
+        assert(m_size == 0);
+
+        reserve(other.m_size);
+        for (std::size_t chunk = 0; chunk < other.chunk_count(); ++chunk) {
+            copy_chunk(m_chunks[chunk], other.m_chunks[chunk], other.chunk_rows(chunk), helper_seq);
+        }
+        m_size = other.m_size;
+    }
+
+    template <typename Ref, typename Line, std::size_t... I>
+    static Ref get_all(Line* block, std::size_t offset, std::index_sequence<I...> /*unused*/) {
+        return Ref { column<I>(block)[offset]... };
+    }
+
+    template <std::size_t... I>
+    static void copy_chunk(line* to, const line* from, std::size_t count, std::index_sequence<I...> /*unused*/) {
+        (std::uninitialized_copy_n(column<I>(from), count, column<I>(to)), ...);
+    }
+
+    template <std::size_t... I>
+    static void destroy_range(line* block, std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+        (std::destroy(column<I>(block) + from, column<I>(block) + to), ...);
+    }
+
+    template <typename... Args, std::size_t... I>
+    static void
+    emplace_back_impl(line* block, std::size_t offset, std::index_sequence<I...> /*unused*/, Args&&... args) {
+        (std::construct_at(column<I>(block) + offset, std::forward<decltype(args)>(args)), ...);
+    }
+};
+
+/**
+ * @brief Alias for a segmented multi_vector with the default chunk size and allocator.
+ *
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <is_multi_vector_element... Types>
+using segmented_multi_vector = basic_segmented_multi_vector<default_chunk_size, std::allocator<std::byte>, Types...>;
+
+namespace pmr {
+
+    /**
+     * @brief segmented_multi_vector using a polymorphic allocator.
+     *
+     * @tparam Types The types of elements stored in the multi_vector.
+     */
+    template <is_multi_vector_element... Types>
+    using segmented_multi_vector = basic_segmented_multi_vector<
+        default_chunk_size,
+        std::pmr::polymorphic_allocator<std::byte>,
+        Types...>;
+
+}
+
+}
+
+#endif
@@ -0,0 +1,313 @@
+#ifndef KOUTIL_CONTAINER_SLOT_MAP_H
+#define KOUTIL_CONTAINER_SLOT_MAP_H
+
+#include "koutil/container/multi_vector.h"
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Stable handle to a row of a slot_map.
+ *
+ * A handle stays valid until its row is erased, after that it never refers to another row.
+ */
+struct slot_handle {
+    std::uint32_t index;
+    std::uint32_t generation;
+
+    bool operator==(const slot_handle&) const = default;
+};
+
+/**
+ * @brief Class storing rows in a dense multi_vector addressed by stable handles.
+ *
+ * Handles index a sparse array of slots which point to the dense rows. Every slot has a generation counter which is
+ * incremented when its row is erased, so stale handles are detected. Erasing moves the last row into the gap, the
+ * dense columns never have holes and are iterated directly.
+ *
+ * @tparam Layout The storage layout of the dense columns.
+ * @tparam Types The types of elements stored in the slot_map.
+ */
+template <is_multi_vector_layout Layout, is_multi_vector_element... Types> class basic_slot_map {
+public:
+    using container_type = basic_multi_vector<Layout, Types...>;
+    using allocator_type = container_type::allocator_type;
+
+    using value_ref_t       = container_type::value_ref_t;
+    using const_value_ref_t = container_type::const_value_ref_t;
+    using value_t           = container_type::value_t;
+
+    using iterator_t       = container_type::iterator_t;
+    using const_iterator_t = container_type::const_iterator_t;
+
+    basic_slot_map() = default;
+
+    /**
+     * @brief Constructs an empty slot_map using an allocator.
+     *
+     * @param alloc The allocator used by every dense column.
+     */
+    explicit basic_slot_map(const allocator_type& alloc)
+        : m_dense(alloc) { }
+
+    /**
+     * @brief Adds a new row.
+     *
+     * @tparam Args The types of the arguments.
+     * @param args The arguments to construct the new row.
+     * @return The handle of the row.
+     */
+    template <typename... Args> slot_handle emplace(Args&&... args) {
+        m_dense.emplace_back(std::forward<Args>(args)...);
+        return acquire_slot();
+    }
+
+    /**
+     * @brief Adds a new row.
+     *
+     * @param value The value of the row.
+     * @return The handle of the row.
+     */
+    slot_handle insert(const value_t& value) {
+        m_dense.push_back(value);
+        return acquire_slot();
+    }
+
+    /**
+     * @brief Adds a new row.
+     *
+     * @param value The value of the row.
+     * @return The handle of the row.
+     */
+    slot_handle insert(value_t&& value) {
+        m_dense.push_back(std::move(value));
+        return acquire_slot();
+    }
+
+    /**
+     * @brief Erases the row of a handle.
+     *
+     * The last row is moved into the place of the erased row.
+     *
+     * @param handle The handle.
+     * @return True if the row was erased, false if the handle is stale.
+     */
+    bool erase(slot_handle handle) {
+        if (!contains(handle)) {
+            return false;
+        }
+
+        slot& erased        = m_slots[handle.index];
+        const auto position = erased.dense;
+
+        const std::uint32_t moved = m_dense_slots.back();
+        m_dense.erase_unordered(m_dense.cbegin() + static_cast<std::ptrdiff_t>(position));
+        m_dense_slots[position] = moved;
+        m_slots[moved].dense    = position;
+        m_dense_slots.pop_back();
+
+        erased.generation += 1;
+        erased.dense = m_free_head;
+        m_free_head  = handle.index;
+        return true;
+    }
+
+    /**
+     * @brief Checks if a handle refers to a row.
+     *
+     * @param handle The handle.
+     * @return True if the row exists, false otherwise.
+     */
+    [[nodiscard]] bool contains(slot_handle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+    }
+
+    /**
+     * @brief Returns the position of the row of a handle in the dense columns.
+     *
+     * @param handle The handle.
+     * @return The position, or nothing if the handle is stale.
+     */
+    [[nodiscard]] std::optional<std::size_t> index_of(slot_handle handle) const {
+        if (!contains(handle)) {
+            return std::nullopt;
+        }
+        return m_slots[handle.index].dense;
+    }
+
+    /**
+     * @brief Returns a reference to the row of a handle.
+     *
+     * @param handle The handle, it must not be stale.
+     * @return Reference to the row.
+     */
+    value_ref_t at(slot_handle handle) {
+        assert(contains(handle));
+        return m_dense.at(m_slots[handle.index].dense);
+    }
+
+    /**
+     * @brief Returns a const reference to the row of a handle.
+     *
+     * @param handle The handle, it must not be stale.
+     * @return Const reference to the row.
+     */
+    const_value_ref_t at(slot_handle handle) const {
+        assert(contains(handle));
+        return m_dense.at(m_slots[handle.index].dense);
+    }
+
+    value_ref_t operator[](slot_handle handle) { return at(handle); }
+
+    const_value_ref_t operator[](slot_handle handle) const { return at(handle); }
+
+    /**
+     * @brief Returns the handle of a row of the dense columns.
+     *
+     * @param pos The position of the row.
+     * @return The handle.
+     */
+    [[nodiscard]] slot_handle handle_at(std::size_t pos) const {
+        assert(pos < size());
+
+        const std::uint32_t index = m_dense_slots[pos];
+        return { index, m_slots[index].generation };
+    }
+
+    /**
+     * @brief Returns a dense column.
+     *
+     * @tparam I The index of the column.
+     * @return The column.
+     */
+    template <std::size_t I> decltype(auto) get_container() { return m_dense.template get_container<I>(); }
+
+    /**
+     * @brief Returns a constant dense column.
+     *
+     * @tparam I The index of the column.
+     * @return The column.
+     */
+    template <std::size_t I> decltype(auto) get_container() const { return m_dense.template get_container<I>(); }
+
+    /**
+     * @brief Returns the multi_vector holding the dense columns.
+     *
+     * Rows must not be added or removed through it.
+     *
+     * @return Const reference to the multi_vector.
+     */
+    const container_type& dense() const { return m_dense; }
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @return The number of rows.
+     */
+    [[nodiscard]] std::size_t size() const { return m_dense.size(); }
+
+    /**
+     * @brief Checks if the slot_map is empty.
+     *
+     * @return True if the slot_map is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_dense.empty(); }
+
+    /**
+     * @brief Reserves storage for rows and slots.
+     *
+     * @param size The number of rows.
+     */
+    void reserve(std::size_t size) {
+        m_dense.reserve(size);
+        m_dense_slots.reserve(size);
+        m_slots.reserve(size);
+    }
+
+    /**
+     * @brief Erases all rows, every handle becomes stale.
+     */
+    void clear() {
+        for (const std::uint32_t index : m_dense_slots) {
+            slot& erased = m_slots[index];
+            erased.generation += 1;
+            erased.dense = m_free_head;
+            m_free_head  = index;
+        }
+
+        m_dense.clear();
+        m_dense_slots.clear();
+    }
+
+    iterator_t begin() { return m_dense.begin(); }
+
+    const_iterator_t begin() const { return m_dense.begin(); }
+
+    iterator_t end() { return m_dense.end(); }
+
+    const_iterator_t end() const { return m_dense.end(); }
+
+private:
+    static constexpr std::uint32_t no_slot = std::numeric_limits<std::uint32_t>::max();
+
+    /**
+     * @brief Entry of the sparse index.
+     */
+    struct slot {
+        /**
+         * @brief The position of the row, or the next free slot if the slot is free.
+         */
+        std::uint32_t dense;
+        std::uint32_t generation;
+    };
+
+    container_type m_dense;
+    std::vector<std::uint32_t> m_dense_slots;
+    std::vector<slot> m_slots;
+    std::uint32_t m_free_head = no_slot;
+
+    /**
+     * @brief Assigns a slot to the last dense row, a free slot is reused before a new one is added.
+     *
+     * @return The handle of the row.
+     */
+    slot_handle acquire_slot() {
+        assert(m_dense.size() <= no_slot);
+
+        const auto dense    = static_cast<std::uint32_t>(m_dense.size() - 1);
+        std::uint32_t index = m_free_head;
+
+        if (index == no_slot) {
+            assert(m_slots.size() < no_slot);
+
+            index = static_cast<std::uint32_t>(m_slots.size());
+            m_slots.push_back({ dense, 0 });
+        } else {
+            m_free_head          = m_slots[index].dense;
+            m_slots[index].dense = dense;
+        }
+
+        m_dense_slots.push_back(index);
+        return { index, m_slots[index].generation };
+    }
+};
+
+template <is_multi_vector_element... Types> using slot_map = basic_slot_map<column_layout, Types...>;
+
+namespace pmr {
+
+    template <is_multi_vector_element... Types>
+    using slot_map = basic_slot_map<basic_column_layout<std::pmr::polymorphic_allocator<std::byte>>, Types...>;
+
+}
+
+}
+
+#endif
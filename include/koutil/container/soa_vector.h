@@ -0,0 +1,238 @@
+#ifndef KOUTIL_CONTAINER_SOA_VECTOR_H
+#define KOUTIL_CONTAINER_SOA_VECTOR_H
+
+#include "koutil/container/multi_vector.h"
+#include "koutil/type/aggregate.h"
+#include "koutil/type/types.h"
+#include <cassert>
+#include <cstddef>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace koutil::container {
+
+namespace detail {
+
+    template <typename Layout, typename Types> struct soa_container;
+
+    template <typename Layout, typename... Types> struct soa_container<Layout, type::types<Types...>> {
+        using type = basic_multi_vector<Layout, Types...>;
+    };
+
+}
+
+/**
+ * @brief Class storing aggregates split into a column per field.
+ *
+ * The fields are found at compile time with `type::aggregate_types_t`, rows are added and read as whole aggregates
+ * and single columns are accessed by a pointer to member.
+ *
+ * @tparam Struct The aggregate type of the rows.
+ * @tparam Layout The storage layout of the columns.
+ */
+template <typename Struct, is_multi_vector_layout Layout>
+    requires(std::is_aggregate_v<Struct>)
+class basic_soa_vector {
+public:
+    using value_type     = Struct;
+    using container_type = detail::soa_container<Layout, type::aggregate_types_t<Struct>>::type;
+    using allocator_type = container_type::allocator_type;
+
+    using value_ref_t       = container_type::value_ref_t;
+    using const_value_ref_t = container_type::const_value_ref_t;
+
+    using iterator_t       = container_type::iterator_t;
+    using const_iterator_t = container_type::const_iterator_t;
+
+    basic_soa_vector() = default;
+
+    /**
+     * @brief Constructs an empty soa_vector using an allocator.
+     *
+     * @param alloc The allocator used by every column.
+     */
+    explicit basic_soa_vector(const allocator_type& alloc)
+        : m_container(alloc) { }
+
+    /**
+     * @brief Constructs a soa_vector with a specified size and value-initialized fields.
+     *
+     * @param count The number of rows.
+     * @param alloc The allocator used by every column.
+     */
+    explicit basic_soa_vector(std::size_t count, const allocator_type& alloc = allocator_type())
+        : m_container(count, alloc) { }
+
+    /**
+     * @brief Returns the column of a field.
+     *
+     * @tparam Member The pointer to the field.
+     * @return The column.
+     */
+    template <auto Member> decltype(auto) column() {
+        return m_container.template get_container<type::aggregate_field_index_v<Struct, Member>>();
+    }
+
+    /**
+     * @brief Returns the constant column of a field.
+     *
+     * @tparam Member The pointer to the field.
+     * @return The column.
+     */
+    template <auto Member> decltype(auto) column() const {
+        return m_container.template get_container<type::aggregate_field_index_v<Struct, Member>>();
+    }
+
+    /**
+     * @brief Returns a reference to a field of a row.
+     *
+     * @tparam Member The pointer to the field.
+     * @param pos The position of the row.
+     * @return Reference to the field.
+     */
+    template <auto Member> decltype(auto) field(std::size_t pos) {
+        assert(pos < size());
+        return column<Member>()[pos];
+    }
+
+    /**
+     * @brief Returns a const reference to a field of a row.
+     *
+     * @tparam Member The pointer to the field.
+     * @param pos The position of the row.
+     * @return Const reference to the field.
+     */
+    template <auto Member> decltype(auto) field(std::size_t pos) const {
+        assert(pos < size());
+        return column<Member>()[pos];
+    }
+
+    /**
+     * @brief Assembles a row into an aggregate.
+     *
+     * @param pos The position of the row.
+     * @return The aggregate.
+     */
+    [[nodiscard]] Struct get(std::size_t pos) const {
+        return std::apply([](const auto&... fields) { return Struct { fields... }; }, m_container.at(pos));
+    }
+
+    /**
+     * @brief Replaces a row.
+     *
+     * @param pos The position of the row.
+     * @param value The new value of the row.
+     */
+    void set(std::size_t pos, const Struct& value) { m_container.at(pos) = type::tie_fields(value); }
+
+    /**
+     * @brief Returns a tuple of references to the fields of a row.
+     *
+     * @param pos The position of the row.
+     * @return Tuple of references to the fields.
+     */
+    value_ref_t at(std::size_t pos) { return m_container.at(pos); }
+
+    /**
+     * @brief Returns a tuple of const references to the fields of a row.
+     *
+     * @param pos The position of the row.
+     * @return Tuple of const references to the fields.
+     */
+    const_value_ref_t at(std::size_t pos) const { return m_container.at(pos); }
+
+    value_ref_t operator[](std::size_t pos) { return at(pos); }
+
+    const_value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Adds an aggregate to the end.
+     *
+     * @param value The aggregate.
+     */
+    void push_back(const Struct& value) {
+        std::apply([&](const auto&... fields) { m_container.emplace_back(fields...); }, type::tie_fields(value));
+    }
+
+    /**
+     * @brief Adds an aggregate to the end by moving its fields.
+     *
+     * @param value The aggregate.
+     */
+    void push_back(Struct&& value) {
+        std::apply(
+            [&](auto&... fields) { m_container.emplace_back(std::move(fields)...); }, type::tie_fields(value)
+        );
+    }
+
+    /**
+     * @brief Removes the last row.
+     */
+    void pop_back() { m_container.pop_back(); }
+
+    /**
+     * @brief Returns the number of rows.
+     *
+     * @return The number of rows.
+     */
+    [[nodiscard]] std::size_t size() const { return m_container.size(); }
+
+    /**
+     * @brief Checks if the soa_vector is empty.
+     *
+     * @return True if the soa_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_container.empty(); }
+
+    /**
+     * @brief Reserves storage for every column.
+     *
+     * @param size The number of rows.
+     */
+    void reserve(std::size_t size) { m_container.reserve(size); }
+
+    /**
+     * @brief Removes all rows.
+     */
+    void clear() { m_container.clear(); }
+
+    /**
+     * @brief Returns the multi_vector holding the columns.
+     *
+     * @return Reference to the multi_vector.
+     */
+    container_type& container() { return m_container; }
+
+    /**
+     * @brief Returns the multi_vector holding the columns.
+     *
+     * @return Const reference to the multi_vector.
+     */
+    const container_type& container() const { return m_container; }
+
+    iterator_t begin() { return m_container.begin(); }
+
+    const_iterator_t begin() const { return m_container.begin(); }
+
+    iterator_t end() { return m_container.end(); }
+
+    const_iterator_t end() const { return m_container.end(); }
+
+private:
+    container_type m_container;
+};
+
+template <typename Struct> using soa_vector = basic_soa_vector<Struct, column_layout>;
+
+namespace pmr {
+
+    template <typename Struct>
+    using soa_vector = basic_soa_vector<Struct, basic_column_layout<std::pmr::polymorphic_allocator<std::byte>>>;
+
+}
+
+}
+
+#endif
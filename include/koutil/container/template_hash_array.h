@@ -1,17 +1,42 @@
 #ifndef KOUTIL_CONTAINER_TEMPLATE_HASH_ARRAY_H
 #define KOUTIL_CONTAINER_TEMPLATE_HASH_ARRAY_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <memory>
+#include <span>
 #include <type_traits>
 #include <utility>
 #include <vector>
 
 namespace koutil::container {
 
+namespace detail {
+
+    /**
+     * @brief Number of keys hashed and prefetched before they are probed by a batched lookup.
+     */
+    inline constexpr std::size_t lookup_batch_size = 16;
+
+    /**
+     * @brief Hints the processor to load a cache line for reading.
+     *
+     * @param address The address inside the cache line.
+     */
+    inline void prefetch([[maybe_unused]] const void* address) {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(address, 0, 3);
+#endif
+    }
+
+}
+
 /**
  *
  * @brief Concept to check if a type is a valid hash function for a given Key type.
@@ -72,6 +97,232 @@ concept is_allocator = requires(T alloc, std::size_t n, Bucket* buckets) {
     { alloc.deallocate(buckets, n) };
 };
 
+/**
+ * @brief Bucket index policy with a power of two bucket count and Fibonacci hashing.
+ *
+ * The hash is multiplied by 2^64 divided by the golden ratio and the high bits of the product select the bucket, so
+ * identity hashes of small integers are spread over all buckets without a division.
+ */
+class fibonacci_bucket_policy {
+public:
+    /**
+     * @brief Constructs the policy for a bucket count.
+     *
+     * @param bucket_count The bucket count returned by `round`.
+     */
+    explicit fibonacci_bucket_policy(std::size_t bucket_count)
+        : m_shift(63 - static_cast<unsigned>(std::bit_width(bucket_count) - 1)) {
+        assert(std::has_single_bit(bucket_count));
+    }
+
+    /**
+     * @brief Returns the smallest supported bucket count not lower than a requested count.
+     *
+     * @param bucket_count The requested count.
+     * @return The power of two bucket count.
+     */
+    static std::size_t round(std::size_t bucket_count) { return std::bit_ceil(std::max<std::size_t>(bucket_count, 1)); }
+
+    /**
+     * @brief Returns the bucket of a hash.
+     *
+     * @param hash The hash.
+     * @return The index of the bucket.
+     */
+    [[nodiscard]] std::size_t index(std::size_t hash) const {
+        // shifting in two steps keeps a single bucket well-defined
+        const std::uint64_t product = static_cast<std::uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+        return static_cast<std::size_t>((product >> m_shift) >> 1);
+    }
+
+private:
+    unsigned m_shift;
+};
+
+/**
+ * @brief Bucket index policy mapping a hash to any bucket count with a multiplication (Lemire's fastrange).
+ *
+ * The bucket is chosen by the high bits of the hash, the hash function must distribute them well. Identity hashes of
+ * small integers all land in the first bucket.
+ */
+class fastrange_bucket_policy {
+public:
+    /**
+     * @brief Constructs the policy for a bucket count.
+     *
+     * @param bucket_count The bucket count returned by `round`.
+     */
+    explicit fastrange_bucket_policy(std::size_t bucket_count)
+        : m_bucket_count(static_cast<std::uint64_t>(bucket_count)) { }
+
+    /**
+     * @brief Returns the smallest supported bucket count not lower than a requested count.
+     *
+     * @param bucket_count The requested count.
+     * @return The bucket count.
+     */
+    static std::size_t round(std::size_t bucket_count) { return std::max<std::size_t>(bucket_count, 1); }
+
+    /**
+     * @brief Returns the bucket of a hash.
+     *
+     * @param hash The hash.
+     * @return The index of the bucket.
+     */
+    [[nodiscard]] std::size_t index(std::size_t hash) const {
+        const auto value = static_cast<std::uint64_t>(hash);
+#if defined(__SIZEOF_INT128__)
+        __extension__ using wide_t = unsigned __int128;
+        return static_cast<std::size_t>((static_cast<wide_t>(value) * m_bucket_count) >> 64);
+#else
+        const std::uint64_t value_lo = value & 0xFFFFFFFF;
+        const std::uint64_t value_hi = value >> 32;
+        const std::uint64_t count_lo = m_bucket_count & 0xFFFFFFFF;
+        const std::uint64_t count_hi = m_bucket_count >> 32;
+
+        // the high half of the 128-bit product assembled from 32-bit partial products
+        const std::uint64_t cross = (value_lo * count_lo >> 32) + (value_hi * count_lo & 0xFFFFFFFF)
+            + (value_lo * count_hi & 0xFFFFFFFF);
+        return static_cast<std::size_t>(
+            value_hi * count_hi + (value_hi * count_lo >> 32) + (value_lo * count_hi >> 32) + (cross >> 32)
+        );
+#endif
+    }
+
+private:
+    std::uint64_t m_bucket_count;
+};
+
+/**
+ * @brief Bucket index policy with a prime bucket count and the modulo of the hash.
+ *
+ * It costs an integer division per operation and is kept for hash functions relying on the modulo.
+ */
+class prime_bucket_policy {
+public:
+    /**
+     * @brief Constructs the policy for a bucket count.
+     *
+     * @param bucket_count The bucket count returned by `round`.
+     */
+    explicit prime_bucket_policy(std::size_t bucket_count)
+        : m_bucket_count(bucket_count) { }
+
+    /**
+     * @brief Returns the smallest prime not lower than a requested count.
+     *
+     * @param bucket_count The requested count.
+     * @return The prime bucket count.
+     */
+    static std::size_t round(std::size_t bucket_count) {
+        std::size_t candidate = std::max<std::size_t>(bucket_count, 2);
+        while (!is_prime(candidate)) {
+            candidate += 1;
+        }
+        return candidate;
+    }
+
+    /**
+     * @brief Returns the bucket of a hash.
+     *
+     * @param hash The hash.
+     * @return The index of the bucket.
+     */
+    [[nodiscard]] std::size_t index(std::size_t hash) const { return hash % m_bucket_count; }
+
+private:
+    std::size_t m_bucket_count;
+
+    static bool is_prime(std::size_t value) {
+        if (value < 4) {
+            return value >= 2;
+        }
+        if (value % 2 == 0) {
+            return false;
+        }
+
+        for (std::size_t divisor = 3; divisor <= value / divisor; divisor += 2) {
+            if (value % divisor == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+/**
+ * @brief Concept to check if a type is a valid bucket index policy.
+ * @tparam T The policy type.
+ */
+template <typename T>
+concept is_bucket_policy = requires(const T policy, std::size_t count) {
+    requires std::is_constructible_v<T, std::size_t> && std::is_copy_assignable_v<T>;
+    { T::round(count) } -> std::same_as<std::size_t>;
+    { policy.index(count) } -> std::same_as<std::size_t>;
+};
+
+/**
+ * @brief Probe statistics policy which counts nothing.
+ */
+struct no_probe_stats {
+    void hash_rejected() { }
+
+    void adapter_called() { }
+
+    void reset() { }
+};
+
+/**
+ * @brief Probe statistics policy counting the calls of the key adapter.
+ *
+ * The counters are updated by constant lookups as well, a hash array using it must not be searched from several
+ * threads at once.
+ */
+struct probe_stats {
+    /**
+     * @brief Number of candidates rejected by the stored hash without calling the key adapter.
+     */
+    std::size_t adapter_calls_avoided = 0;
+
+    /**
+     * @brief Number of calls of the key adapter.
+     */
+    std::size_t adapter_calls = 0;
+
+    void hash_rejected() { adapter_calls_avoided += 1; }
+
+    void adapter_called() { adapter_calls += 1; }
+
+    void reset() { *this = {}; }
+};
+
+/**
+ * @brief Concept to check if a type is a valid probe statistics policy.
+ * @tparam T The policy type.
+ */
+template <typename T>
+concept is_probe_stats = requires(T stats) {
+    requires std::is_default_constructible_v<T>;
+    { stats.hash_rejected() };
+    { stats.adapter_called() };
+    { stats.reset() };
+};
+
+/**
+ * @brief A hash array with separate chaining and comptime data passed to the hash and the key adapter.
+ *
+ * Every bucket entry keeps the full hash of its key, a lookup compares it before calling the key adapter.
+ *
+ * @tparam Key The key type.
+ * @tparam KeyID The key ID type.
+ * @tparam ComptimeData The comptime data type.
+ * @tparam KeyAdapter The key adapter type.
+ * @tparam Hash The hash function type.
+ * @tparam Bucket The bucket type.
+ * @tparam Allocator The allocator type.
+ * @tparam Stats The probe statistics policy.
+ * @tparam BucketPolicy The policy mapping hashes to buckets.
+ */
 template <
     typename Key,
     typename KeyID,
@@ -79,7 +330,9 @@ template <
     is_template_key_adapter<Key, KeyID, ComptimeData> KeyAdapter,
     is_template_hash<Key, ComptimeData> Hash,
     is_bucket<KeyID> Bucket        = std::vector<std::pair<std::size_t, KeyID>>,
-    is_allocator<Bucket> Allocator = std::allocator<Bucket>>
+    is_allocator<Bucket> Allocator = std::allocator<Bucket>,
+    is_probe_stats Stats           = no_probe_stats,
+    is_bucket_policy BucketPolicy  = fibonacci_bucket_policy>
 class template_hash_array {
 private:
     using key_t             = Key;
@@ -92,6 +345,8 @@ class template_hash_array {
     using adapter_t         = KeyAdapter;
     using allocator_t       = Allocator;
     using comptime_t        = ComptimeData;
+    using stats_t           = Stats;
+    using policy_t          = BucketPolicy;
 
     /**
      * @brief Iterator class template for hash_array.
@@ -122,11 +377,17 @@ class template_hash_array {
          * @param bucket Pointer to the current bucket.
          * @param bucket_item Index of the current item in the bucket.
          * @param bucket_end Pointer to the end of the buckets.
+         * @param next Pointer to the first bucket of the array visited after this one, or null.
+         * @param next_end Pointer to the end of the array visited after this one, or null.
          */
-        iterator(ref_t bucket, std::size_t bucket_item, ref_t bucket_end)
+        iterator(
+            ref_t bucket, std::size_t bucket_item, ref_t bucket_end, ref_t next = nullptr, ref_t next_end = nullptr
+        )
             : m_ref(bucket)
             , m_item(bucket_item)
-            , m_bucket_end(bucket_end) {
+            , m_bucket_end(bucket_end)
+            , m_next(next)
+            , m_next_end(next_end) {
             find_non_empty();
         }
 
@@ -143,7 +404,7 @@ class template_hash_array {
         operator iterator<true>() const
             requires(!is_const)
         {
-            return { m_ref, m_item };
+            return { m_ref, m_item, m_bucket_end, m_next, m_next_end };
         }
 
         bool operator==(const iterator& other) const { return m_ref == other.m_ref && m_item == other.m_item; }
@@ -166,8 +427,10 @@ class template_hash_array {
 
     private:
         ref_t m_ref;
-        std::size_t m_item;
+        std::size_t m_item = 0;
         ref_t m_bucket_end = nullptr;
+        ref_t m_next       = nullptr;
+        ref_t m_next_end   = nullptr;
 
         /**
          * @brief Helper function to increment the iterator.
@@ -183,8 +446,20 @@ class template_hash_array {
         }
 
         void find_non_empty() {
-            while (m_ref < m_bucket_end && m_ref->size() == 0) {
-                m_ref += 1;
+            while (true) {
+                while (m_ref < m_bucket_end && m_ref->size() == 0) {
+                    m_ref += 1;
+                }
+
+                if (m_ref != m_bucket_end || m_next == nullptr) {
+                    return;
+                }
+
+                // the old buckets of a rehash are visited before the new ones
+                m_ref        = m_next;
+                m_bucket_end = m_next_end;
+                m_next       = nullptr;
+                m_next_end   = nullptr;
             }
         }
     };
@@ -197,18 +472,18 @@ class template_hash_array {
      * @brief Default constructor.
      */
     template_hash_array()
-        : m_buckets_count(1) {
-        m_buckets = new (allocator_t().allocate(1)) bucket_t[1];
-    }
+        : template_hash_array(1) { }
 
     /**
      * @brief Constructor with bucket count.
      *
-     * @param bucket_count Number of buckets.
+     * @param bucket_count Number of buckets, it is rounded up to a count supported by the bucket policy.
      */
     template_hash_array(std::size_t bucket_count)
-        : m_buckets_count(bucket_count) {
-        m_buckets = new (allocator_t().allocate(bucket_count)) bucket_t[bucket_count];
+        : m_buckets_count(policy_t::round(bucket_count))
+        , m_policy(m_buckets_count)
+        , m_old_policy(m_policy) {
+        m_buckets = new (allocator_t().allocate(m_buckets_count)) bucket_t[m_buckets_count];
     }
 
     /**
@@ -217,13 +492,9 @@ class template_hash_array {
      * @param other Another hash_array to copy from.
      */
     template_hash_array(const template_hash_array& other)
-        : m_buckets_count(other.m_buckets_count)
-        , m_size(other.m_size)
-        , m_max_load_factor(other.m_max_load_factor) {
-
-        m_buckets = allocator_t().allocate(other.m_buckets_count);
-
-        std::uninitialized_copy_n(other.m_buckets, other.m_buckets_count, m_buckets);
+        : m_policy(other.m_policy)
+        , m_old_policy(other.m_old_policy) {
+        copy_from(other);
     }
 
     /**
@@ -232,14 +503,9 @@ class template_hash_array {
      * @param other Another hash_array to move from.
      */
     template_hash_array(template_hash_array&& other)
-        : m_buckets(other.m_buckets)
-        , m_buckets_count(other.m_buckets_count)
-        , m_size(other.m_size)
-        , m_max_load_factor(other.m_max_load_factor) {
-
-        other.m_buckets       = nullptr;
-        other.m_size          = 0;
-        other.m_buckets_count = 0;
+        : m_policy(other.m_policy)
+        , m_old_policy(other.m_old_policy) {
+        move_from(other);
     }
 
     /**
@@ -260,13 +526,9 @@ class template_hash_array {
 
         destroy();
 
-        m_buckets_count   = other.m_buckets_count;
-        m_size            = other.m_size;
-        m_max_load_factor = other.m_max_load_factor;
-
-        m_buckets = allocator_t().allocate(other.m_buckets_count);
-
-        std::uninitialized_copy_n(other.m_buckets, other.m_buckets_count, m_buckets);
+        m_policy     = other.m_policy;
+        m_old_policy = other.m_old_policy;
+        copy_from(other);
 
         return *this;
     }
@@ -284,14 +546,9 @@ class template_hash_array {
 
         destroy();
 
-        m_buckets         = other.m_buckets;
-        m_buckets_count   = other.m_buckets_count;
-        m_size            = other.m_size;
-        m_max_load_factor = other.m_max_load_factor;
-
-        other.m_buckets       = nullptr;
-        other.m_size          = 0;
-        other.m_buckets_count = 0;
+        m_policy     = other.m_policy;
+        m_old_policy = other.m_old_policy;
+        move_from(other);
 
         return *this;
     }
@@ -310,6 +567,9 @@ class template_hash_array {
 
     /**
      * @brief Returns the number of buckets.
+     *
+     * During an incremental rehash it is the number of buckets of the new table.
+     *
      * @return std::size_t Number of buckets.
      */
     [[nodiscard]] std::size_t bucket_count() const { return m_buckets_count; }
@@ -329,11 +589,44 @@ class template_hash_array {
         m_max_load_factor = factor;
     }
 
+    /**
+     * @brief Returns the number of old buckets migrated by every insert and erase during a rehash.
+     * @return std::size_t The number of buckets, zero if the table is rehashed at once.
+     */
+    [[nodiscard]] std::size_t rehash_step() const { return m_rehash_step; }
+
+    /**
+     * @brief Selects between rehashing at once and incremental rehashing.
+     *
+     * An incremental rehash allocates the new table and keeps the old one until all of its buckets are migrated,
+     * `step` buckets by every insert and erase. Lookups search both tables in the meantime.
+     *
+     * @param step The number of buckets migrated by a mutation, zero to rehash at once.
+     */
+    void set_rehash_step(std::size_t step) { m_rehash_step = step; }
+
+    /**
+     * @brief Checks if an incremental rehash is in progress.
+     * @return bool True if the old table still holds elements, false otherwise.
+     */
+    [[nodiscard]] bool is_rehashing() const { return m_old_buckets != nullptr; }
+
     /**
      * @brief Clear all elements from the hash_array.
      */
     void clear() { clear_all_buckets(); }
 
+    /**
+     * @brief Returns the probe statistics.
+     * @return const stats_t& The statistics.
+     */
+    [[nodiscard]] const stats_t& stats() const { return m_stats; }
+
+    /**
+     * @brief Resets the probe statistics.
+     */
+    void reset_stats() { m_stats.reset(); }
+
     /**
      * @brief Try to insert a key and key ID into the hash_array.
      * @tparam Data The comptime data.
@@ -374,13 +667,12 @@ class template_hash_array {
      * @return iterator_t The iterator with found element, if not found end() is returned.
      */
     template <comptime_t Data> iterator_t find(const key_t& key, adapter_t adapter) {
-        auto& bucket = get_bucket<Data>(key);
-        auto it      = find_bucket_item<Data>(key, bucket, adapter);
+        const auto [bucket, it] = locate<Data>(*this, key, hash_t().template hash<Data>(key), adapter);
 
-        if (it != bucket.end()) {
-            return iterator_t { &bucket,
-                                static_cast<std::size_t>(std::distance(bucket.begin(), it)),
-                                m_buckets + m_buckets_count };
+        if (it != bucket->end()) {
+            return make_iterator<iterator_t>(
+                *this, bucket, static_cast<std::size_t>(std::distance(bucket->begin(), it))
+            );
         }
 
         return end();
@@ -394,23 +686,92 @@ class template_hash_array {
      * @return const_iterator_t The iterator with found element, if not found end() is returned.
      */
     template <comptime_t Data> const_iterator_t find(const key_t& key, adapter_t adapter) const {
-        auto& bucket = get_bucket<Data>(key);
-        auto it      = find_bucket_item<Data>(key, bucket, adapter);
+        const auto [bucket, it] = locate<Data>(*this, key, hash_t().template hash<Data>(key), adapter);
 
-        if (it != bucket.end()) {
-            return const_iterator_t { &bucket,
-                                      static_cast<std::size_t>(std::distance(bucket.begin(), it)),
-                                      m_buckets + m_buckets_count };
+        if (it != bucket->end()) {
+            return make_iterator<const_iterator_t>(
+                *this, bucket, static_cast<std::size_t>(std::distance(bucket->begin(), it))
+            );
         }
 
         return cend();
     }
 
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * The keys are processed in groups, every key of a group is hashed and its bucket prefetched before the first one
+     * is probed, so the cache misses of the group overlap.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    template <comptime_t Data>
+    void find_batch(std::span<const key_t> keys, std::span<iterator_t> out, adapter_t adapter) {
+        assert(out.size() >= keys.size());
+
+        lookup_batch<Data>(*this, keys, adapter, [&](std::size_t i, auto* bucket, auto it) {
+            if (it == bucket->end()) {
+                out[i] = end();
+                return;
+            }
+
+            const auto item = static_cast<std::size_t>(std::distance(bucket->begin(), it));
+            out[i]          = make_iterator<iterator_t>(*this, bucket, item);
+        });
+    }
+
+    /**
+     * @brief Finds a batch of keys.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The iterators with found elements, end() for missing keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     */
+    template <comptime_t Data>
+    void find_batch(std::span<const key_t> keys, std::span<const_iterator_t> out, adapter_t adapter) const {
+        assert(out.size() >= keys.size());
+
+        lookup_batch<Data>(*this, keys, adapter, [&](std::size_t i, auto* bucket, auto it) {
+            if (it == bucket->end()) {
+                out[i] = cend();
+                return;
+            }
+
+            const auto item = static_cast<std::size_t>(std::distance(bucket->begin(), it));
+            out[i]          = make_iterator<const_iterator_t>(*this, bucket, item);
+        });
+    }
+
+    /**
+     * @brief Checks which keys of a batch are in the hash table.
+     *
+     * @tparam Data The comptime data.
+     * @param keys The keys.
+     * @param out The flags of found keys. It must be at least as large as `keys`.
+     * @param adapter Key adapter for comparison.
+     * @return std::size_t The number of found keys.
+     */
+    template <comptime_t Data>
+    std::size_t contains_batch(std::span<const key_t> keys, std::span<bool> out, adapter_t adapter) const {
+        assert(out.size() >= keys.size());
+
+        std::size_t found = 0;
+        lookup_batch<Data>(*this, keys, adapter, [&](std::size_t i, auto* bucket, auto it) {
+            out[i] = it != bucket->end();
+            found += static_cast<std::size_t>(out[i]);
+        });
+        return found;
+    }
+
     /**
      * @brief Get an iterator to the beginning of the hash_array.
      * @return iterator_t Iterator to the beginning.
      */
-    iterator_t begin() { return iterator_t { m_buckets, 0, m_buckets + m_buckets_count }; }
+    iterator_t begin() { return make_begin<iterator_t>(*this); }
 
     /**
      * @brief Get an iterator to the end of the hash_array.
@@ -422,7 +783,7 @@ class template_hash_array {
      * @brief Get a constant iterator to the beginning of the hash_array.
      * @return const_iterator_t Constant iterator to the beginning.
      */
-    const_iterator_t begin() const { return const_iterator_t { m_buckets, 0, m_buckets + m_buckets_count }; }
+    const_iterator_t begin() const { return make_begin<const_iterator_t>(*this); }
 
     /**
      * @brief Get a constant iterator to the end of the hash_array.
@@ -436,7 +797,7 @@ class template_hash_array {
      * @brief Get a constant iterator to the beginning of the hash_array.
      * @return iterator_t Constant iterator to the beginning.
      */
-    const_iterator_t cbegin() const { return const_iterator_t { m_buckets, 0, m_buckets + m_buckets_count }; }
+    const_iterator_t cbegin() const { return begin(); }
 
     /**
      * @brief Get a constant iterator to the end of the hash_array.
@@ -447,27 +808,78 @@ class template_hash_array {
     }
 
 private:
-    bucket_t* m_buckets;
-    std::size_t m_buckets_count;
+    bucket_t* m_buckets         = nullptr;
+    std::size_t m_buckets_count = 0;
+    policy_t m_policy;
     std::size_t m_size      = 0;
     float m_max_load_factor = 1.0F;
+    [[no_unique_address]] mutable stats_t m_stats;
 
-    template <comptime_t Data> value_t hash_key(const Key& key) const {
-        value_t hash = hash_t().template hash<Data>(key);
-        return hash % m_buckets_count;
-    }
+    /**
+     * @brief The buckets of the table being migrated by an incremental rehash, or null.
+     */
+    bucket_t* m_old_buckets         = nullptr;
+    std::size_t m_old_buckets_count = 0;
+    policy_t m_old_policy;
+
+    /**
+     * @brief Number of old buckets already migrated, they are all empty.
+     */
+    std::size_t m_migrated    = 0;
+    std::size_t m_rehash_step = 0;
+
+    /**
+     * @brief Finds the entry of a key in the new table and then in the old table.
+     *
+     * @tparam Data The comptime data.
+     * @tparam Self The type of the hash array, const-qualified for a constant hash array.
+     * @param self The hash array.
+     * @param key The key.
+     * @param hash The hash of the key.
+     * @param adapter Key adapter for comparison.
+     * @return The bucket and the iterator to the entry, or the bucket of the new table and its end.
+     */
+    template <comptime_t Data, typename Self>
+    static auto locate(Self& self, const key_t& key, value_t hash, adapter_t adapter) {
+        auto* bucket = self.m_buckets + self.m_policy.index(hash);
+        auto it      = self.template find_bucket_item<Data>(key, hash, *bucket, adapter);
 
-    template <comptime_t Data> bucket_t& get_bucket(const key_t& key) { return m_buckets[hash_key<Data>(key)]; }
+        if (it == bucket->end() && self.m_old_buckets != nullptr) {
+            auto* old_bucket = self.m_old_buckets + self.m_old_policy.index(hash);
+            auto old_it      = self.template find_bucket_item<Data>(key, hash, *old_bucket, adapter);
 
-    template <comptime_t Data> const bucket_t& get_bucket(const key_t& key) const {
-        return m_buckets[hash_key<Data>(key)];
+            if (old_it != old_bucket->end()) {
+                return std::pair { old_bucket, old_it };
+            }
+        }
+
+        return std::pair { bucket, it };
     }
 
-    template <comptime_t Data> bucket_iter find_bucket_item(const key_t& key, bucket_t& bucket, adapter_t adapter) {
-        auto bucket_end   = bucket.end();
-        auto bucket_start = bucket.begin();
+    /**
+     * @brief Finds the entry of a key in a bucket.
+     *
+     * The stored hash of an entry is compared first, the key adapter is called only if the hashes are equal.
+     *
+     * @tparam Data The comptime data.
+     * @tparam BucketRef The bucket type, const-qualified for a constant bucket.
+     * @param key The key.
+     * @param hash The hash of the key.
+     * @param bucket The bucket.
+     * @param adapter Key adapter for comparison.
+     * @return The iterator to the entry, or the end of the bucket.
+     */
+    template <comptime_t Data, typename BucketRef>
+    auto find_bucket_item(const key_t& key, value_t hash, BucketRef& bucket, adapter_t adapter) const {
+        auto bucket_end = bucket.end();
+
+        for (auto start = bucket.begin(); start != bucket_end; ++start) {
+            if (start->first != hash) {
+                m_stats.hash_rejected();
+                continue;
+            }
 
-        for (auto start = bucket_start; start != bucket_end; ++start) {
+            m_stats.adapter_called();
             if (adapter.template eql<Data>(key, start->second)) {
                 return start;
             }
@@ -476,51 +888,109 @@ class template_hash_array {
         return bucket_end;
     }
 
-    template <comptime_t Data>
-    bucket_const_iter find_bucket_item(const key_t& key, const bucket_t& bucket, adapter_t adapter) const {
-        auto bucket_end   = bucket.end();
-        auto bucket_start = bucket.begin();
+    /**
+     * @brief Looks up keys in groups of `detail::lookup_batch_size`.
+     *
+     * Every group is processed in three passes: the keys are hashed and their buckets prefetched, the entries of the
+     * buckets are prefetched and finally the buckets are searched.
+     *
+     * @tparam Data The comptime data.
+     * @tparam Self The type of the hash array, const-qualified for a constant hash array.
+     * @tparam Fn The type of the result callback.
+     * @param self The hash array.
+     * @param keys The keys.
+     * @param adapter Key adapter for comparison.
+     * @param fn Callback invoked with the index of the key, the bucket and the iterator to the entry.
+     */
+    template <comptime_t Data, typename Self, typename Fn>
+    static void lookup_batch(Self& self, std::span<const key_t> keys, adapter_t adapter, Fn&& fn) {
+        std::array<value_t, detail::lookup_batch_size> hashes;
+
+        for (std::size_t first = 0; first < keys.size(); first += detail::lookup_batch_size) {
+            const std::size_t count = std::min(detail::lookup_batch_size, keys.size() - first);
+
+            for (std::size_t i = 0; i < count; ++i) {
+                hashes[i] = hash_t().template hash<Data>(keys[first + i]);
+                detail::prefetch(self.m_buckets + self.m_policy.index(hashes[i]));
+                if (self.m_old_buckets != nullptr) {
+                    detail::prefetch(self.m_old_buckets + self.m_old_policy.index(hashes[i]));
+                }
+            }
 
-        for (auto start = bucket_start; start != bucket_end; ++start) {
-            if (adapter.template eql<Data>(key, start->second)) {
-                return start;
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto& bucket = self.m_buckets[self.m_policy.index(hashes[i])];
+                if (bucket.begin() != bucket.end()) {
+                    detail::prefetch(std::addressof(*bucket.begin()));
+                }
+            }
+
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto [bucket, it] = locate<Data>(self, keys[first + i], hashes[i], adapter);
+                fn(first + i, bucket, it);
             }
         }
+    }
+
+    template <typename Iter, typename Self> static Iter make_begin(Self& self) {
+        if (self.m_old_buckets == nullptr) {
+            return Iter { self.m_buckets, 0, self.m_buckets + self.m_buckets_count };
+        }
 
-        return bucket_end;
+        return Iter { self.m_old_buckets + self.m_migrated,
+                      0,
+                      self.m_old_buckets + self.m_old_buckets_count,
+                      self.m_buckets,
+                      self.m_buckets + self.m_buckets_count };
     }
 
-    template <comptime_t Data> bool insert(const key_t& key, const key_id_t& key_id, adapter_t adapter) {
-        value_t hash = hash_t().template hash<Data>(key);
-        auto& bucket = m_buckets[hash % m_buckets_count];
+    template <typename Iter, typename Self, typename BucketPtr>
+    static Iter make_iterator(Self& self, BucketPtr bucket, std::size_t item) {
+        const bool in_old = self.m_old_buckets != nullptr && bucket >= self.m_old_buckets
+            && bucket < self.m_old_buckets + self.m_old_buckets_count;
+
+        if (in_old) {
+            return Iter { bucket,
+                          item,
+                          self.m_old_buckets + self.m_old_buckets_count,
+                          self.m_buckets,
+                          self.m_buckets + self.m_buckets_count };
+        }
+
+        return Iter { bucket, item, self.m_buckets + self.m_buckets_count };
+    }
 
-        auto it = find_bucket_item<Data>(key, bucket, adapter);
+    template <comptime_t Data> bool insert(const key_t& key, const key_id_t& key_id, adapter_t adapter) {
+        const value_t hash      = hash_t().template hash<Data>(key);
+        const auto [bucket, it] = locate<Data>(*this, key, hash, adapter);
 
-        if (it != bucket.end()) {
+        if (it != bucket->end()) {
             return false;
         }
 
-        bucket.emplace_back(hash, key_id);
+        // new keys always go to the new table
+        m_buckets[m_policy.index(hash)].emplace_back(hash, key_id);
         m_size += 1;
         rehash_if_needed();
         return true;
     }
 
     template <comptime_t Data> void remove(const key_t& key, adapter_t adapter) {
-        auto& bucket = get_bucket<Data>(key);
-        auto it      = find_bucket_item<Data>(key, bucket, adapter);
+        const auto [bucket, it] = locate<Data>(*this, key, hash_t().template hash<Data>(key), adapter);
 
-        if (it != bucket.end()) {
-            bucket.erase(it);
+        if (it != bucket->end()) {
+            bucket->erase(it);
             m_size -= 1;
         }
+
+        if (m_old_buckets != nullptr) {
+            migrate(m_rehash_step);
+        }
     }
 
     template <comptime_t Data> bool set(const key_t& key, const key_id_t& new_key_id, adapter_t adapter) {
-        auto& bucket = get_bucket<Data>(key);
-        auto it      = find_bucket_item<Data>(key, bucket, adapter);
+        const auto [bucket, it] = locate<Data>(*this, key, hash_t().template hash<Data>(key), adapter);
 
-        if (it != bucket.end()) {
+        if (it != bucket->end()) {
             it->second = new_key_id;
             return true;
         }
@@ -528,43 +998,112 @@ class template_hash_array {
     }
 
     void rehash_if_needed() {
-        if (static_cast<float>(m_size) / m_buckets_count <= m_max_load_factor) {
+        if (m_old_buckets != nullptr) {
+            migrate(m_rehash_step);
+            return;
+        }
+
+        if (static_cast<float>(m_size) / static_cast<float>(m_buckets_count) <= m_max_load_factor) {
             return;
         }
 
-        std::size_t new_buckets_count = m_buckets_count * 2;
+        const std::size_t new_buckets_count = policy_t::round(m_buckets_count * 2);
 
-        auto alloc           = allocator_t();
-        auto new_buckets_mem = alloc.allocate(new_buckets_count);
-        auto new_buckets     = new (new_buckets_mem) bucket_t[new_buckets_count];
+        m_old_buckets       = m_buckets;
+        m_old_buckets_count = m_buckets_count;
+        m_old_policy        = m_policy;
+        m_migrated          = 0;
 
-        for (std::size_t i = 0; i < m_buckets_count; ++i) {
-            for (auto&& [hash, key_index] : m_buckets[i]) {
-                new_buckets[hash % new_buckets_count].emplace_back(hash, key_index);
+        m_buckets       = new (allocator_t().allocate(new_buckets_count)) bucket_t[new_buckets_count];
+        m_buckets_count = new_buckets_count;
+        m_policy        = policy_t(new_buckets_count);
+
+        migrate(m_rehash_step);
+    }
+
+    /**
+     * @brief Moves the entries of old buckets into the new table and frees the old table once it is empty.
+     *
+     * The buffer of every old bucket is released as soon as it is migrated, so freeing the old table releases only
+     * the bucket array.
+     *
+     * @param count The number of old buckets to migrate, zero to migrate all of them.
+     */
+    void migrate(std::size_t count) {
+        const std::size_t remaining = m_old_buckets_count - m_migrated;
+        const std::size_t last      = m_migrated + (count == 0 ? remaining : std::min(count, remaining));
+
+        for (; m_migrated < last; ++m_migrated) {
+            bucket_t& bucket = m_old_buckets[m_migrated];
+            for (auto&& [hash, key_index] : bucket) {
+                m_buckets[m_policy.index(hash)].emplace_back(hash, std::move(key_index));
             }
+            bucket = bucket_t();
+        }
+
+        if (m_migrated == m_old_buckets_count) {
+            destroy_old();
         }
+    }
+
+    void copy_from(const template_hash_array& other) {
+        m_buckets_count   = other.m_buckets_count;
+        m_size            = other.m_size;
+        m_max_load_factor = other.m_max_load_factor;
+        m_rehash_step     = other.m_rehash_step;
 
-        std::destroy_n(m_buckets, m_buckets_count);
-        alloc.deallocate(m_buckets, m_buckets_count);
+        m_buckets = allocator_t().allocate(m_buckets_count);
+        std::uninitialized_copy_n(other.m_buckets, m_buckets_count, m_buckets);
 
-        m_buckets_count = new_buckets_count;
-        m_buckets       = new_buckets;
+        if (other.m_old_buckets != nullptr) {
+            m_old_buckets_count = other.m_old_buckets_count;
+            m_migrated          = other.m_migrated;
+
+            m_old_buckets = allocator_t().allocate(m_old_buckets_count);
+            std::uninitialized_copy_n(other.m_old_buckets, m_old_buckets_count, m_old_buckets);
+        }
+    }
+
+    void move_from(template_hash_array& other) {
+        m_buckets           = std::exchange(other.m_buckets, nullptr);
+        m_buckets_count     = std::exchange(other.m_buckets_count, 0);
+        m_size              = std::exchange(other.m_size, 0);
+        m_max_load_factor   = other.m_max_load_factor;
+        m_rehash_step       = other.m_rehash_step;
+        m_old_buckets       = std::exchange(other.m_old_buckets, nullptr);
+        m_old_buckets_count = std::exchange(other.m_old_buckets_count, 0);
+        m_migrated          = std::exchange(other.m_migrated, 0);
     }
 
     void clear_all_buckets() {
         for (std::size_t i = 0; i < m_buckets_count; ++i) {
             m_buckets[i].clear();
         }
+        destroy_old();
         m_size = 0;
     }
 
-    void destroy() {
+    void destroy_old() {
+        if (m_old_buckets != nullptr) {
+            std::destroy_n(m_old_buckets, m_old_buckets_count);
+            allocator_t().deallocate(m_old_buckets, m_old_buckets_count);
+        }
 
-        if (m_buckets_count > 0) {
+        m_old_buckets       = nullptr;
+        m_old_buckets_count = 0;
+        m_migrated          = 0;
+    }
+
+    void destroy() {
+        if (m_buckets != nullptr) {
             auto alloc = allocator_t();
             std::destroy_n(m_buckets, m_buckets_count);
             alloc.deallocate(m_buckets, m_buckets_count);
         }
+
+        m_buckets       = nullptr;
+        m_buckets_count = 0;
+        destroy_old();
     }
 };
 
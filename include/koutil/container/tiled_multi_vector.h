@@ -0,0 +1,1085 @@
+#ifndef KOUTIL_CONTAINER_TILED_MULTI_VECTOR_H
+#define KOUTIL_CONTAINER_TILED_MULTI_VECTOR_H
+
+#include "koutil/container/indexed_row_iterator.h"
+#include "koutil/container/multi_vector.h"
+#include "koutil/container/multi_vector_storage.h"
+#include "koutil/container/permutation.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+namespace detail {
+
+    /**
+     * @brief Alignment of the columns inside a tile, the width of an AVX register.
+     */
+    inline constexpr std::size_t simd_alignment = 32;
+
+}
+
+/**
+ * @brief Class representing a multi_vector whose rows are grouped into tiles stored as columns (AoSoA).
+ *
+ * A tile holds `Tile` consecutive rows with the elements of each column next to each other, and the tiles are stored
+ * one after another in a single allocation. Reading a whole row touches a single tile instead of one stream per
+ * column, while the elements of a column inside a tile can still be processed as a SIMD-width span. Every tile starts
+ * on a cache line and every column of a tile is aligned to `detail::simd_alignment`.
+ *
+ * The container offers the row and column API of multi_vector, so the two layouts can be swapped for each other.
+ * Columns are not contiguous, so `get_container` and `view` index the tiles instead of returning spans.
+ *
+ * @tparam Tile The number of rows in a tile, a power of two.
+ * @tparam Allocator The allocator type, rebound to cache lines.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t Tile, typename Allocator, is_multi_vector_element... Types>
+    requires(std::has_single_bit(Tile) && sizeof...(Types) != 0 && (!std::is_void_v<Types> && ...))
+class basic_tiled_multi_vector {
+private:
+    static constexpr std::size_t column_count = sizeof...(Types);
+
+    static constexpr std::size_t alignment = std::max({ detail::cache_line_size, alignof(Types)... });
+
+    /**
+     * @brief Byte offsets of the columns inside a tile, the last entry is the size of a tile.
+     */
+    static constexpr std::array<std::size_t, column_count + 1> column_offsets = [] {
+        constexpr std::array<std::size_t, column_count> sizes  = { sizeof(Types)... };
+        constexpr std::array<std::size_t, column_count> aligns = { alignof(Types)... };
+
+        auto align_up = [](std::size_t value, std::size_t align) { return (value + align - 1) / align * align; };
+
+        std::array<std::size_t, column_count + 1> offsets {};
+        for (std::size_t i = 0; i < column_count; ++i) {
+            offsets[i]     = align_up(offsets[i], std::max(aligns[i], detail::simd_alignment));
+            offsets[i + 1] = offsets[i] + Tile * sizes[i];
+        }
+        offsets[column_count] = align_up(offsets[column_count], alignment);
+        return offsets;
+    }();
+
+    static constexpr std::size_t tile_bytes = column_offsets[column_count];
+
+    static constexpr std::size_t tile_shift = std::countr_zero(Tile);
+
+    struct alignas(alignment) line {
+        std::byte bytes[alignment];
+    };
+
+    using allocator_t      = std::allocator_traits<Allocator>::template rebind_alloc<line>;
+    using allocator_traits = std::allocator_traits<allocator_t>;
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+public:
+    using allocator_type = Allocator;
+
+    using value_ref_t       = std::tuple<Types&...>;
+    using const_value_ref_t = std::tuple<const Types&...>;
+    using value_t           = std::tuple<Types...>;
+
+    using iterator_t       = indexed_row_iterator<basic_tiled_multi_vector>;
+    using const_iterator_t = indexed_row_iterator<const basic_tiled_multi_vector>;
+
+    /**
+     * @brief The number of rows in a tile.
+     */
+    static constexpr std::size_t tile_size = Tile;
+
+    basic_tiled_multi_vector() = default;
+
+    /**
+     * @brief Constructs an empty multi_vector using an allocator.
+     *
+     * @param alloc The allocator used by the tiles.
+     */
+    explicit basic_tiled_multi_vector(const allocator_type& alloc)
+        : m_alloc(alloc) { }
+
+    /**
+     * @brief Constructs a multi_vector with a specified size and value-initialized elements.
+     *
+     * @param count The number of elements.
+     * @param alloc The allocator used by the tiles.
+     */
+    explicit basic_tiled_multi_vector(std::size_t count, const allocator_type& alloc = allocator_type())
+        : m_alloc(alloc) {
+        resize(count);
+    }
+
+    /**
+     * @brief Constructs a multi_vector with a specified size and initial value.
+     *
+     * @param count The number of elements.
+     * @param value The initial value for the elements.
+     * @param alloc The allocator used by the tiles.
+     */
+    basic_tiled_multi_vector(std::size_t count, const value_t& value, const allocator_type& alloc = allocator_type())
+        : m_alloc(alloc) {
+        resize(count, value);
+    }
+
+    basic_tiled_multi_vector(const basic_tiled_multi_vector& other)
+        : m_alloc(allocator_traits::select_on_container_copy_construction(other.m_alloc)) {
+        copy_from(other);
+    }
+
+    basic_tiled_multi_vector(basic_tiled_multi_vector&& other)
+        : m_alloc(std::move(other.m_alloc))
+        , m_data(std::exchange(other.m_data, nullptr))
+        , m_tiles(std::exchange(other.m_tiles, 0))
+        , m_size(std::exchange(other.m_size, 0)) { }
+
+    ~basic_tiled_multi_vector() { release(); }
+
+    basic_tiled_multi_vector& operator=(const basic_tiled_multi_vector& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        clear();
+
+        if constexpr (allocator_traits::propagate_on_container_copy_assignment::value) {
+            if (m_alloc != other.m_alloc) {
+                // the tiles have to be returned to the allocator which allocated them
+                release();
+            }
+            m_alloc = other.m_alloc;
+        }
+
+        copy_from(other);
+        return *this;
+    }
+
+    basic_tiled_multi_vector& operator=(basic_tiled_multi_vector&& other) {
+        if (&other == this) {
+            return *this;
+        }
+
+        if constexpr (!allocator_traits::propagate_on_container_move_assignment::value) {
+            if (m_alloc != other.m_alloc) {
+                // the tiles cannot be adopted, so the elements are moved one by one
+                clear();
+                reserve(other.m_size);
+                for (auto&& row : other) {
+                    std::apply([this](Types&... values) { emplace_back(std::move(values)...); }, row);
+                }
+                other.clear();
+                return *this;
+            }
+        }
+
+        release();
+
+        if constexpr (allocator_traits::propagate_on_container_move_assignment::value) {
+            m_alloc = std::move(other.m_alloc);
+        }
+
+        m_data  = std::exchange(other.m_data, nullptr);
+        m_tiles = std::exchange(other.m_tiles, 0);
+        m_size  = std::exchange(other.m_size, 0);
+
+        return *this;
+    }
+
+    /**
+     * @brief Returns the allocator used by the tiles.
+     *
+     * @return The allocator.
+     */
+    [[nodiscard]] allocator_type get_allocator() const { return allocator_type(m_alloc); }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_size; }
+
+    /**
+     * @brief Checks if the multi_vector is empty.
+     *
+     * @return True if the multi_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_size == 0; }
+
+    /**
+     * @brief Returns the number of elements that can be held without reallocation.
+     *
+     * @return The capacity.
+     */
+    [[nodiscard]] std::size_t capacity() const { return m_tiles * Tile; }
+
+    /**
+     * @brief Returns the number of tiles holding at least one element.
+     *
+     * @return The number of tiles.
+     */
+    [[nodiscard]] std::size_t tile_count() const { return (m_size + Tile - 1) >> tile_shift; }
+
+    /**
+     * @brief Returns the elements of a column stored in a tile.
+     *
+     * @tparam I The index of the column.
+     * @param tile The index of the tile.
+     * @return The span over the elements, shorter than `tile_size` only for the last tile.
+     */
+    template <std::size_t I> std::span<element_t<I>> tile(std::size_t tile) {
+        assert(tile < tile_count());
+        return std::span<element_t<I>>(column<I>(m_data, tile), tile_rows(tile));
+    }
+
+    /**
+     * @brief Returns the elements of a column stored in a tile.
+     *
+     * @tparam I The index of the column.
+     * @param tile The index of the tile.
+     * @return The span over the elements, shorter than `tile_size` only for the last tile.
+     */
+    template <std::size_t I> std::span<const element_t<I>> tile(std::size_t tile) const {
+        assert(tile < tile_count());
+        return std::span<const element_t<I>>(column<I>(m_data, tile), tile_rows(tile));
+    }
+
+    /**
+     * @brief Returns a random access view over the elements of a column.
+     *
+     * The elements are not contiguous, scans over a column should prefer `tile`.
+     *
+     * @tparam I The index of the column.
+     * @return The view yielding references to the elements.
+     */
+    template <std::size_t I> auto get_container() {
+        return std::views::iota(std::size_t { 0 }, m_size)
+            | std::views::transform([data = m_data](std::size_t pos) -> element_t<I>& { return element<I>(data, pos); }
+            );
+    }
+
+    /**
+     * @brief Returns a random access view over the elements of a column.
+     *
+     * @tparam I The index of the column.
+     * @return The view yielding const references to the elements.
+     */
+    template <std::size_t I> auto get_container() const {
+        return std::views::iota(std::size_t { 0 }, m_size)
+            | std::views::transform([data = static_cast<const line*>(m_data)](std::size_t pos) -> const element_t<I>& {
+                   return element<I>(data, pos);
+               });
+    }
+
+    /**
+     * @brief Returns a view over a subset of the columns.
+     *
+     * Iterating the view touches only the selected columns.
+     *
+     * @tparam I The indices of the columns.
+     * @return The view yielding tuples of references to the selected columns.
+     */
+    template <std::size_t... I>
+        requires(sizeof...(I) > 0)
+    auto view() {
+        return std::views::iota(std::size_t { 0 }, m_size)
+            | std::views::transform([data = m_data](std::size_t pos) {
+                   return std::tuple<element_t<I>&...>(element<I>(data, pos)...);
+               });
+    }
+
+    /**
+     * @brief Returns a constant view over a subset of the columns.
+     *
+     * @tparam I The indices of the columns.
+     * @return The view yielding tuples of const references to the selected columns.
+     */
+    template <std::size_t... I>
+        requires(sizeof...(I) > 0)
+    auto view() const {
+        return std::views::iota(std::size_t { 0 }, m_size)
+            | std::views::transform([data = static_cast<const line*>(m_data)](std::size_t pos) {
+                   return std::tuple<const element_t<I>&...>(element<I>(data, pos)...);
+               });
+    }
+
+    /**
+     * @brief Returns a reference to the first element.
+     *
+     * @return Reference to the first element.
+     */
+    value_ref_t front() {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a const reference to the first element.
+     *
+     * @return Const reference to the first element.
+     */
+    const_value_ref_t front() const {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a reference to the last element.
+     *
+     * @return Reference to the last element.
+     */
+    value_ref_t back() {
+        assert(!empty());
+        return at(m_size - 1);
+    }
+
+    /**
+     * @brief Returns a const reference to the last element.
+     *
+     * @return Const reference to the last element.
+     */
+    const_value_ref_t back() const {
+        assert(!empty());
+        return at(m_size - 1);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t at(std::size_t pos) {
+        assert(pos < m_size);
+        return get_all<value_ref_t>(m_data, pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t at(std::size_t pos) const {
+        assert(pos < m_size);
+        return get_all<const_value_ref_t>(static_cast<const line*>(m_data), pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Destroys all elements and keeps the tiles for reuse.
+     */
+    void clear() { truncate(0); }
+
+    /**
+     * @brief Swaps the contents of two multi_vectors.
+     *
+     * @param other The other multi_vector.
+     */
+    void swap(basic_tiled_multi_vector& other) {
+        if constexpr (allocator_traits::propagate_on_container_swap::value) {
+            std::swap(m_alloc, other.m_alloc);
+        } else {
+            assert(m_alloc == other.m_alloc);
+        }
+
+        std::swap(m_data, other.m_data);
+        std::swap(m_tiles, other.m_tiles);
+        std::swap(m_size, other.m_size);
+    }
+
+    /**
+     * @brief Resizes the multi_vector, value-initializing new elements.
+     *
+     * @param size The new size.
+     */
+    void resize(std::size_t size) {
+        if (size <= m_size) {
+            truncate(size);
+            return;
+        }
+
+        reserve(size);
+        for (; m_size < size; ++m_size) {
+            construct_row(m_data, m_size, helper_seq);
+        }
+    }
+
+    /**
+     * @brief Resizes the multi_vector, copying a value into new elements.
+     *
+     * @param size The new size.
+     * @param value The value of the new elements.
+     */
+    void resize(std::size_t size, const value_t& value) {
+        if (size <= m_size) {
+            truncate(size);
+            return;
+        }
+
+        reserve(size);
+        for (; m_size < size; ++m_size) {
+            std::apply([this](const Types&... values) { construct_row(m_data, m_size, helper_seq, values...); }, value);
+        }
+    }
+
+    /**
+     * @brief Allocates tiles for a specified number of elements.
+     *
+     * @param size The number of elements.
+     */
+    void reserve(std::size_t size) {
+        const std::size_t tiles = (size + Tile - 1) >> tile_shift;
+        if (tiles > m_tiles) {
+            reallocate(tiles);
+        }
+    }
+
+    /**
+     * @brief Frees the tiles which do not hold any element.
+     */
+    void shrink_to_fit() {
+        if (tile_count() != m_tiles) {
+            reallocate(tile_count());
+        }
+    }
+
+    /**
+     * @brief Removes the last element.
+     */
+    void pop_back() {
+        assert(!empty());
+        truncate(m_size - 1);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @tparam Args The types of the arguments.
+     * @param args The arguments to construct the new element.
+     * @return A tuple of references to the newly added elements.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == column_count)
+    value_ref_t emplace_back(Args&&... args) {
+        if (m_size == capacity()) {
+            reallocate(std::max<std::size_t>(1, m_tiles * 2));
+        }
+
+        construct_row(m_data, m_size, helper_seq, std::forward<decltype(args)>(args)...);
+        m_size += 1;
+
+        return back();
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(const value_t& value) {
+        std::apply([this](const Types&... values) { emplace_back(values...); }, value);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(value_t&& value) {
+        std::apply([this](Types&... values) { emplace_back(std::move(values)...); }, value);
+    }
+
+    /**
+     * @brief Removes the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return An iterator to the element following the removed element.
+     */
+    iterator_t erase(const_iterator_t pos) {
+        const std::size_t index = pos.pos();
+        assert(index < m_size);
+
+        shift_rows(index + 1, index, m_size - index - 1, helper_seq);
+        truncate(m_size - 1);
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Removes the element at a specified position by replacing it with the last element.
+     *
+     * The order of the elements is not preserved, but the erase runs in constant time.
+     *
+     * @param pos The position of the element.
+     * @return An iterator to the element which took the place of the removed element.
+     */
+    iterator_t erase_unordered(const_iterator_t pos) {
+        const std::size_t index = pos.pos();
+        assert(index < m_size);
+
+        const std::size_t last = m_size - 1;
+        if (index != last) {
+            move_row(last, index, helper_seq);
+        }
+        truncate(last);
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Removes all elements satisfying a predicate.
+     *
+     * The order of the remaining elements is preserved and the tiles are compacted in a single pass.
+     *
+     * @tparam Pred The type of the predicate.
+     * @param pred The predicate called with a tuple of const references to the element.
+     * @return The number of removed elements.
+     */
+    template <typename Pred>
+        requires std::predicate<Pred&, const_value_ref_t>
+    std::size_t erase_if(Pred pred) {
+        const std::size_t count = m_size;
+
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (pred(std::as_const(*this).at(i))) {
+                continue;
+            }
+
+            if (kept != i) {
+                move_row(i, kept, helper_seq);
+            }
+            kept += 1;
+        }
+
+        truncate(kept);
+        return count - kept;
+    }
+
+    /**
+     * @brief Appends rows given column by column.
+     *
+     * The tiles grow once and every column is copied a tile span at a time.
+     *
+     * @tparam Columns The types of the ranges, one for every column.
+     * @param columns The ranges of the new elements, all of the same size.
+     */
+    template <std::ranges::sized_range... Columns>
+        requires(sizeof...(Columns) == column_count)
+    void append(const Columns&... columns) {
+        insert_columns(m_size, columns...);
+    }
+
+    /**
+     * @brief Inserts rows given column by column at a specified position.
+     *
+     * @tparam Columns The types of the ranges, one for every column.
+     * @param pos The position of the first inserted row.
+     * @param columns The ranges of the new elements, all of the same size.
+     * @return An iterator to the first inserted row.
+     */
+    template <std::ranges::sized_range... Columns>
+        requires(sizeof...(Columns) == column_count)
+    iterator_t insert(const_iterator_t pos, const Columns&... columns) {
+        const std::size_t index = pos.pos();
+        insert_columns(index, columns...);
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Inserts copies of a row at a specified position.
+     *
+     * @param pos The position of the first inserted row.
+     * @param count The number of inserted rows.
+     * @param value The value of the inserted rows.
+     * @return An iterator to the first inserted row.
+     */
+    iterator_t insert(const_iterator_t pos, std::size_t count, const value_t& value) {
+        const std::size_t index = pos.pos();
+
+        if (count != 0) {
+            insert_rows(index, count, [&](auto column, std::size_t first) {
+                fill_column<column>(first, count, std::get<column>(value));
+            });
+        }
+
+        return begin() + static_cast<std::ptrdiff_t>(index);
+    }
+
+    /**
+     * @brief Sorts the elements by the values of a key column.
+     *
+     * The permutation is computed from the key column alone and then applied to every column with one gather per
+     * column. Arithmetic keys compared with `std::less` are gathered and sorted with an LSD radix sort.
+     *
+     * @tparam I The index of the key column.
+     * @tparam Compare The type of the comparator.
+     * @param cmp The comparator of the keys.
+     */
+    template <std::size_t I, typename Compare = std::less<>> void sort_by(Compare cmp = Compare()) {
+        permute(key_permutation<I, false>(cmp), helper_seq);
+    }
+
+    /**
+     * @brief Sorts the elements by the values of a key column and preserves the order of equal keys.
+     *
+     * @tparam I The index of the key column.
+     * @tparam Compare The type of the comparator.
+     * @param cmp The comparator of the keys.
+     */
+    template <std::size_t I, typename Compare = std::less<>> void stable_sort_by(Compare cmp = Compare()) {
+        permute(key_permutation<I, true>(cmp), helper_seq);
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning of the multi_vector.
+     *
+     * @return An iterator to the beginning of the multi_vector.
+     */
+    iterator_t begin() { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t begin() const { return const_iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t cbegin() const { return begin(); }
+
+    /**
+     * @brief Returns an iterator to the end of the multi_vector.
+     *
+     * @return An iterator to the end of the multi_vector.
+     */
+    iterator_t end() { return iterator_t(this, m_size); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t end() const { return const_iterator_t(this, m_size); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t cend() const { return end(); }
+
+private:
+    [[no_unique_address]] allocator_t m_alloc;
+    line* m_data        = nullptr;
+    std::size_t m_tiles = 0;
+    std::size_t m_size  = 0;
+
+    static_assert(tile_bytes % alignment == 0, "Every tile must start on a cache line");
+
+    static constexpr std::size_t line_count(std::size_t tiles) { return tiles * tile_bytes / alignment; }
+
+    template <std::size_t I> static element_t<I>* column(line* data, std::size_t tile) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<element_t<I>*>(
+            reinterpret_cast<std::byte*>(data) + tile * tile_bytes + column_offsets[I]
+        );
+    }
+
+    template <std::size_t I> static const element_t<I>* column(const line* data, std::size_t tile) {
+        // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+        return reinterpret_cast<const element_t<I>*>(
+            reinterpret_cast<const std::byte*>(data) + tile * tile_bytes + column_offsets[I]
+        );
+    }
+
+    template <std::size_t I, typename Line> static auto& element(Line* data, std::size_t pos) {
+        return column<I>(data, pos >> tile_shift)[pos & (Tile - 1)];
+    }
+
+    [[nodiscard]] std::size_t tile_rows(std::size_t tile) const {
+        return std::min(Tile, m_size - (tile << tile_shift));
+    }
+
+    /**
+     * @brief Moves the elements into a new allocation holding a specified number of tiles.
+     *
+     * @param tiles The number of tiles.
+     */
+    void reallocate(std::size_t tiles) {
+        assert(tiles >= tile_count());
+
+        line* data = tiles == 0 ? nullptr : allocator_traits::allocate(m_alloc, line_count(tiles));
+        for (std::size_t tile = 0; tile < tile_count(); ++tile) {
+            relocate_tile(data, m_data, tile, tile_rows(tile), helper_seq);
+        }
+
+        if (m_data != nullptr) {
+            allocator_traits::deallocate(m_alloc, m_data, line_count(m_tiles));
+        }
+
+        m_data  = data;
+        m_tiles = tiles;
+    }
+
+    /**
+     * @brief Destroys the elements past a specified size.
+     *
+     * @param size The new size.
+     */
+    void truncate(std::size_t size) {
+        assert(size <= m_size);
+
+        for (std::size_t pos = size; pos < m_size; ++pos) {
+            destroy_row(m_data, pos, helper_seq);
+        }
+
+        m_size = size;
+    }
+
+    /**
+     * @brief Destroys all elements and frees the tiles.
+     */
+    void release() {
+        truncate(0);
+        reallocate(0);
+    }
+
+    void copy_from(const basic_tiled_multi_vector& other) {
+        assert(m_size == 0);
+
+        reserve(other.m_size);
+        for (std::size_t tile = 0; tile < other.tile_count(); ++tile) {
+            copy_tile(m_data, other.m_data, tile, other.tile_rows(tile), helper_seq);
+        }
+        m_size = other.m_size;
+    }
+
+    template <typename Ref, typename Line, std::size_t... I>
+    static Ref get_all(Line* data, std::size_t pos, std::index_sequence<I...> /*unused*/) {
+        return Ref { element<I>(data, pos)... };
+    }
+
+    template <std::size_t... I, typename... Args>
+    static void construct_row(line* data, std::size_t pos, std::index_sequence<I...> /*unused*/, Args&&... args) {
+        if constexpr (sizeof...(Args) == 0) {
+            (std::construct_at(&element<I>(data, pos)), ...);
+        } else {
+            (std::construct_at(&element<I>(data, pos), std::forward<decltype(args)>(args)), ...);
+        }
+    }
+
+    template <std::size_t... I>
+    static void destroy_row(line* data, std::size_t pos, std::index_sequence<I...> /*unused*/) {
+        (std::destroy_at(&element<I>(data, pos)), ...);
+    }
+
+    template <std::size_t... I> void move_row(std::size_t from, std::size_t to, std::index_sequence<I...> /*unused*/) {
+        ((element<I>(m_data, to) = std::move(element<I>(m_data, from))), ...);
+    }
+
+    template <std::size_t... I>
+    static void copy_tile(
+        line* to, const line* from, std::size_t tile, std::size_t count, std::index_sequence<I...> /*unused*/
+    ) {
+        (std::uninitialized_copy_n(column<I>(from, tile), count, column<I>(to, tile)), ...);
+    }
+
+    /**
+     * @brief Calls a function for every tile span of a column covering a range of rows.
+     *
+     * @tparam I The index of the column.
+     * @tparam Fn The type of the function.
+     * @param pos The first row.
+     * @param count The number of rows.
+     * @param fn The function called with a pointer to the first element of the span and the length of the span.
+     */
+    template <std::size_t I, typename Fn> void for_each_span(std::size_t pos, std::size_t count, Fn fn) {
+        while (count != 0) {
+            const std::size_t chunk = std::min(count, Tile - (pos & (Tile - 1)));
+            fn(&element<I>(m_data, pos), chunk);
+
+            pos   += chunk;
+            count -= chunk;
+        }
+    }
+
+    /**
+     * @brief Moves a range of rows to a lower position, a tile span at a time.
+     *
+     * @tparam I The indices of the columns.
+     * @param from The position of the first source row.
+     * @param to The position of the first destination row, lower than `from`.
+     * @param count The number of rows.
+     */
+    template <std::size_t... I>
+    void shift_rows(std::size_t from, std::size_t to, std::size_t count, std::index_sequence<I...> /*unused*/) {
+        (shift_column<I>(from, to, count), ...);
+    }
+
+    template <std::size_t I> void shift_column(std::size_t from, std::size_t to, std::size_t count) {
+        assert(to <= from);
+
+        while (count != 0) {
+            const std::size_t chunk = std::min({ count, Tile - (from & (Tile - 1)), Tile - (to & (Tile - 1)) });
+
+            element_t<I>* source = &element<I>(m_data, from);
+            std::move(source, source + chunk, &element<I>(m_data, to));
+
+            from  += chunk;
+            to    += chunk;
+            count -= chunk;
+        }
+    }
+
+    /**
+     * @brief Inserts rows given column by column.
+     *
+     * @tparam Columns The types of the ranges.
+     * @param pos The position of the first inserted row.
+     * @param columns The ranges of the new elements.
+     */
+    template <typename... Columns> void insert_columns(std::size_t pos, const Columns&... columns) {
+        const auto sources = std::forward_as_tuple(columns...);
+
+        const auto count = static_cast<std::size_t>(std::ranges::size(std::get<0>(sources)));
+        assert(((static_cast<std::size_t>(std::ranges::size(columns)) == count) && ...));
+
+        if (count == 0) {
+            return;
+        }
+
+        insert_rows(pos, count, [&](auto column, std::size_t first) {
+            copy_column<column>(first, count, std::get<column>(sources));
+        });
+    }
+
+    /**
+     * @brief Constructs rows past the end and rotates them into place.
+     *
+     * If a column throws, the columns already constructed are destroyed and the size is unchanged.
+     *
+     * @tparam Fn The type of the function constructing a column.
+     * @param pos The position of the first inserted row.
+     * @param count The number of inserted rows.
+     * @param construct The function called with the column index and the first uninitialized row.
+     */
+    template <typename Fn> void insert_rows(std::size_t pos, std::size_t count, Fn construct) {
+        assert(pos <= m_size);
+
+        const std::size_t tiles = (m_size + count + Tile - 1) >> tile_shift;
+        if (tiles > m_tiles) {
+            reallocate(std::max(tiles, m_tiles * 2));
+        }
+
+        construct_columns(m_size, count, construct, helper_seq);
+
+        const std::size_t middle = m_size;
+        m_size += count;
+
+        if (pos != middle) {
+            rotate_rows(pos, middle, m_size, helper_seq);
+        }
+    }
+
+    template <typename Fn, std::size_t... I>
+    void construct_columns(std::size_t pos, std::size_t count, Fn& construct, std::index_sequence<I...> /*unused*/) {
+        std::size_t constructed = 0;
+
+        try {
+            ((construct(std::integral_constant<std::size_t, I>(), pos), constructed += 1), ...);
+        } catch (...) {
+            ((I < constructed ? destroy_column<I>(pos, count) : void()), ...);
+            throw;
+        }
+    }
+
+    template <std::size_t... I>
+    void rotate_rows(std::size_t first, std::size_t middle, std::size_t last, std::index_sequence<I...> /*unused*/) {
+        (rotate_column<I>(first, middle, last), ...);
+    }
+
+    template <std::size_t I> void rotate_column(std::size_t first, std::size_t middle, std::size_t last) {
+        auto column = get_container<I>();
+        auto start  = column.begin();
+
+        std::ranges::rotate(
+            start + static_cast<std::ptrdiff_t>(first),
+            start + static_cast<std::ptrdiff_t>(middle),
+            start + static_cast<std::ptrdiff_t>(last)
+        );
+    }
+
+    /**
+     * @brief Copies elements of a range into uninitialized rows of a column.
+     *
+     * @tparam I The index of the column.
+     * @tparam Range The type of the range.
+     * @param pos The first row.
+     * @param count The number of elements.
+     * @param range The range.
+     */
+    template <std::size_t I, typename Range> void copy_column(std::size_t pos, std::size_t count, const Range& range) {
+        auto it = std::ranges::begin(range);
+
+        std::size_t copied = 0;
+        try {
+            for_each_span<I>(pos, count, [&](element_t<I>* first, std::size_t chunk) {
+                const auto length = static_cast<std::iter_difference_t<decltype(it)>>(chunk);
+
+                it      = std::ranges::uninitialized_copy_n(std::move(it), length, first, first + chunk).in;
+                copied += chunk;
+            });
+        } catch (...) {
+            destroy_column<I>(pos, copied);
+            throw;
+        }
+    }
+
+    /**
+     * @brief Fills uninitialized rows of a column with copies of a value.
+     *
+     * @tparam I The index of the column.
+     * @param pos The first row.
+     * @param count The number of elements.
+     * @param value The value.
+     */
+    template <std::size_t I> void fill_column(std::size_t pos, std::size_t count, const element_t<I>& value) {
+        std::size_t filled = 0;
+        try {
+            for_each_span<I>(pos, count, [&](element_t<I>* first, std::size_t chunk) {
+                std::uninitialized_fill_n(first, chunk, value);
+                filled += chunk;
+            });
+        } catch (...) {
+            destroy_column<I>(pos, filled);
+            throw;
+        }
+    }
+
+    template <std::size_t I> void destroy_column(std::size_t pos, std::size_t count) {
+        for_each_span<I>(pos, count, [](element_t<I>* first, std::size_t chunk) { std::destroy_n(first, chunk); });
+    }
+
+    /**
+     * @brief Computes the permutation sorting the elements by a key column.
+     *
+     * @tparam I The index of the key column.
+     * @tparam Stable Whether equal keys must keep their relative order.
+     * @tparam Compare The type of the comparator.
+     * @param cmp The comparator of the keys.
+     * @return The permutation, where `permutation[i]` is the former position of the element at `i`.
+     */
+    template <std::size_t I, bool Stable, typename Compare>
+    std::vector<std::size_t> key_permutation(Compare& cmp) const {
+        if constexpr (detail::is_radix_sortable_v<element_t<I>, Compare>) {
+            // the radix sort reads the keys through a pointer, so the tile spans are gathered first
+            std::vector<element_t<I>> keys;
+            keys.reserve(m_size);
+            for (std::size_t t = 0; t < tile_count(); ++t) {
+                const auto span = tile<I>(t);
+                keys.insert(keys.end(), span.begin(), span.end());
+            }
+
+            return detail::sort_permutation<Stable>(keys.data(), keys.size(), cmp);
+        } else {
+            return detail::sort_permutation<Stable>(get_container<I>().begin(), m_size, cmp);
+        }
+    }
+
+    /**
+     * @brief Reorders every column by a permutation.
+     *
+     * @tparam I The indices of the columns.
+     * @param permutation The permutation, where `permutation[i]` is the former position of the element at `i`.
+     */
+    template <std::size_t... I>
+    void permute(const std::vector<std::size_t>& permutation, std::index_sequence<I...> /*unused*/) {
+        (permute_column<I>(permutation), ...);
+    }
+
+    template <std::size_t I> void permute_column(const std::vector<std::size_t>& permutation) {
+        const std::size_t count = permutation.size();
+        if (count == 0) {
+            return;
+        }
+
+        detail::scratch_buffer<element_t<I>, allocator_type> buffer(count, get_allocator());
+        for (std::size_t i = 0; i < count; ++i) {
+            buffer.emplace_back(std::move(element<I>(m_data, permutation[i])));
+        }
+
+        element_t<I>* source = buffer.data();
+        for_each_span<I>(0, count, [&](element_t<I>* first, std::size_t chunk) {
+            std::move(source, source + chunk, first);
+            source += chunk;
+        });
+    }
+
+    template <std::size_t... I>
+    static void
+    relocate_tile(line* to, line* from, std::size_t tile, std::size_t count, std::index_sequence<I...> /*unused*/) {
+        (detail::relocate_n(column<I>(from, tile), count, column<I>(to, tile)), ...);
+    }
+};
+
+/**
+ * @brief Alias for a tiled multi_vector using the default allocator.
+ *
+ * @tparam Tile The number of rows in a tile, a power of two.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t Tile, is_multi_vector_element... Types>
+using tiled_multi_vector = basic_tiled_multi_vector<Tile, std::allocator<std::byte>, Types...>;
+
+namespace pmr {
+
+    /**
+     * @brief tiled_multi_vector using a polymorphic allocator.
+     *
+     * @tparam Tile The number of rows in a tile, a power of two.
+     * @tparam Types The types of elements stored in the multi_vector.
+     */
+    template <std::size_t Tile, is_multi_vector_element... Types>
+    using tiled_multi_vector = basic_tiled_multi_vector<Tile, std::pmr::polymorphic_allocator<std::byte>, Types...>;
+
+}
+
+}
+
+#endif
@@ -0,0 +1,642 @@
+#ifndef KOUTIL_CONTAINER_VERSIONED_MULTI_VECTOR_H
+#define KOUTIL_CONTAINER_VERSIONED_MULTI_VECTOR_H
+
+#include "koutil/container/indexed_row_iterator.h"
+#include "koutil/container/multi_vector.h"
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::container {
+
+/**
+ * @brief Default number of rows in a chunk of a versioned_multi_vector.
+ */
+inline constexpr std::size_t default_version_chunk_size = 4096;
+
+namespace detail {
+
+    /**
+     * @brief Checks if a shared object is referenced only by the caller, so it can be modified in place.
+     *
+     * The fence orders the modification after the reads of the thread which released the last other reference.
+     *
+     * @tparam T The type of the object.
+     * @param ptr The pointer to the object.
+     * @return True if the caller holds the only reference, false otherwise.
+     */
+    template <typename T> bool is_exclusive(const std::shared_ptr<T>& ptr) {
+        if (ptr.use_count() != 1) {
+            return false;
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return true;
+    }
+
+    /**
+     * @brief Fixed-capacity chunk of a column of a versioned_multi_vector.
+     *
+     * The elements live in raw storage inside the chunk, so a chunk is one allocation and `bool` elements are stored
+     * as plain objects which can be referenced and viewed by a span.
+     *
+     * @tparam T The type of elements.
+     * @tparam Capacity The maximum number of elements.
+     */
+    template <typename T, std::size_t Capacity> class version_chunk {
+    public:
+        version_chunk() = default;
+
+        version_chunk(const version_chunk& other) {
+            std::uninitialized_copy_n(other.data(), other.m_size, data());
+            m_size = other.m_size;
+        }
+
+        version_chunk(version_chunk&&)                 = delete;
+        version_chunk& operator=(const version_chunk&) = delete;
+        version_chunk& operator=(version_chunk&&)      = delete;
+
+        ~version_chunk() { std::destroy_n(data(), m_size); }
+
+        template <typename... Args> T& emplace_back(Args&&... args) {
+            assert(m_size < Capacity);
+
+            T* element = std::construct_at(data() + m_size, std::forward<Args>(args)...);
+            m_size += 1;
+            return *element;
+        }
+
+        void pop_back() {
+            assert(m_size > 0);
+
+            m_size -= 1;
+            std::destroy_at(data() + m_size);
+        }
+
+        [[nodiscard]] std::size_t size() const { return m_size; }
+
+        T* data() {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return std::launder(reinterpret_cast<T*>(m_storage.data()));
+        }
+
+        const T* data() const {
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+            return std::launder(reinterpret_cast<const T*>(m_storage.data()));
+        }
+
+        T& operator[](std::size_t pos) {
+            assert(pos < m_size);
+            return data()[pos];
+        }
+
+        const T& operator[](std::size_t pos) const {
+            assert(pos < m_size);
+            return data()[pos];
+        }
+
+        std::span<T> span() { return { data(), m_size }; }
+
+        std::span<const T> span() const { return { data(), m_size }; }
+
+    private:
+        alignas(T) std::array<std::byte, sizeof(T) * Capacity> m_storage;
+        std::size_t m_size = 0;
+    };
+
+    /**
+     * @brief One version of the rows of a versioned_multi_vector.
+     *
+     * Every column is a table of chunks shared between the versions which did not modify them.
+     *
+     * @tparam ChunkSize The number of rows in a chunk.
+     * @tparam Types The types of elements.
+     */
+    template <std::size_t ChunkSize, typename... Types> struct version_state {
+        template <typename T> using chunk_t = version_chunk<T, ChunkSize>;
+
+        template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+        static constexpr std::size_t chunk_shift = std::countr_zero(ChunkSize);
+
+        std::size_t size = 0;
+        std::tuple<std::vector<std::shared_ptr<chunk_t<Types>>>...> chunks;
+
+        [[nodiscard]] std::size_t chunk_count() const { return (size + ChunkSize - 1) >> chunk_shift; }
+
+        template <std::size_t I> const element_t<I>& get(std::size_t pos) const {
+            return (*std::get<I>(chunks)[pos >> chunk_shift])[pos & (ChunkSize - 1)];
+        }
+
+        template <std::size_t I> std::span<const element_t<I>> chunk(std::size_t chunk) const {
+            assert(chunk < chunk_count());
+            return std::as_const(*std::get<I>(chunks)[chunk]).span();
+        }
+    };
+
+}
+
+/**
+ * @brief Immutable version of a versioned_multi_vector.
+ *
+ * Copying a snapshot only increments a reference count. The rows stay valid and unchanged while the snapshot exists,
+ * whatever the versioned_multi_vector does later, so a snapshot can be read from any thread without locking.
+ *
+ * @tparam ChunkSize The number of rows in a chunk.
+ * @tparam Types The types of elements.
+ */
+template <std::size_t ChunkSize, typename... Types> class multi_vector_snapshot {
+private:
+    using state_t = detail::version_state<ChunkSize, Types...>;
+
+    static constexpr auto helper_seq = std::make_index_sequence<sizeof...(Types)>();
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+public:
+    using value_ref_t       = std::tuple<const Types&...>;
+    using const_value_ref_t = value_ref_t;
+    using value_t           = std::tuple<Types...>;
+
+    using iterator_t       = indexed_row_iterator<const multi_vector_snapshot>;
+    using const_iterator_t = iterator_t;
+
+    /**
+     * @brief Constructs an empty snapshot.
+     */
+    multi_vector_snapshot()
+        : m_state(std::make_shared<const state_t>()) { }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_state->size; }
+
+    /**
+     * @brief Checks if the snapshot is empty.
+     *
+     * @return True if the snapshot is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_state->size == 0; }
+
+    /**
+     * @brief Returns the number of chunks holding at least one element.
+     *
+     * @return The number of chunks.
+     */
+    [[nodiscard]] std::size_t chunk_count() const { return m_state->chunk_count(); }
+
+    /**
+     * @brief Returns the elements of a column stored in a chunk.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The span over the elements.
+     */
+    template <std::size_t I> std::span<const element_t<I>> chunk(std::size_t chunk) const {
+        return m_state->template chunk<I>(chunk);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    value_ref_t at(std::size_t pos) const {
+        assert(pos < size());
+        return get_all(pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the first element.
+     *
+     * @return Const reference to the first element.
+     */
+    value_ref_t front() const {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a const reference to the last element.
+     *
+     * @return Const reference to the last element.
+     */
+    value_ref_t back() const {
+        assert(!empty());
+        return at(size() - 1);
+    }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the snapshot.
+     *
+     * @return A const iterator to the beginning of the snapshot.
+     */
+    iterator_t begin() const { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the end of the snapshot.
+     *
+     * @return A const iterator to the end of the snapshot.
+     */
+    iterator_t end() const { return iterator_t(this, size()); }
+
+private:
+    std::shared_ptr<const state_t> m_state;
+
+    explicit multi_vector_snapshot(std::shared_ptr<const state_t> state)
+        : m_state(std::move(state)) { }
+
+    template <std::size_t... I> value_ref_t get_all(std::size_t pos, std::index_sequence<I...> /*unused*/) const {
+        return value_ref_t { m_state->template get<I>(pos)... };
+    }
+
+    template <std::size_t C, typename... U>
+        requires(std::has_single_bit(C) && sizeof...(U) != 0 && (!std::is_void_v<U> && ...))
+    friend class basic_versioned_multi_vector;
+};
+
+/**
+ * @brief Class representing a multi_vector with copy-on-write snapshots.
+ *
+ * The columns are stored in chunks shared between versions. `snapshot()` returns the current version in O(1), and a
+ * later modification clones only the chunk table and the chunks of the columns it touches, and only while a snapshot
+ * still references them. Modifying without any snapshot alive works in place.
+ *
+ * The versioned_multi_vector itself is owned by one writer thread, snapshots can be passed to and read by any thread.
+ *
+ * @tparam ChunkSize The number of rows in a chunk, a power of two.
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <std::size_t ChunkSize, typename... Types>
+    requires(std::has_single_bit(ChunkSize) && sizeof...(Types) != 0 && (!std::is_void_v<Types> && ...))
+class basic_versioned_multi_vector {
+private:
+    static constexpr std::size_t column_count = sizeof...(Types);
+
+    using state_t = detail::version_state<ChunkSize, Types...>;
+
+    template <typename T> using chunk_t = typename state_t::template chunk_t<T>;
+
+    template <std::size_t I> using element_t = std::tuple_element_t<I, std::tuple<Types...>>;
+
+    static constexpr std::size_t chunk_shift = state_t::chunk_shift;
+
+    static constexpr auto helper_seq = std::make_index_sequence<column_count>();
+
+public:
+    using value_ref_t       = std::tuple<Types&...>;
+    using const_value_ref_t = std::tuple<const Types&...>;
+    using value_t           = std::tuple<Types...>;
+
+    using snapshot_t = multi_vector_snapshot<ChunkSize, Types...>;
+
+    using iterator_t       = indexed_row_iterator<basic_versioned_multi_vector>;
+    using const_iterator_t = indexed_row_iterator<const basic_versioned_multi_vector>;
+
+    /**
+     * @brief The number of rows in a chunk.
+     */
+    static constexpr std::size_t chunk_size = ChunkSize;
+
+    basic_versioned_multi_vector()
+        : m_state(std::make_shared<state_t>()) { }
+
+    /**
+     * @brief Copies the current version, sharing every chunk with the other multi_vector.
+     *
+     * @param other The other multi_vector.
+     */
+    basic_versioned_multi_vector(const basic_versioned_multi_vector& other)
+        : m_state(other.m_state) { }
+
+    basic_versioned_multi_vector(basic_versioned_multi_vector&& other)
+        : m_state(std::exchange(other.m_state, std::make_shared<state_t>())) { }
+
+    basic_versioned_multi_vector& operator=(const basic_versioned_multi_vector& other) {
+        m_state = other.m_state;
+        return *this;
+    }
+
+    basic_versioned_multi_vector& operator=(basic_versioned_multi_vector&& other) {
+        if (&other != this) {
+            m_state = std::exchange(other.m_state, std::make_shared<state_t>());
+        }
+        return *this;
+    }
+
+    /**
+     * @brief Returns an immutable view of the current version.
+     *
+     * @return The snapshot.
+     */
+    [[nodiscard]] snapshot_t snapshot() const { return snapshot_t(m_state); }
+
+    /**
+     * @brief Returns the number of elements.
+     *
+     * @return The number of elements.
+     */
+    [[nodiscard]] std::size_t size() const { return m_state->size; }
+
+    /**
+     * @brief Checks if the multi_vector is empty.
+     *
+     * @return True if the multi_vector is empty, false otherwise.
+     */
+    [[nodiscard]] bool empty() const { return m_state->size == 0; }
+
+    /**
+     * @brief Returns the number of chunks holding at least one element.
+     *
+     * @return The number of chunks.
+     */
+    [[nodiscard]] std::size_t chunk_count() const { return m_state->chunk_count(); }
+
+    /**
+     * @brief Returns the elements of a column stored in a chunk, cloning the chunk if a snapshot shares it.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The span over the elements.
+     */
+    template <std::size_t I> std::span<element_t<I>> chunk(std::size_t chunk) {
+        assert(chunk < chunk_count());
+        return writable_chunk<I>(chunk).span();
+    }
+
+    /**
+     * @brief Returns the elements of a column stored in a chunk.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The span over the elements.
+     */
+    template <std::size_t I> std::span<const element_t<I>> chunk(std::size_t chunk) const {
+        return m_state->template chunk<I>(chunk);
+    }
+
+    /**
+     * @brief Returns a reference to an element of a column, cloning only the chunk of that column.
+     *
+     * @tparam I The index of the column.
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    template <std::size_t I> element_t<I>& get(std::size_t pos) {
+        assert(pos < size());
+        return writable_chunk<I>(pos >> chunk_shift)[pos & (ChunkSize - 1)];
+    }
+
+    /**
+     * @brief Returns a const reference to an element of a column.
+     *
+     * @tparam I The index of the column.
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    template <std::size_t I> const element_t<I>& get(std::size_t pos) const {
+        assert(pos < size());
+        return m_state->template get<I>(pos);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * The chunks of every column holding the row are cloned if a snapshot shares them. Use `get` to touch one column.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t at(std::size_t pos) {
+        assert(pos < size());
+        return get_all<value_ref_t>(*this, pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t at(std::size_t pos) const {
+        assert(pos < size());
+        return get_all<const_value_ref_t>(*this, pos, helper_seq);
+    }
+
+    /**
+     * @brief Returns a reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Reference to the element.
+     */
+    value_ref_t operator[](std::size_t pos) { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the element at a specified position.
+     *
+     * @param pos The position of the element.
+     * @return Const reference to the element.
+     */
+    const_value_ref_t operator[](std::size_t pos) const { return at(pos); }
+
+    /**
+     * @brief Returns a const reference to the first element.
+     *
+     * @return Const reference to the first element.
+     */
+    const_value_ref_t front() const {
+        assert(!empty());
+        return at(0);
+    }
+
+    /**
+     * @brief Returns a const reference to the last element.
+     *
+     * @return Const reference to the last element.
+     */
+    const_value_ref_t back() const {
+        assert(!empty());
+        return at(size() - 1);
+    }
+
+    /**
+     * @brief Removes all elements, the snapshots keep their rows.
+     */
+    void clear() { m_state = std::make_shared<state_t>(); }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * If a constructor throws, the elements already constructed and the chunks added for the new row are removed, so
+     * the columns stay aligned.
+     *
+     * @tparam Args The types of the arguments.
+     * @param args The arguments to construct the new element.
+     */
+    template <typename... Args>
+        requires(sizeof...(Args) == column_count)
+    void emplace_back(Args&&... args) {
+        state_t& state = writable_state();
+
+        emplace_back_impl(state, helper_seq, std::forward<decltype(args)>(args)...);
+        state.size += 1;
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(const value_t& value) {
+        std::apply([this](const Types&... values) { emplace_back(values...); }, value);
+    }
+
+    /**
+     * @brief Adds a new element to the end of the multi_vector.
+     *
+     * @param value The value to add.
+     */
+    void push_back(value_t&& value) {
+        std::apply([this](Types&... values) { emplace_back(std::move(values)...); }, value);
+    }
+
+    /**
+     * @brief Removes the last element.
+     */
+    void pop_back() {
+        assert(!empty());
+        pop_back_impl(helper_seq);
+    }
+
+    /**
+     * @brief Returns an iterator to the beginning of the multi_vector.
+     *
+     * @return An iterator to the beginning of the multi_vector.
+     */
+    iterator_t begin() { return iterator_t(this, 0); }
+
+    /**
+     * @brief Returns a const iterator to the beginning of the multi_vector.
+     *
+     * @return A const iterator to the beginning of the multi_vector.
+     */
+    const_iterator_t begin() const { return const_iterator_t(this, 0); }
+
+    /**
+     * @brief Returns an iterator to the end of the multi_vector.
+     *
+     * @return An iterator to the end of the multi_vector.
+     */
+    iterator_t end() { return iterator_t(this, size()); }
+
+    /**
+     * @brief Returns a const iterator to the end of the multi_vector.
+     *
+     * @return A const iterator to the end of the multi_vector.
+     */
+    const_iterator_t end() const { return const_iterator_t(this, size()); }
+
+private:
+    std::shared_ptr<state_t> m_state;
+
+    /**
+     * @brief Returns the current version, cloning its chunk tables if a snapshot shares it.
+     *
+     * @return The current version.
+     */
+    state_t& writable_state() {
+        if (!detail::is_exclusive(m_state)) {
+            m_state = std::make_shared<state_t>(*m_state);
+        }
+
+        return *m_state;
+    }
+
+    /**
+     * @brief Returns a chunk of a column, cloning it if another version shares it.
+     *
+     * @tparam I The index of the column.
+     * @param chunk The index of the chunk.
+     * @return The chunk.
+     */
+    template <std::size_t I> chunk_t<element_t<I>>& writable_chunk(std::size_t chunk) {
+        auto& ptr = std::get<I>(writable_state().chunks)[chunk];
+        if (!detail::is_exclusive(ptr)) {
+            ptr = std::make_shared<chunk_t<element_t<I>>>(*ptr);
+        }
+
+        return *ptr;
+    }
+
+    template <typename Ref, typename Self, std::size_t... I>
+    static Ref get_all(Self& self, std::size_t pos, std::index_sequence<I...> /*unused*/) {
+        return Ref { self.template get<I>(pos)... };
+    }
+
+    template <typename... Args, std::size_t... I>
+    void emplace_back_impl(state_t& state, std::index_sequence<I...> /*unused*/, Args&&... args) {
+        const std::size_t last     = state.size >> chunk_shift;
+        const bool needs_chunks    = (state.size & (ChunkSize - 1)) == 0;
+        std::size_t added_chunks   = 0;
+        std::size_t added_elements = 0;
+
+        try {
+            if (needs_chunks) {
+                ((std::get<I>(state.chunks).push_back(std::make_shared<chunk_t<element_t<I>>>()), added_chunks += 1),
+                 ...);
+            }
+
+            ((writable_chunk<I>(last).emplace_back(std::forward<decltype(args)>(args)), added_elements += 1), ...);
+        } catch (...) {
+            // the chunks holding the new elements are exclusive, they were added or cloned above
+            ((I < added_elements ? std::get<I>(state.chunks)[last]->pop_back() : void()), ...);
+            ((I < added_chunks ? std::get<I>(state.chunks).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    template <std::size_t... I> void pop_back_impl(std::index_sequence<I...> /*unused*/) {
+        state_t& state         = writable_state();
+        const std::size_t last = (state.size - 1) >> chunk_shift;
+
+        (writable_chunk<I>(last).pop_back(), ...);
+
+        state.size -= 1;
+        if ((state.size & (ChunkSize - 1)) == 0) {
+            (std::get<I>(state.chunks).pop_back(), ...);
+        }
+    }
+};
+
+/**
+ * @brief Alias for a versioned multi_vector with the default chunk size.
+ *
+ * @tparam Types The types of elements stored in the multi_vector.
+ */
+template <is_multi_vector_element... Types>
+using versioned_multi_vector = basic_versioned_multi_vector<default_version_chunk_size, Types...>;
+
+}
+
+#endif
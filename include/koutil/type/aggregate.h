@@ -0,0 +1,169 @@
+#ifndef KOUTIL_TYPE_AGGREGATE_H
+#define KOUTIL_TYPE_AGGREGATE_H
+
+#include "koutil/type/types.h"
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace koutil::type {
+
+/**
+ * @brief The largest number of fields of an aggregate supported by `aggregate_arity`.
+ */
+inline constexpr std::size_t aggregate_max_fields = 16;
+
+namespace detail {
+
+    /**
+     * @brief Placeholder convertible to the type of any field, used only in unevaluated contexts.
+     */
+    struct any_field {
+        template <typename T> operator T() const;
+    };
+
+    template <typename T, std::size_t N> consteval bool is_brace_constructible() {
+        return []<std::size_t... I>(std::index_sequence<I...> /*unused*/) {
+            return requires { T { (static_cast<void>(I), any_field {})... }; };
+        }(std::make_index_sequence<N>());
+    }
+
+    template <typename T, std::size_t N = aggregate_max_fields> consteval std::size_t aggregate_arity_impl() {
+        if constexpr (N == 0 || is_brace_constructible<T, N>()) {
+            return N;
+        } else {
+            return aggregate_arity_impl<T, N - 1>();
+        }
+    }
+
+    /**
+     * @brief Wrapper of an object which is only declared, its fields are addressable in constant expressions.
+     *
+     * @tparam T The type of the object.
+     */
+    template <typename T> struct fake_object_wrapper {
+        T value;
+    };
+
+    template <typename T> extern const fake_object_wrapper<T> fake_object;
+
+}
+
+/**
+ * @brief Number of fields of an aggregate.
+ *
+ * The fields are counted by brace-initializing the aggregate with placeholders. Fields of array type are counted
+ * once per element and are not supported.
+ *
+ * @tparam T The aggregate type.
+ */
+template <typename T>
+    requires(std::is_aggregate_v<T>)
+inline constexpr std::size_t aggregate_arity_v = detail::aggregate_arity_impl<T>();
+
+/**
+ * @brief Returns a tuple of references to the fields of an aggregate.
+ *
+ * @tparam T The aggregate type, const-qualified for const references.
+ * @param value The aggregate.
+ * @return The tuple of references, in the order of declaration.
+ */
+template <typename T>
+    requires(std::is_aggregate_v<std::remove_const_t<T>>)
+constexpr auto tie_fields(T& value) {
+    constexpr std::size_t N = aggregate_arity_v<std::remove_const_t<T>>;
+    static_assert(N != 0 && N <= aggregate_max_fields, "The aggregate must have between 1 and 16 fields");
+
+    if constexpr (N == 1) {
+        auto& [f0] = value;
+        return std::tie(f0);
+    } else if constexpr (N == 2) {
+        auto& [f0, f1] = value;
+        return std::tie(f0, f1);
+    } else if constexpr (N == 3) {
+        auto& [f0, f1, f2] = value;
+        return std::tie(f0, f1, f2);
+    } else if constexpr (N == 4) {
+        auto& [f0, f1, f2, f3] = value;
+        return std::tie(f0, f1, f2, f3);
+    } else if constexpr (N == 5) {
+        auto& [f0, f1, f2, f3, f4] = value;
+        return std::tie(f0, f1, f2, f3, f4);
+    } else if constexpr (N == 6) {
+        auto& [f0, f1, f2, f3, f4, f5] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5);
+    } else if constexpr (N == 7) {
+        auto& [f0, f1, f2, f3, f4, f5, f6] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6);
+    } else if constexpr (N == 8) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7);
+    } else if constexpr (N == 9) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8);
+    } else if constexpr (N == 10) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9);
+    } else if constexpr (N == 11) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10);
+    } else if constexpr (N == 12) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11);
+    } else if constexpr (N == 13) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12);
+    } else if constexpr (N == 14) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13);
+    } else if constexpr (N == 15) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14);
+    } else if constexpr (N == 16) {
+        auto& [f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15] = value;
+        return std::tie(f0, f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13, f14, f15);
+    }
+}
+
+namespace detail {
+
+    template <typename Tuple> struct tuple_fields;
+
+    template <typename... T> struct tuple_fields<std::tuple<T&...>> {
+        using type = types<std::remove_cv_t<T>...>;
+    };
+
+}
+
+/**
+ * @brief Types of the fields of an aggregate.
+ *
+ * @tparam T The aggregate type.
+ */
+template <typename T>
+using aggregate_types_t = detail::tuple_fields<decltype(tie_fields(std::declval<T&>()))>::type;
+
+/**
+ * @brief Index of a field of an aggregate given by a pointer to member.
+ *
+ * @tparam T The aggregate type.
+ * @tparam Member The pointer to the field.
+ */
+template <typename T, auto Member>
+    requires(std::is_member_object_pointer_v<decltype(Member)>)
+inline constexpr std::size_t aggregate_field_index_v = [] {
+    const auto fields = tie_fields(detail::fake_object<T>.value);
+    const void* field = &(detail::fake_object<T>.value.*Member);
+
+    std::size_t index = std::tuple_size_v<decltype(fields)>;
+    [&]<std::size_t... I>(std::index_sequence<I...> /*unused*/) {
+        ((index = static_cast<const void*>(&std::get<I>(fields)) == field ? I : index), ...);
+    }(std::make_index_sequence<std::tuple_size_v<decltype(fields)>>());
+
+    return index;
+}();
+
+}
+
+#endif
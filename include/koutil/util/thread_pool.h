@@ -0,0 +1,199 @@
+#ifndef KOUTIL_UTIL_THREAD_POOL_H
+#define KOUTIL_UTIL_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace koutil::util {
+
+/**
+ * @brief A fixed set of worker threads executing batches of indexed tasks.
+ *
+ * The thread calling `run` takes part in its own batch, so nested calls from inside a task cannot deadlock.
+ */
+class thread_pool {
+public:
+    /**
+     * @brief Returns the default number of worker threads.
+     *
+     * One hardware thread is left for the caller of `run`.
+     *
+     * @return The number of worker threads.
+     */
+    static std::size_t default_thread_count() {
+        const std::size_t hardware = std::thread::hardware_concurrency();
+        return hardware > 1 ? hardware - 1 : 0;
+    }
+
+    /**
+     * @brief Constructs a thread pool.
+     *
+     * @param thread_count The number of worker threads.
+     */
+    explicit thread_pool(std::size_t thread_count = default_thread_count()) {
+        m_workers.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            m_workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    thread_pool(const thread_pool&)            = delete;
+    thread_pool(thread_pool&&)                 = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+    thread_pool& operator=(thread_pool&&)      = delete;
+
+    /**
+     * @brief Stops and joins the worker threads.
+     */
+    ~thread_pool() {
+        {
+            std::lock_guard lock(m_mutex);
+            m_stop = true;
+        }
+        m_work_cv.notify_all();
+
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * @brief Returns the number of worker threads.
+     *
+     * @return The number of worker threads.
+     */
+    [[nodiscard]] std::size_t size() const { return m_workers.size(); }
+
+    /**
+     * @brief Calls a function for every index in `[0, count)` and waits for all calls to finish.
+     *
+     * If a call throws, the remaining indices are skipped and the first exception is rethrown.
+     *
+     * @tparam Fn The type of the function.
+     * @param count The number of indices.
+     * @param fn The function called with an index.
+     */
+    template <typename Fn>
+        requires std::is_invocable_v<Fn&, std::size_t>
+    void run(std::size_t count, Fn&& fn) {
+        if (count == 0) {
+            return;
+        }
+
+        batch work(count, std::addressof(fn), [](const void* ptr, std::size_t index) {
+            // the pointer is cast back to the type of the function, which restores its constness
+            // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+            (*static_cast<std::remove_reference_t<Fn>*>(const_cast<void*>(ptr)))(index);
+        });
+
+        if (count > 1 && !m_workers.empty()) {
+            {
+                std::lock_guard lock(m_mutex);
+                m_batches.push_back(&work);
+            }
+            m_work_cv.notify_all();
+        }
+
+        work.execute();
+
+        {
+            std::unique_lock lock(m_mutex);
+            std::erase(m_batches, &work);
+            m_done_cv.wait(lock, [&] { return work.active == 0; });
+        }
+
+        if (work.error) {
+            std::rethrow_exception(work.error);
+        }
+    }
+
+private:
+    struct batch {
+        batch(std::size_t task_count, const void* task_fn, void (*task_invoke)(const void*, std::size_t))
+            : count(task_count)
+            , fn(task_fn)
+            , invoke(task_invoke) { }
+
+        std::size_t count;
+        const void* fn;
+        void (*invoke)(const void*, std::size_t);
+
+        std::atomic<std::size_t> next { 0 };
+        std::size_t active = 0;
+
+        std::mutex error_mutex;
+        std::exception_ptr error;
+
+        void execute() noexcept {
+            for (std::size_t index = next.fetch_add(1); index < count; index = next.fetch_add(1)) {
+                try {
+                    invoke(fn, index);
+                } catch (...) {
+                    std::lock_guard lock(error_mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                    next.store(count);
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> m_workers;
+    std::deque<batch*> m_batches;
+
+    std::mutex m_mutex;
+    std::condition_variable m_work_cv;
+    std::condition_variable m_done_cv;
+    bool m_stop = false;
+
+    void worker_loop() {
+        std::unique_lock lock(m_mutex);
+
+        while (true) {
+            m_work_cv.wait(lock, [&] { return m_stop || !m_batches.empty(); });
+            if (m_stop) {
+                return;
+            }
+
+            batch* work = m_batches.front();
+            work->active += 1;
+
+            lock.unlock();
+            work->execute();
+            lock.lock();
+
+            // every index of the batch is taken
+            std::erase(m_batches, work);
+
+            work->active -= 1;
+            if (work->active == 0) {
+                m_done_cv.notify_all();
+            }
+        }
+    }
+};
+
+/**
+ * @brief Returns the thread pool shared by the parallel algorithms.
+ *
+ * @return The thread pool.
+ */
+inline thread_pool& default_thread_pool() {
+    static thread_pool pool;
+    return pool;
+}
+
+}
+
+#endif
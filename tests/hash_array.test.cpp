@@ -1,5 +1,8 @@
+#include "koutil/container/flat_hash_array.h"
 #include "koutil/container/hash_array.h"
 #include "koutil/container/template_hash_array.h"
+#include <algorithm>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <cstdint>
@@ -8,6 +11,7 @@
 #include <functional>
 #include <koutil/container/multi_vector.h>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -98,6 +102,9 @@ std::size_t insert_key(const CustomKeyTemplate& key, std::vector<int>& storage,
 using hash_array_t = hash_array<CustomKey, std::size_t, KeyAdapter, HashKey>;
 using template_hash_array_t
     = template_hash_array<CustomKeyTemplate, std::size_t, CustomKeyTag, KeyAdapterTemplate, HashKeyTemplate>;
+using flat_hash_array_t = flat_hash_array<CustomKey, std::size_t, KeyAdapter, HashKey>;
+using flat_template_hash_array_t
+    = flat_template_hash_array<CustomKeyTemplate, std::size_t, CustomKeyTag, KeyAdapterTemplate, HashKeyTemplate>;
 
 TEST_CASE("[HASH_ARRAY][CONSTRUCTORS]") {
 
@@ -468,3 +475,432 @@ TEST_CASE("[TEMPLATE_HASH_ARRAY][ITERATOR]") {
 
     CHECK_EQ(find, 0b111);
 }
+
+TEST_CASE("[FLAT_HASH_ARRAY][CONSTRUCTORS]") {
+
+    std::vector<int> storage;
+
+    CustomKey a { .a = 1, .b = 2 };
+    CustomKey b { .a = 2, .b = 4 };
+    CustomKey c { .a = 3, .b = 6 };
+
+    auto a_index = insert_key(a, storage);
+    auto b_index = insert_key(b, storage);
+    auto c_index = insert_key(c, storage);
+
+    KeyAdapter adapter { storage };
+
+    SUBCASE("[FLAT_HASH_ARRAY][CONSTRUCTOR][INIT]") {
+        flat_hash_array_t array(20);
+        CHECK_EQ(array.bucket_count(), 32);
+        CHECK(array.empty());
+    }
+
+    SUBCASE("[FLAT_HASH_ARRAY][CONSTRUCTOR][COPY]") {
+        flat_hash_array_t a_array;
+        CHECK(a_array.try_insert(a, a_index, adapter));
+        CHECK(a_array.try_insert(b, b_index, adapter));
+
+        flat_hash_array_t b_array = a_array;
+        CHECK(b_array.try_insert(c, c_index, adapter));
+        REQUIRE_EQ(b_array.size(), 3);
+        CHECK_EQ(a_array.find(c, adapter), a_array.end());
+
+        b_array = a_array;
+        CHECK_EQ(b_array.size(), 2);
+
+        flat_hash_array_t c_array = std::move(b_array);
+        CHECK_EQ(c_array.size(), 2);
+        CHECK_EQ(*c_array.find(b, adapter), b_index);
+    }
+}
+
+TEST_CASE("[FLAT_HASH_ARRAY][OPERATIONS]") {
+
+    std::vector<int> storage;
+    KeyAdapter adapter { storage };
+
+    flat_hash_array_t array;
+    std::unordered_map<std::size_t, std::size_t> expected;
+
+    for (int i = 0; i < 1000; ++i) {
+        const CustomKey key { .a = i, .b = i % 10 };
+        const auto index = insert_key(key, storage);
+
+        CHECK(array.try_insert(key, index, adapter));
+        CHECK_FALSE(array.try_insert(key, index, adapter));
+        expected[index] = index;
+    }
+
+    REQUIRE_EQ(array.size(), 1000);
+    CHECK_GE(array.bucket_count(), 1024);
+
+    for (int i = 0; i < 1000; i += 2) {
+        array.erase({ .a = i, .b = i % 10 }, adapter);
+        expected.erase(static_cast<std::size_t>(i));
+    }
+    array.erase({ .a = -1, .b = 0 }, adapter);
+
+    REQUIRE_EQ(array.size(), 500);
+
+    for (int i = 0; i < 1000; ++i) {
+        auto it = array.find({ .a = i, .b = i % 10 }, adapter);
+        if (i % 2 == 0) {
+            CHECK_EQ(it, array.end());
+        } else {
+            REQUIRE_NE(it, array.end());
+            CHECK_EQ(*it, static_cast<std::size_t>(i));
+        }
+    }
+
+    CHECK(array.try_set({ .a = 1, .b = 1 }, 1, adapter));
+    CHECK_FALSE(array.try_set({ .a = 0, .b = 0 }, 0, adapter));
+
+    std::size_t count = 0;
+    for (auto&& index : array) {
+        CHECK(expected.contains(index));
+        count += 1;
+    }
+    CHECK_EQ(count, 500);
+
+    // reinserting into the deleted slots
+    for (int i = 0; i < 1000; i += 2) {
+        CHECK(array.try_insert({ .a = i, .b = i % 10 }, static_cast<std::size_t>(i), adapter));
+    }
+    CHECK_EQ(array.size(), 1000);
+
+    array.clear();
+    CHECK(array.empty());
+    CHECK_EQ(array.begin(), array.end());
+}
+
+TEST_CASE("[FLAT_TEMPLATE_HASH_ARRAY][OPERATIONS]") {
+
+    std::vector<int> storage;
+    std::vector<CustomKeyTag> tags;
+
+    constexpr CustomKeyTemplate a { .a = 1, .b = 2, .tag = CustomKeyTag::ONE };
+    constexpr CustomKeyTemplate b { .a = 2, .b = 4, .tag = CustomKeyTag::TWO };
+    constexpr CustomKeyTemplate c { .a = 3, .b = 6, .tag = CustomKeyTag::THREE };
+
+    auto a_index = insert_key(a, storage, tags);
+    auto b_index = insert_key(b, storage, tags);
+    auto c_index = insert_key(c, storage, tags);
+
+    KeyAdapterTemplate adapter { storage, tags };
+
+    flat_template_hash_array_t array;
+    CHECK(array.try_insert<a.tag>(a, a_index, adapter));
+    CHECK(array.try_insert<b.tag>(b, b_index, adapter));
+    CHECK(array.try_insert<c.tag>(c, c_index, adapter));
+    CHECK_FALSE(array.try_insert<c.tag>(c, c_index, adapter));
+
+    auto it = array.find<b.tag>(b, adapter);
+    REQUIRE_NE(it, array.end());
+    CHECK_EQ(*it, b_index);
+
+    CHECK_EQ(array.find<c.tag>(b, adapter), array.end());
+    CHECK_FALSE(array.try_set<c.tag>(b, 5, adapter));
+
+    array.erase<a.tag>(a, adapter);
+    array.erase<b.tag>(b, adapter);
+    CHECK_EQ(array.size(), 1);
+
+    const auto& constant = array;
+    auto cit             = constant.find<c.tag>(c, adapter);
+    REQUIRE_NE(cit, constant.end());
+    CHECK_EQ(*cit, c_index);
+}
+
+TEST_CASE("[HASH_ARRAY][STATS]") {
+
+    std::vector<int> storage;
+    KeyAdapter adapter { storage };
+
+    for (int i = 0; i < 8; ++i) {
+        insert_key({ .a = i, .b = -i }, storage);
+    }
+
+    SUBCASE("[HASH_ARRAY][STATS][CHAINED]") {
+        using bucket_t = std::vector<std::pair<std::size_t, std::size_t>>;
+        using array_t
+            = hash_array<CustomKey, std::size_t, KeyAdapter, HashKey, bucket_t, std::allocator<bucket_t>, probe_stats>;
+
+        // a single bucket holds every key
+        array_t array(1);
+        array.set_max_load_factor(100);
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            CHECK(array.try_insert({ .a = static_cast<int>(i), .b = -static_cast<int>(i) }, i, adapter));
+        }
+        REQUIRE_EQ(array.bucket_count(), 1);
+
+        array.reset_stats();
+
+        auto it = array.find({ .a = 7, .b = -7 }, adapter);
+        REQUIRE_NE(it, array.end());
+        CHECK_EQ(*it, 7);
+
+        CHECK_EQ(array.stats().adapter_calls, 1);
+        CHECK_EQ(array.stats().adapter_calls_avoided, 7);
+
+        CHECK_EQ(array.find({ .a = 9, .b = 9 }, adapter), array.end());
+        CHECK_EQ(array.stats().adapter_calls, 1);
+        CHECK_EQ(array.stats().adapter_calls_avoided, 15);
+    }
+
+    SUBCASE("[HASH_ARRAY][STATS][FLAT]") {
+        flat_hash_array<CustomKey, std::size_t, KeyAdapter, HashKey, std::allocator<std::byte>, probe_stats> array;
+
+        for (std::size_t i = 0; i < 8; ++i) {
+            CHECK(array.try_insert({ .a = static_cast<int>(i), .b = -static_cast<int>(i) }, i, adapter));
+        }
+
+        array.reset_stats();
+        for (int i = 0; i < 8; ++i) {
+            CHECK_NE(array.find({ .a = i, .b = -i }, adapter), array.end());
+        }
+
+        // the fingerprints and stored hashes leave only the matching slot to the adapter
+        CHECK_EQ(array.stats().adapter_calls, 8);
+    }
+}
+
+TEST_CASE("[HASH_ARRAY][BUCKET_POLICY]") {
+
+    SUBCASE("[HASH_ARRAY][BUCKET_POLICY][ROUND]") {
+        CHECK_EQ(fibonacci_bucket_policy::round(0), 1);
+        CHECK_EQ(fibonacci_bucket_policy::round(5), 8);
+        CHECK_EQ(fastrange_bucket_policy::round(5), 5);
+        CHECK_EQ(prime_bucket_policy::round(8), 11);
+        CHECK_EQ(prime_bucket_policy::round(13), 13);
+    }
+
+    SUBCASE("[HASH_ARRAY][BUCKET_POLICY][INDEX]") {
+        const fibonacci_bucket_policy single(1);
+        CHECK_EQ(single.index(12345), 0);
+
+        // identity hashes of consecutive integers are spread over the buckets
+        const fibonacci_bucket_policy fibonacci(64);
+        std::vector<bool> used(64);
+        for (std::size_t i = 0; i < 64; ++i) {
+            const std::size_t index = fibonacci.index(std::hash<std::size_t>()(i));
+            REQUIRE_LT(index, 64);
+            used[index] = true;
+        }
+        CHECK_GE(std::count(used.begin(), used.end(), true), 32);
+
+        const fastrange_bucket_policy fastrange(10);
+        CHECK_EQ(fastrange.index(0), 0);
+        CHECK_EQ(fastrange.index(~std::size_t { 0 }), 9);
+        CHECK_EQ(fastrange.index(~std::size_t { 0 } / 2), 4);
+
+        const prime_bucket_policy prime(11);
+        CHECK_EQ(prime.index(25), 3);
+    }
+
+    SUBCASE("[HASH_ARRAY][BUCKET_POLICY][ARRAY]") {
+        std::vector<int> storage;
+        KeyAdapter adapter { storage };
+
+        using bucket_t      = std::vector<std::pair<std::size_t, std::size_t>>;
+        using prime_array_t = hash_array<
+            CustomKey,
+            std::size_t,
+            KeyAdapter,
+            HashKey,
+            bucket_t,
+            std::allocator<bucket_t>,
+            no_probe_stats,
+            prime_bucket_policy>;
+
+        hash_array_t array(5);
+        prime_array_t prime_array(4);
+        CHECK_EQ(array.bucket_count(), 8);
+        CHECK_EQ(prime_array.bucket_count(), 5);
+
+        for (int i = 0; i < 100; ++i) {
+            const CustomKey key { .a = i, .b = i * 3 };
+            const auto index = insert_key(key, storage);
+            CHECK(array.try_insert(key, index, adapter));
+            CHECK(prime_array.try_insert(key, index, adapter));
+        }
+
+        CHECK(std::has_single_bit(array.bucket_count()));
+        CHECK_EQ(prime_array.bucket_count(), prime_bucket_policy::round(prime_array.bucket_count()));
+
+        for (int i = 0; i < 100; ++i) {
+            CHECK_EQ(*array.find({ .a = i, .b = i * 3 }, adapter), static_cast<std::size_t>(i));
+            CHECK_EQ(*prime_array.find({ .a = i, .b = i * 3 }, adapter), static_cast<std::size_t>(i));
+        }
+    }
+}
+
+TEST_CASE("[HASH_ARRAY][INCREMENTAL_REHASH]") {
+    std::vector<int> storage;
+    KeyAdapter adapter { storage };
+
+    hash_array_t array(4);
+    array.set_rehash_step(1);
+    CHECK_EQ(array.rehash_step(), 1);
+    CHECK_FALSE(array.is_rehashing());
+
+    bool seen_rehashing = false;
+    for (int i = 0; i < 200; ++i) {
+        const CustomKey key { .a = i, .b = -i };
+        CHECK(array.try_insert(key, insert_key(key, storage), adapter));
+        CHECK_FALSE(array.try_insert(key, 0, adapter));
+
+        if (array.is_rehashing()) {
+            seen_rehashing = true;
+
+            // every key is found while the entries are split between both tables
+            for (int j = 0; j <= i; ++j) {
+                REQUIRE_NE(array.find({ .a = j, .b = -j }, adapter), array.end());
+            }
+            CHECK_EQ(static_cast<std::size_t>(std::distance(array.begin(), array.end())), array.size());
+        }
+    }
+    CHECK(seen_rehashing);
+
+    SUBCASE("[HASH_ARRAY][INCREMENTAL_REHASH][ERASE]") {
+        while (!array.is_rehashing()) {
+            const auto i = static_cast<int>(array.size());
+            const CustomKey key { .a = i, .b = -i };
+            array.try_insert(key, insert_key(key, storage), adapter);
+        }
+
+        const std::size_t size = array.size();
+        for (int i = 0; i < 50; ++i) {
+            array.erase({ .a = i, .b = -i }, adapter);
+        }
+        CHECK_EQ(array.size(), size - 50);
+        CHECK_EQ(array.find({ .a = 0, .b = 0 }, adapter), array.end());
+        CHECK_EQ(*array.find({ .a = 60, .b = -60 }, adapter), 60);
+
+        const CustomKey last { .a = static_cast<int>(size - 1), .b = -static_cast<int>(size - 1) };
+        CHECK(array.try_set(last, size - 1, adapter));
+        CHECK_EQ(*array.find(last, adapter), size - 1);
+    }
+
+    SUBCASE("[HASH_ARRAY][INCREMENTAL_REHASH][COPY]") {
+        while (!array.is_rehashing()) {
+            const auto i = static_cast<int>(array.size());
+            const CustomKey key { .a = i, .b = -i };
+            array.try_insert(key, insert_key(key, storage), adapter);
+        }
+
+        const hash_array_t copy(array);
+        CHECK(copy.is_rehashing());
+
+        hash_array_t moved(std::move(array));
+        CHECK(moved.is_rehashing());
+
+        for (std::size_t i = 0; i < copy.size(); ++i) {
+            const CustomKey key { .a = static_cast<int>(i), .b = -static_cast<int>(i) };
+            CHECK_EQ(*copy.find(key, adapter), i);
+            CHECK_EQ(*moved.find(key, adapter), i);
+        }
+
+        moved.clear();
+        CHECK_FALSE(moved.is_rehashing());
+        CHECK(moved.empty());
+    }
+}
+
+TEST_CASE("[HASH_ARRAY][BATCH]") {
+    std::vector<int> storage;
+    KeyAdapter adapter { storage };
+
+    hash_array_t array;
+    flat_hash_array_t flat_array;
+    array.set_rehash_step(1);
+
+    std::vector<CustomKey> keys;
+    for (int i = 0; i < 100; ++i) {
+        const CustomKey key { .a = i, .b = i + 1 };
+        const auto index = insert_key(key, storage);
+        array.try_insert(key, index, adapter);
+        flat_array.try_insert(key, index, adapter);
+
+        // every other key is missing
+        keys.push_back(key);
+        keys.push_back({ .a = -i - 1, .b = i });
+    }
+
+    SUBCASE("[HASH_ARRAY][BATCH][FIND]") {
+        std::vector<hash_array_t::iterator_t> found(keys.size());
+        std::vector<flat_hash_array_t::iterator_t> flat_found(keys.size());
+        array.find_batch(keys, found, adapter);
+        flat_array.find_batch(keys, flat_found, adapter);
+
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (i % 2 == 0) {
+                REQUIRE_NE(found[i], array.end());
+                REQUIRE_NE(flat_found[i], flat_array.end());
+                CHECK_EQ(*found[i], i / 2);
+                CHECK_EQ(*flat_found[i], i / 2);
+            } else {
+                CHECK_EQ(found[i], array.end());
+                CHECK_EQ(flat_found[i], flat_array.end());
+            }
+        }
+
+        const hash_array_t& const_array = array;
+        std::vector<hash_array_t::const_iterator_t> const_found(keys.size());
+        const_array.find_batch(keys, const_found, adapter);
+        CHECK_EQ(const_found[10], const_array.find(keys[10], adapter));
+        CHECK_EQ(const_found[11], const_array.end());
+    }
+
+    SUBCASE("[HASH_ARRAY][BATCH][CONTAINS]") {
+        auto flags      = std::make_unique<bool[]>(keys.size());
+        auto flat_flags = std::make_unique<bool[]>(keys.size());
+
+        CHECK_EQ(array.contains_batch(keys, { flags.get(), keys.size() }, adapter), 100);
+        CHECK_EQ(flat_array.contains_batch(keys, { flat_flags.get(), keys.size() }, adapter), 100);
+
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            CHECK_EQ(flags[i], i % 2 == 0);
+            CHECK_EQ(flat_flags[i], i % 2 == 0);
+        }
+
+        CHECK_EQ(array.contains_batch({}, {}, adapter), 0);
+    }
+}
+
+TEST_CASE("[TEMPLATE_HASH_ARRAY][BATCH]") {
+    std::vector<int> storage;
+    std::vector<CustomKeyTag> tags;
+    KeyAdapterTemplate adapter { storage, tags };
+
+    template_hash_array_t array;
+    flat_template_hash_array_t flat_array;
+
+    std::vector<CustomKeyTemplate> keys;
+    for (std::uint16_t i = 0; i < 40; ++i) {
+        const CustomKeyTemplate key { .a = i, .b = 7, .tag = CustomKeyTag::TWO };
+        const auto index = insert_key(key, storage, tags);
+        array.try_insert<CustomKeyTag::TWO>(key, index, adapter);
+        flat_array.try_insert<CustomKeyTag::TWO>(key, index, adapter);
+        keys.push_back(key);
+    }
+    keys.push_back({ .a = 1, .b = 7, .tag = CustomKeyTag::ONE });
+
+    std::vector<template_hash_array_t::iterator_t> found(keys.size());
+    std::vector<flat_template_hash_array_t::iterator_t> flat_found(keys.size());
+    array.find_batch<CustomKeyTag::TWO>(keys, found, adapter);
+    flat_array.find_batch<CustomKeyTag::TWO>(keys, flat_found, adapter);
+
+    for (std::size_t i = 0; i < 40; ++i) {
+        CHECK_EQ(*found[i], i);
+        CHECK_EQ(*flat_found[i], i);
+    }
+
+    // the tag of the key is part of its hash
+    CHECK_EQ(found.back(), array.end());
+    CHECK_EQ(flat_found.back(), flat_array.end());
+
+    auto flags = std::make_unique<bool[]>(keys.size());
+    CHECK_EQ(array.contains_batch<CustomKeyTag::ONE>(keys, { flags.get(), keys.size() }, adapter), 0);
+}
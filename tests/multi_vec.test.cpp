@@ -1,10 +1,36 @@
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
 #include <doctest/doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <koutil/container/concurrent_multi_vector.h>
+#include <koutil/container/encoded_column.h>
+#include <koutil/container/mapped_multi_vector.h>
 #include <koutil/container/multi_vector.h>
+#include <koutil/container/multi_vector_algorithm.h>
+#include <koutil/container/multi_vector_join.h>
+#include <koutil/container/multi_vector_query.h>
+#include <koutil/container/segmented_multi_vector.h>
+#include <koutil/container/slot_map.h>
+#include <koutil/container/soa_vector.h>
+#include <koutil/container/tiled_multi_vector.h>
+#include <koutil/container/versioned_multi_vector.h>
+#include <limits>
+#include <memory_resource>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 using namespace koutil::container;
 
@@ -180,3 +206,1824 @@ TEST_CASE("[MULTI_VECTOR][ITERATOR]") {
         i += 1;
     }
 }
+
+TEST_CASE("[MULTI_VECTOR][BLOCK]") {
+    block_multi_vector<std::uint8_t, double, int> vec;
+    REQUIRE_EQ(vec.size(), 0);
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE); ++i) {
+        vec.emplace_back(static_cast<std::uint8_t>(i), i * 0.5, i * 2);
+        REQUIRE_EQ(vec.size(), i + 1);
+    }
+
+    CHECK_GE(vec.capacity(), INSERT_SIZE);
+
+    const auto bytes   = vec.get_container<0>();
+    const auto doubles = vec.get_container<1>();
+    const auto ints    = vec.get_container<2>();
+
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(bytes.data()) % 64, 0);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(doubles.data()) % 64, 0);
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(ints.data()) % 64, 0);
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE); ++i) {
+        CHECK_EQ(vec[i], std::make_tuple(static_cast<std::uint8_t>(i), i * 0.5, i * 2));
+    }
+
+    SUBCASE("[MULTI_VECTOR][BLOCK][COPY]") {
+        auto copy = vec;
+        REQUIRE_EQ(copy.size(), vec.size());
+
+        for (std::size_t i = 0; i < INSERT_SIZE; ++i) {
+            CHECK_EQ(copy[i], vec[i]);
+        }
+    }
+
+    SUBCASE("[MULTI_VECTOR][BLOCK][ERASE]") {
+        vec.erase(vec.begin() + 1);
+        REQUIRE_EQ(vec.size(), INSERT_SIZE - 1);
+        CHECK_EQ(vec[0], std::make_tuple(std::uint8_t { 0 }, 0.0, 0));
+        CHECK_EQ(vec[1], std::make_tuple(std::uint8_t { 2 }, 1.0, 4));
+    }
+
+    SUBCASE("[MULTI_VECTOR][BLOCK][SHRINK]") {
+        vec.pop_back();
+        vec.shrink_to_fit();
+        REQUIRE_EQ(vec.size(), INSERT_SIZE - 1);
+        CHECK_EQ(vec.back(), std::make_tuple(std::uint8_t { 3 }, 1.5, 6));
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][BLOCK][NON_TRIVIAL]") {
+    block_multi_vector<std::string, int> vec;
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE); ++i) {
+        vec.push_back(std::make_tuple(std::string(32, static_cast<char>('a' + i)), i));
+    }
+
+    auto copy = vec;
+    copy.resize(INSERT_SIZE * 2, std::make_tuple(std::string("x"), -1));
+
+    REQUIRE_EQ(copy.size(), INSERT_SIZE * 2);
+    CHECK_EQ(std::get<0>(copy[0]), std::string(32, 'a'));
+    CHECK_EQ(std::get<0>(copy[INSERT_SIZE]), "x");
+    CHECK_EQ(std::get<0>(vec[INSERT_SIZE - 1]), std::string(32, static_cast<char>('a' + INSERT_SIZE - 1)));
+
+    copy.clear();
+    CHECK(copy.empty());
+}
+
+namespace {
+
+struct tracked {
+    static inline int alive = 0;
+
+    explicit tracked(int v)
+        : value(v) {
+        alive += 1;
+    }
+
+    tracked(const tracked& other)
+        : value(other.value) {
+        alive += 1;
+    }
+
+    tracked(tracked&& other) noexcept
+        : value(other.value) {
+        alive += 1;
+    }
+
+    tracked& operator=(const tracked&) = default;
+    tracked& operator=(tracked&&)      = default;
+
+    ~tracked() { alive -= 1; }
+
+    int value;
+};
+
+}
+
+TEST_CASE("[MULTI_VECTOR][RELOCATION]") {
+    {
+        multi_vector<tracked, int> vec;
+
+        for (int i = 0; i < static_cast<int>(INSERT_SIZE * 4); ++i) {
+            vec.emplace_back(i, i);
+            CHECK_EQ(tracked::alive, i + 1);
+        }
+
+        vec.erase(vec.begin() + 2);
+        CHECK_EQ(tracked::alive, static_cast<int>(INSERT_SIZE * 4) - 1);
+        CHECK_EQ(std::get<0>(vec[2]).value, 3);
+        CHECK_EQ(std::get<1>(vec[2]), 3);
+
+        vec.pop_back();
+        vec.shrink_to_fit();
+        CHECK_EQ(tracked::alive, static_cast<int>(INSERT_SIZE * 4) - 2);
+
+        vec.resize(2, std::make_tuple(tracked(0), 0));
+        CHECK_EQ(tracked::alive, 2);
+    }
+
+    CHECK_EQ(tracked::alive, 0);
+
+    {
+        block_multi_vector<tracked, float> vec;
+
+        for (int i = 0; i < static_cast<int>(INSERT_SIZE * 4); ++i) {
+            vec.emplace_back(i, static_cast<float>(i));
+        }
+        CHECK_EQ(tracked::alive, static_cast<int>(INSERT_SIZE * 4));
+
+        vec.erase(vec.begin());
+        CHECK_EQ(std::get<0>(vec.front()).value, 1);
+        CHECK_EQ(tracked::alive, static_cast<int>(INSERT_SIZE * 4) - 1);
+    }
+
+    CHECK_EQ(tracked::alive, 0);
+}
+
+TEST_CASE("[MULTI_VECTOR][ERASE_UNORDERED]") {
+    multi_vector<int, std::string> vec;
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE); ++i) {
+        vec.emplace_back(i, std::to_string(i));
+    }
+
+    auto it = vec.erase_unordered(vec.begin() + 1);
+    REQUIRE_EQ(vec.size(), INSERT_SIZE - 1);
+    CHECK_EQ(*it, std::make_tuple(static_cast<int>(INSERT_SIZE) - 1, std::to_string(INSERT_SIZE - 1)));
+
+    it = vec.erase_unordered(vec.end() - 1);
+    REQUIRE_EQ(vec.size(), INSERT_SIZE - 2);
+    CHECK_EQ(it, vec.end());
+
+    while (!vec.empty()) {
+        vec.erase_unordered(vec.begin());
+    }
+    CHECK(vec.empty());
+}
+
+TEST_CASE("[MULTI_VECTOR][ERASE_IF]") {
+    block_multi_vector<int, std::string> vec;
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE * 4); ++i) {
+        vec.emplace_back(i, std::to_string(i));
+    }
+
+    const auto capacity = vec.capacity();
+    const auto erased   = vec.erase_if([](auto&& row) { return std::get<0>(row) % 2 == 1; });
+
+    CHECK_EQ(erased, INSERT_SIZE * 2);
+    REQUIRE_EQ(vec.size(), INSERT_SIZE * 2);
+    CHECK_EQ(vec.capacity(), capacity);
+
+    for (std::size_t i = 0; i < vec.size(); ++i) {
+        CHECK_EQ(vec[i], std::make_tuple(static_cast<int>(i * 2), std::to_string(i * 2)));
+    }
+
+    CHECK_EQ(vec.erase_if([](auto&& /*unused*/) { return false; }), 0);
+    CHECK_EQ(vec.erase_if([](auto&& /*unused*/) { return true; }), INSERT_SIZE * 2);
+    CHECK(vec.empty());
+}
+
+namespace {
+
+template <typename T> struct counting_allocator {
+    using value_type = T;
+
+    explicit counting_allocator(std::size_t* counter)
+        : allocations(counter) { }
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>& other)
+        : allocations(other.allocations) { }
+
+    T* allocate(std::size_t n) {
+        *allocations += 1;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, std::size_t n) { std::allocator<T>().deallocate(ptr, n); }
+
+    template <typename U> bool operator==(const counting_allocator<U>& other) const {
+        return allocations == other.allocations;
+    }
+
+    std::size_t* allocations;
+};
+
+}
+
+TEST_CASE("[MULTI_VECTOR][ALLOCATOR]") {
+    std::size_t allocations = 0;
+    counting_allocator<std::byte> alloc { &allocations };
+
+    SUBCASE("[MULTI_VECTOR][ALLOCATOR][COLUMN]") {
+        basic_multi_vector<basic_column_layout<counting_allocator<std::byte>>, int, float, char> vec(alloc);
+
+        vec.reserve(INSERT_SIZE);
+        CHECK_EQ(allocations, 3);
+
+        for (std::size_t i = 0; i < INSERT_SIZE; ++i) {
+            vec.emplace_back(1, 2.0F, 'c');
+        }
+        CHECK_EQ(allocations, 3);
+        CHECK_EQ(vec.get_allocator().allocations, &allocations);
+
+        std::size_t other_allocations = 0;
+        basic_multi_vector<basic_column_layout<counting_allocator<std::byte>>, int, float, char> other(
+            counting_allocator<std::byte> { &other_allocations }
+        );
+
+        other = std::move(vec);
+        CHECK_EQ(other_allocations, 3);
+        CHECK_EQ(other.size(), INSERT_SIZE);
+        CHECK_EQ(other.back(), std::make_tuple(1, 2.0F, 'c'));
+    }
+
+    SUBCASE("[MULTI_VECTOR][ALLOCATOR][BLOCK]") {
+        basic_multi_vector<basic_block_layout<counting_allocator<std::byte>>, int, float, char> vec(INIT_SIZE, alloc);
+        CHECK_EQ(allocations, 1);
+
+        vec.reserve(vec.capacity() + 1);
+        CHECK_EQ(allocations, 2);
+
+        auto copy = vec;
+        CHECK_EQ(allocations, 3);
+        CHECK_EQ(copy.size(), INIT_SIZE);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][PMR]") {
+    std::array<std::byte, 4096> buffer {};
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size(), std::pmr::null_memory_resource());
+
+    pmr::multi_vector<int, double> vec(&arena);
+    pmr::block_multi_vector<int, double> block(&arena);
+
+    for (int i = 0; i < static_cast<int>(INSERT_SIZE); ++i) {
+        vec.emplace_back(i, i * 2.0);
+        block.emplace_back(i, i * 2.0);
+    }
+
+    CHECK_EQ(vec.get_allocator().resource(), &arena);
+    CHECK_EQ(block.get_allocator().resource(), &arena);
+
+    for (std::size_t i = 0; i < INSERT_SIZE; ++i) {
+        CHECK_EQ(vec[i], block[i]);
+    }
+
+    pmr::multi_vector<int, double> other(&arena);
+    other = std::move(vec);
+    CHECK_EQ(other.size(), INSERT_SIZE);
+}
+
+TEST_CASE("[MULTI_VECTOR][VIEW]") {
+    multi_vector<int, void, float, char> vec;
+
+    static_assert(std::random_access_iterator<decltype(vec)::iterator_t>);
+    static_assert(std::random_access_iterator<decltype(vec)::const_iterator_t>);
+
+    for (int i = 0; i < static_cast<int>(INIT_SIZE); ++i) {
+        vec.emplace_back(i, static_cast<float>(i) * 2, static_cast<char>('a' + i));
+    }
+
+    int i = 0;
+    for (auto&& [a, c] : vec.view<0, 3>()) {
+        CHECK_EQ(a, i);
+        CHECK_EQ(c, 'a' + i);
+
+        c = 'z';
+        i += 1;
+    }
+    CHECK_EQ(i, static_cast<int>(INIT_SIZE));
+
+    const auto& const_vec = vec;
+    auto floats           = const_vec.view<2>();
+    CHECK_EQ(std::ranges::size(floats), INIT_SIZE);
+
+    for (auto&& [f] : floats) {
+        CHECK_EQ(std::fmod(f, 2.0F), 0.0F);
+    }
+
+    for (auto&& [a, f, c] : const_vec) {
+        CHECK_EQ(static_cast<float>(a) * 2, f);
+        CHECK_EQ(c, 'z');
+    }
+
+    decltype(vec)::const_iterator_t it = vec.begin() + 2;
+    CHECK_EQ(it - vec.cbegin(), 2);
+    CHECK_EQ(std::get<0>(it[1]), 3);
+    CHECK(it < vec.cend());
+}
+
+namespace {
+
+struct throwing_move {
+    static inline int moves_left = -1;
+
+    explicit throwing_move(char c)
+        : value(32, c) { }
+
+    throwing_move(const throwing_move&) = default;
+
+    throwing_move(throwing_move&& other)
+        : value(std::move(other.value)) {
+        if (moves_left == 0) {
+            throw std::runtime_error("move");
+        }
+        moves_left -= 1;
+    }
+
+    throwing_move& operator=(const throwing_move&) = default;
+    throwing_move& operator=(throwing_move&&)      = default;
+
+    ~throwing_move() = default;
+
+    std::string value;
+};
+
+}
+
+TEST_CASE("[MULTI_VECTOR][SORT]") {
+    SUBCASE("[MULTI_VECTOR][SORT][COMPARE]") {
+        multi_vector<std::string, int> vec;
+        vec.emplace_back("c", 2);
+        vec.emplace_back("a", 0);
+        vec.emplace_back("b", 1);
+        vec.emplace_back("a", 3);
+
+        vec.stable_sort_by<0>();
+
+        const std::array<int, 4> expected { 0, 3, 1, 2 };
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            CHECK_EQ(std::get<1>(vec[i]), expected[i]);
+        }
+
+        vec.sort_by<1>(std::greater<>());
+        CHECK_EQ(std::get<0>(vec[0]), "a");
+        CHECK_EQ(std::get<0>(vec[1]), "c");
+        CHECK_EQ(std::get<1>(vec[3]), 0);
+    }
+
+    SUBCASE("[MULTI_VECTOR][SORT][RADIX]") {
+        constexpr int count = 1000;
+
+        block_multi_vector<std::int64_t, void, float, int> vec;
+        for (int i = 0; i < count; ++i) {
+            const int key = (i * 7919) % 101 - 50;
+            vec.emplace_back(key, static_cast<float>(-key) * 0.5F, i);
+        }
+
+        vec.stable_sort_by<0>();
+        for (std::size_t i = 1; i < vec.size(); ++i) {
+            const auto& [prev_key, prev_f, prev_i] = vec[i - 1];
+            const auto& [key, f, index]            = vec[i];
+
+            REQUIRE_LE(prev_key, key);
+            CHECK_EQ(f, static_cast<float>(-key) * 0.5F);
+            if (prev_key == key) {
+                CHECK_LT(prev_i, index);
+            }
+        }
+
+        vec.sort_by<2>();
+        for (std::size_t i = 1; i < vec.size(); ++i) {
+            REQUIRE_LE(std::get<1>(vec[i - 1]), std::get<1>(vec[i]));
+        }
+    }
+
+    SUBCASE("[MULTI_VECTOR][SORT][SIGNED_ZERO]") {
+        constexpr int count = 300;
+
+        multi_vector<double, int> vec;
+        for (int i = 0; i < count; ++i) {
+            vec.emplace_back(i % 2 == 0 ? -0.0 : 0.0, i);
+        }
+
+        vec.stable_sort_by<0>();
+        for (int i = 0; i < count; ++i) {
+            CHECK_EQ(std::get<1>(vec[static_cast<std::size_t>(i)]), i);
+        }
+    }
+
+    SUBCASE("[MULTI_VECTOR][SORT][ALLOCATOR]") {
+        std::size_t allocations = 0;
+        basic_multi_vector<basic_column_layout<counting_allocator<std::byte>>, int, std::string> vec(
+            counting_allocator<std::byte> { &allocations }
+        );
+
+        for (int i = 0; i < 4; ++i) {
+            vec.emplace_back(3 - i, std::string(32, static_cast<char>('a' + i)));
+        }
+
+        // one temporary buffer per column
+        const std::size_t before = allocations;
+        vec.sort_by<0>();
+        CHECK_EQ(allocations, before + 2);
+        CHECK_EQ(std::get<1>(vec[0]), std::string(32, 'd'));
+    }
+
+    SUBCASE("[MULTI_VECTOR][SORT][EXCEPTION]") {
+        multi_vector<int, throwing_move> vec;
+        for (int i = 0; i < 8; ++i) {
+            vec.emplace_back(7 - i, static_cast<char>('a' + i));
+        }
+
+        bool thrown               = false;
+        throwing_move::moves_left = 4;
+        try {
+            vec.sort_by<0>();
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        throwing_move::moves_left = -1;
+
+        CHECK(thrown);
+
+        CHECK_EQ(vec.size(), 8);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][PARALLEL]") {
+    constexpr int count = 100000;
+
+    koutil::util::thread_pool pool(3);
+
+    multi_vector<int, void, double> vec;
+    for (int i = 0; i < count; ++i) {
+        vec.emplace_back(i, 0.0);
+    }
+
+    for_each_row(pool, vec, [](auto&& row) {
+        auto& [a, d] = row;
+        d            = static_cast<double>(a) / 2;
+    });
+    CHECK_EQ(std::get<1>(vec[10]), 5.0);
+    CHECK_EQ(std::get<1>(vec[count - 1]), static_cast<double>(count - 1) / 2);
+
+    transform_column<0>(pool, vec, [](int a) { return a % 1000; });
+    CHECK_EQ(std::get<0>(vec[1001]), 1);
+
+    CHECK_EQ(sum<0>(pool, vec), 499500 * (count / 1000));
+    CHECK_EQ(minimum<2>(pool, vec), std::optional(0.0));
+    CHECK_EQ(maximum<2>(pool, vec), std::optional(static_cast<double>(count - 1) / 2));
+    CHECK_EQ(count_if<0>(pool, vec, [](int a) { return a < 10; }), static_cast<std::size_t>(count / 100));
+
+    CHECK_EQ(sum<2>(vec), sum<2>(pool, vec));
+
+    // the sum of an int column exceeds INT_MAX and is accumulated in 64 bits
+    multi_vector<int> large(70000, 100000);
+    CHECK_EQ(sum<0>(pool, large), std::int64_t { 7000000000 });
+
+    std::vector<int> hits(16);
+    const auto mark = [&hits](std::size_t index) { hits[index] += 1; };
+    pool.run(hits.size(), mark);
+    CHECK_EQ(std::ranges::count(hits, 1), static_cast<std::ptrdiff_t>(hits.size()));
+
+    SUBCASE("[MULTI_VECTOR][PARALLEL][EMPTY]") {
+        multi_vector<int> empty;
+        CHECK_EQ(sum<0>(pool, empty), 0);
+        CHECK_FALSE(minimum<0>(pool, empty).has_value());
+        CHECK_EQ(count_if<0>(pool, empty, [](int) { return true; }), 0);
+    }
+
+    SUBCASE("[MULTI_VECTOR][PARALLEL][EXCEPTION]") {
+        bool thrown = false;
+        try {
+            for_each_row(pool, vec, [](auto&& row) {
+                if (std::get<0>(row) == 500) {
+                    throw std::runtime_error("row");
+                }
+            });
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+
+    SUBCASE("[MULTI_VECTOR][PARALLEL][PACKED]") {
+        multi_vector<int, packed_bool> flags;
+        for (int i = 0; i < count; ++i) {
+            flags.emplace_back(i, false);
+        }
+
+        // the chunk boundaries must not split a word of the packed column between threads
+        for_each_row(pool, flags, [](auto&& row) {
+            auto&& [value, flag] = row;
+            flag                 = value % 3 == 0;
+        });
+        CHECK_EQ(flags.get_container<1>().count(), static_cast<std::size_t>((count + 2) / 3));
+
+        transform_column<1>(pool, flags, [](bool flag) { return !flag; });
+        CHECK_EQ(flags.get_container<1>().count(), static_cast<std::size_t>(count - (count + 2) / 3));
+        CHECK_FALSE(std::get<1>(flags[0]));
+        CHECK(std::get<1>(flags[1]));
+
+        CHECK_EQ(count_if<1>(pool, flags, [](bool flag) { return flag; }), flags.get_container<1>().count());
+        CHECK_EQ(sum<1>(pool, flags), flags.get_container<1>().count());
+        CHECK_EQ(minimum<1>(pool, flags), std::optional(false));
+        CHECK_EQ(maximum<1>(pool, flags), std::optional(true));
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][SEGMENTED]") {
+    constexpr std::size_t chunk = 64;
+    constexpr int count         = 1000;
+
+    basic_segmented_multi_vector<chunk, std::allocator<std::byte>, int, std::string, double> vec;
+
+    static_assert(std::random_access_iterator<decltype(vec)::iterator_t>);
+    static_assert(std::random_access_iterator<decltype(vec)::const_iterator_t>);
+
+    vec.emplace_back(0, "0", 0.0);
+    int* first       = &std::get<0>(vec[0]);
+    std::string* str = &std::get<1>(vec[0]);
+
+    for (int i = 1; i < count; ++i) {
+        vec.push_back({ i, std::to_string(i), i * 0.5 });
+    }
+
+    // growing does not move elements
+    CHECK_EQ(first, &std::get<0>(vec[0]));
+    CHECK_EQ(str, &std::get<1>(vec[0]));
+
+    REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(vec.chunk_count(), (count + chunk - 1) / chunk);
+    CHECK_EQ(vec.chunk<0>(vec.chunk_count() - 1).size(), count % chunk);
+    CHECK_EQ(std::get<1>(vec[count - 1]), std::to_string(count - 1));
+
+    int total = 0;
+    for (std::size_t c = 0; c < vec.chunk_count(); ++c) {
+        for (int value : vec.chunk<0>(c)) {
+            total += value;
+        }
+    }
+    CHECK_EQ(total, count * (count - 1) / 2);
+
+    int i = 0;
+    for (auto&& [a, s, d] : vec) {
+        CHECK_EQ(a, i);
+        CHECK_EQ(d, i * 0.5);
+        i += 1;
+    }
+    CHECK_EQ(vec.end() - vec.begin(), count);
+
+    decltype(vec)::const_iterator_t it = vec.begin() + 3;
+    CHECK_EQ(std::get<0>(*it), 3);
+    CHECK(it < vec.cend());
+
+    SUBCASE("[MULTI_VECTOR][SEGMENTED][COPY]") {
+        auto copy = vec;
+        CHECK_EQ(copy.size(), vec.size());
+        CHECK_EQ(std::get<1>(copy[700]), "700");
+
+        decltype(vec) moved;
+        moved = std::move(copy);
+        CHECK_EQ(std::get<1>(moved.back()), std::to_string(count - 1));
+        CHECK(copy.empty());
+    }
+
+    SUBCASE("[MULTI_VECTOR][SEGMENTED][SHRINK]") {
+        const std::size_t capacity = vec.capacity();
+        while (vec.size() > chunk + 1) {
+            vec.pop_back();
+        }
+        CHECK_EQ(vec.capacity(), capacity);
+        CHECK_EQ(std::get<1>(vec.back()), std::to_string(chunk));
+
+        vec.shrink_to_fit();
+        CHECK_EQ(vec.capacity(), 2 * chunk);
+
+        vec.clear();
+        CHECK(vec.empty());
+        CHECK_EQ(vec.capacity(), 2 * chunk);
+    }
+
+    SUBCASE("[MULTI_VECTOR][SEGMENTED][PMR]") {
+        std::pmr::monotonic_buffer_resource first_resource;
+        std::pmr::monotonic_buffer_resource second_resource;
+
+        pmr::segmented_multi_vector<int, std::string> lhs(&first_resource);
+        pmr::segmented_multi_vector<int, std::string> rhs(&second_resource);
+
+        rhs.emplace_back(1, "one");
+        rhs.emplace_back(2, "two");
+
+        // the allocators differ, so the elements are moved instead of the chunks
+        lhs = std::move(rhs);
+        CHECK_EQ(lhs.size(), 2);
+        CHECK_EQ(std::get<1>(lhs[1]), "two");
+        CHECK_EQ(lhs.get_allocator().resource(), &first_resource);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][SMALL]") {
+    constexpr std::size_t inline_rows = 4;
+
+    std::size_t allocations = 0;
+
+    using alloc_t = counting_allocator<std::byte>;
+    basic_multi_vector<basic_small_layout<inline_rows, alloc_t>, int, void, std::string> vec { alloc_t(&allocations) };
+
+    CHECK_EQ(vec.capacity(), inline_rows);
+
+    for (int i = 0; i < static_cast<int>(inline_rows); ++i) {
+        vec.emplace_back(i, std::to_string(i));
+    }
+    CHECK_EQ(allocations, 0);
+
+    SUBCASE("[MULTI_VECTOR][SMALL][SPILL]") {
+        vec.emplace_back(4, "4");
+        CHECK_EQ(allocations, 2);
+        CHECK_GT(vec.capacity(), inline_rows);
+
+        vec.erase(vec.begin());
+        vec.shrink_to_fit();
+        CHECK_EQ(vec.capacity(), inline_rows);
+        CHECK_EQ(std::get<1>(vec[0]), "1");
+        CHECK_EQ(std::get<1>(vec.back()), "4");
+    }
+
+    SUBCASE("[MULTI_VECTOR][SMALL][COPY]") {
+        auto copy = vec;
+        CHECK_EQ(allocations, 0);
+        CHECK_EQ(std::get<1>(copy[3]), "3");
+
+        auto moved = std::move(copy);
+        CHECK_EQ(std::get<1>(moved[2]), "2");
+        CHECK(copy.empty());
+
+        moved.emplace_back(9, "9");
+        vec.swap(moved);
+        CHECK_EQ(vec.size(), inline_rows + 1);
+        CHECK_EQ(moved.size(), inline_rows);
+        CHECK_EQ(std::get<1>(vec.back()), "9");
+        CHECK_EQ(std::get<1>(moved.back()), "3");
+    }
+
+    small_multi_vector<2, int, float> plain;
+    plain.resize(5, { 1, 2.0F });
+    plain.sort_by<0>();
+    CHECK_EQ(plain.size(), 5);
+    CHECK_EQ(std::get<1>(plain[4]), 2.0F);
+}
+
+TEST_CASE("[MULTI_VECTOR][PACKED_BOOL]") {
+    constexpr int count = 200;
+
+    multi_vector<int, packed_bool, void, packed_bool> vec;
+
+    static_assert(std::random_access_iterator<decltype(vec)::iterator_t>);
+    static_assert(std::is_same_v<decltype(vec)::value_t, std::tuple<int, bool, bool>>);
+
+    for (int i = 0; i < count; ++i) {
+        vec.emplace_back(i, i % 3 == 0, i % 2 == 0);
+    }
+
+    auto visible = vec.get_container<1>();
+    CHECK_EQ(visible.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(visible.words().size(), 4);
+    CHECK_EQ(visible.count(), 67);
+    CHECK_EQ(visible.find_first(), 0);
+
+    auto&& [a, flag, even] = vec[7];
+    CHECK_EQ(a, 7);
+    CHECK_FALSE(flag);
+    flag = true;
+    CHECK(visible[7]);
+    CHECK_EQ(visible.count(), 68);
+
+    SUBCASE("[MULTI_VECTOR][PACKED_BOOL][MASK]") {
+        int sum = 0;
+        vec.for_each_where<3>([&](auto&& row) { sum += std::get<0>(row); });
+        CHECK_EQ(sum, (count / 2) * (count - 2) / 2);
+
+        std::size_t selected = 0;
+        std::as_const(vec).for_each_where<1>([&](auto&& row) {
+            CHECK(std::get<1>(row));
+            selected += 1;
+        });
+        CHECK_EQ(selected, visible.count());
+    }
+
+    SUBCASE("[MULTI_VECTOR][PACKED_BOOL][ERASE]") {
+        vec.erase(vec.begin());
+        CHECK_EQ(vec.size(), static_cast<std::size_t>(count - 1));
+
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            const int value = static_cast<int>(i) + 1;
+            REQUIRE_EQ(std::get<0>(vec[i]), value);
+            REQUIRE_EQ(static_cast<bool>(std::get<1>(vec[i])), value % 3 == 0 || value == 7);
+            REQUIRE_EQ(static_cast<bool>(std::get<2>(vec[i])), value % 2 == 0);
+        }
+
+        vec.erase_if([](auto&& row) { return std::get<2>(row); });
+        CHECK_EQ(vec.size(), static_cast<std::size_t>(count / 2));
+        CHECK_EQ(vec.get_container<3>().count(), 0);
+    }
+
+    SUBCASE("[MULTI_VECTOR][PACKED_BOOL][RESIZE]") {
+        vec.resize(65);
+        CHECK_EQ(vec.get_container<3>().count(), 33);
+
+        vec.resize(130, { -1, true, false });
+        CHECK_EQ(vec.get_container<1>().count(), 23 + 65);
+        CHECK_EQ(std::get<0>(vec.back()), -1);
+
+        vec.pop_back();
+        CHECK_EQ(vec.get_container<1>().count(), 22 + 65);
+    }
+
+    SUBCASE("[MULTI_VECTOR][PACKED_BOOL][SORT]") {
+        vec.stable_sort_by<1>(std::greater<>());
+        CHECK(std::get<1>(vec[0]));
+        CHECK_EQ(std::get<0>(vec[0]), 0);
+        CHECK_EQ(std::get<0>(vec[1]), 3);
+        CHECK_FALSE(std::get<1>(vec.back()));
+    }
+
+    block_multi_vector<packed_bool> flags(100, { true });
+    CHECK_EQ(flags.get_container<0>().count(), 100);
+    flags.clear();
+    CHECK(flags.empty());
+}
+
+TEST_CASE("[MULTI_VECTOR][APPEND]") {
+    const std::vector<int> ints { 1, 2, 3, 4 };
+    const std::array<double, 4> doubles { 0.5, 1.5, 2.5, 3.5 };
+    const std::vector<std::string> strings { "a", "b", "c", "d" };
+
+    SUBCASE("[MULTI_VECTOR][APPEND][COLUMN]") {
+        multi_vector<int, void, double, std::string> vec;
+        vec.emplace_back(0, 0.0, "start");
+
+        vec.append(ints, std::span(doubles), strings);
+        REQUIRE_EQ(vec.size(), 5);
+        CHECK_EQ(std::get<0>(vec[4]), 4);
+        CHECK_EQ(std::get<1>(vec[2]), 1.5);
+        CHECK_EQ(std::get<2>(vec[1]), "a");
+
+        auto it = vec.insert(
+            vec.begin() + 1,
+            std::span(ints).first(2),
+            std::span(doubles).first(2),
+            std::vector<std::string> { "x", "y" }
+        );
+        CHECK_EQ(it - vec.begin(), 1);
+        REQUIRE_EQ(vec.size(), 7);
+        CHECK_EQ(std::get<2>(vec[0]), "start");
+        CHECK_EQ(std::get<2>(vec[2]), "y");
+        CHECK_EQ(std::get<2>(vec[3]), "a");
+        CHECK_EQ(std::get<2>(vec[6]), "d");
+
+        vec.insert(vec.end(), 2, { 9, 9.0, "z" });
+        CHECK_EQ(vec.size(), 9);
+        CHECK_EQ(std::get<2>(vec.back()), "z");
+    }
+
+    SUBCASE("[MULTI_VECTOR][APPEND][BLOCK]") {
+        block_multi_vector<int, double> vec;
+        for (int i = 0; i < 3; ++i) {
+            vec.append(ints, doubles);
+        }
+        REQUIRE_EQ(vec.size(), 12);
+
+        vec.insert(vec.begin() + 4, 3, { -1, -1.0 });
+        REQUIRE_EQ(vec.size(), 15);
+        CHECK_EQ(std::get<0>(vec[3]), 4);
+        CHECK_EQ(std::get<0>(vec[6]), -1);
+        CHECK_EQ(std::get<0>(vec[7]), 1);
+        CHECK_EQ(std::get<1>(vec[14]), 3.5);
+    }
+
+    SUBCASE("[MULTI_VECTOR][APPEND][SMALL]") {
+        small_multi_vector<2, std::string, int> vec;
+        vec.append(strings, ints);
+        vec.insert(vec.begin(), strings, ints);
+        REQUIRE_EQ(vec.size(), 8);
+        CHECK_EQ(std::get<0>(vec[3]), "d");
+        CHECK_EQ(std::get<0>(vec[4]), "a");
+    }
+
+    SUBCASE("[MULTI_VECTOR][APPEND][PACKED]") {
+        multi_vector<int, packed_bool> vec;
+        const std::vector<bool> flags { true, false, true, true };
+
+        vec.append(ints, flags);
+        vec.insert(vec.begin() + 1, 70, { 0, true });
+        REQUIRE_EQ(vec.size(), 74);
+        CHECK_EQ(vec.get_container<1>().count(), 73);
+        CHECK_FALSE(std::get<1>(vec[71]));
+        CHECK_EQ(std::get<0>(vec[71]), 2);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][TILED]") {
+    constexpr std::size_t tile = 8;
+    constexpr int count        = 101;
+
+    tiled_multi_vector<tile, int, std::string, double> vec;
+
+    static_assert(std::random_access_iterator<decltype(vec)::iterator_t>);
+    static_assert(std::random_access_iterator<decltype(vec)::const_iterator_t>);
+
+    for (int i = 0; i < count; ++i) {
+        vec.push_back({ i, std::to_string(i), i * 0.5 });
+    }
+
+    REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(vec.tile_count(), (count + tile - 1) / tile);
+    CHECK_EQ(vec.tile<0>(0).size(), tile);
+    CHECK_EQ(vec.tile<0>(vec.tile_count() - 1).size(), count % tile);
+    CHECK_EQ(std::get<1>(vec[count - 1]), std::to_string(count - 1));
+
+    // the rows of a tile are contiguous within each column
+    CHECK_EQ(&std::get<0>(vec[9]), &std::get<0>(vec[8]) + 1);
+    CHECK_EQ(vec.tile<2>(1).data(), &std::get<2>(vec[8]));
+
+    int total = 0;
+    for (std::size_t t = 0; t < vec.tile_count(); ++t) {
+        for (int value : vec.tile<0>(t)) {
+            total += value;
+        }
+    }
+    CHECK_EQ(total, count * (count - 1) / 2);
+
+    int i = 0;
+    for (auto&& [a, s, d] : vec) {
+        CHECK_EQ(a, i);
+        CHECK_EQ(d, i * 0.5);
+        i += 1;
+    }
+    CHECK_EQ(vec.end() - vec.begin(), count);
+
+    auto column = vec.get_container<0>();
+    CHECK_EQ(column.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(column[42], 42);
+    CHECK_EQ(sum<0>(std::as_const(vec)), count * (count - 1) / 2);
+
+    transform_column<2>(vec, [](double value) { return value * 2; });
+    CHECK_EQ(std::get<2>(vec[10]), 10.0);
+
+    SUBCASE("[MULTI_VECTOR][TILED][ALIGNMENT]") {
+        tiled_multi_vector<tile, char, float> small;
+        for (int j = 0; j < count; ++j) {
+            small.emplace_back(static_cast<char>(j), static_cast<float>(j));
+        }
+
+        // every tile starts on a cache line and its columns are aligned to the SIMD width
+        for (std::size_t t = 0; t < small.tile_count(); ++t) {
+            CHECK_EQ(reinterpret_cast<std::uintptr_t>(small.tile<0>(t).data()) % 64, 0);
+            CHECK_EQ(reinterpret_cast<std::uintptr_t>(small.tile<1>(t).data()) % 32, 0);
+        }
+        CHECK_EQ(small.tile<1>(12)[3], 99.0F);
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][ERASE]") {
+        vec.erase(vec.begin() + 5);
+        REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count - 1));
+        CHECK_EQ(std::get<0>(vec[5]), 6);
+        CHECK_EQ(std::get<1>(vec.back()), std::to_string(count - 1));
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][ERASE_UNORDERED]") {
+        auto it = vec.erase_unordered(vec.begin() + 3);
+        CHECK_EQ(std::get<0>(*it), count - 1);
+        CHECK_EQ(std::get<1>(vec[3]), std::to_string(count - 1));
+
+        const auto erased = vec.erase_if([](auto&& row) { return std::get<0>(row) % 2 == 1; });
+        CHECK_EQ(erased, count / 2 - 1);
+        REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count) - erased - 1);
+        CHECK_EQ(std::get<0>(vec[2]), count - 1);
+        CHECK_EQ(std::get<0>(vec[3]), 4);
+        CHECK_EQ(std::get<1>(vec.back()), std::to_string(count - 3));
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][INSERT]") {
+        const std::vector<int> keys { -1, -2, -3 };
+        const std::vector<std::string> names { "a", "b", "c" };
+        const std::vector<double> values { 1.0, 2.0, 3.0 };
+
+        vec.append(keys, names, values);
+        REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count + 3));
+        CHECK_EQ(std::get<1>(vec.back()), "c");
+
+        auto it = vec.insert(vec.begin() + 6, keys, names, values);
+        CHECK_EQ(std::get<0>(*it), -1);
+        CHECK_EQ(std::get<1>(vec[8]), "c");
+        CHECK_EQ(std::get<0>(vec[9]), 6);
+
+        vec.insert(vec.begin(), 20, { 7, "seven", 7.0 });
+        REQUIRE_EQ(vec.size(), static_cast<std::size_t>(count + 26));
+        CHECK_EQ(std::get<1>(vec[19]), "seven");
+        CHECK_EQ(std::get<0>(vec[20]), 0);
+        CHECK_EQ(std::get<1>(vec.back()), "c");
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][VIEW]") {
+        int expected = 0;
+        for (auto&& [a, d] : vec.view<0, 2>()) {
+            CHECK_EQ(d, a * 1.0);
+            expected += 1;
+        }
+        CHECK_EQ(expected, count);
+
+        std::get<0>(vec.view<1>()[4]) = "four";
+        CHECK_EQ(std::get<0>(std::as_const(vec).view<1>()[4]), "four");
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][SORT]") {
+        vec.sort_by<0>(std::greater<>());
+        CHECK_EQ(std::get<0>(vec.front()), count - 1);
+        CHECK_EQ(std::get<1>(vec[10]), std::to_string(count - 11));
+
+        // string keys take the comparison sort over the tiled column
+        vec.stable_sort_by<1>();
+        CHECK_EQ(std::get<1>(vec.front()), "0");
+        CHECK_EQ(std::get<1>(vec[1]), "1");
+        CHECK_EQ(std::get<1>(vec[2]), "10");
+
+        tiled_multi_vector<tile, int, std::string> large;
+        for (int j = 0; j < 300; ++j) {
+            large.emplace_back((j * 37) % 300, std::to_string(j));
+        }
+
+        // above the radix threshold the keys are gathered from the tiles
+        large.sort_by<0>();
+        for (int j = 0; j < 300; ++j) {
+            CHECK_EQ(std::get<0>(large[static_cast<std::size_t>(j)]), j);
+        }
+        CHECK_EQ(std::get<1>(large[37]), "1");
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][RESIZE]") {
+        vec.resize(3);
+        CHECK_EQ(vec.size(), 3);
+        CHECK_EQ(vec.tile<1>(0).size(), 3);
+
+        vec.shrink_to_fit();
+        CHECK_EQ(vec.capacity(), tile);
+
+        vec.resize(12, { 7, "seven", 7.0 });
+        CHECK_EQ(std::get<1>(vec[11]), "seven");
+        CHECK_EQ(std::get<1>(vec[2]), "2");
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][COPY]") {
+        auto copy = vec;
+        CHECK_EQ(copy.size(), vec.size());
+        CHECK_EQ(std::get<1>(copy[70]), "70");
+
+        decltype(vec) moved;
+        moved = std::move(copy);
+        CHECK_EQ(std::get<1>(moved.back()), std::to_string(count - 1));
+        CHECK(copy.empty());
+    }
+
+    SUBCASE("[MULTI_VECTOR][TILED][PMR]") {
+        std::pmr::monotonic_buffer_resource first_resource;
+        std::pmr::monotonic_buffer_resource second_resource;
+
+        pmr::tiled_multi_vector<tile, int, std::string> lhs(&first_resource);
+        pmr::tiled_multi_vector<tile, int, std::string> rhs(&second_resource);
+
+        rhs.emplace_back(1, "one");
+        rhs.emplace_back(2, "two");
+
+        lhs = std::move(rhs);
+        CHECK_EQ(lhs.size(), 2);
+        CHECK_EQ(std::get<1>(lhs[1]), "two");
+        CHECK_EQ(lhs.get_allocator().resource(), &first_resource);
+    }
+}
+
+namespace {
+
+struct mapped_point {
+    int x;
+    float y;
+};
+
+struct mapped_pair {
+    float first;
+    int second;
+};
+
+enum class mapped_color : int { RED, GREEN };
+
+template <typename Vec>
+constexpr bool is_saveable = requires(const Vec& vec, const std::filesystem::path& path) { save(vec, path); };
+
+}
+
+TEST_CASE("[MULTI_VECTOR][MAPPED]") {
+    const std::filesystem::path path = std::filesystem::temp_directory_path() / "koutil_mapped.test.bin";
+
+    multi_vector<int, void, double, packed_bool, std::uint8_t> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec.emplace_back(i, i * 0.25, i % 3 == 0, static_cast<std::uint8_t>(i));
+    }
+
+    REQUIRE_EQ(save(vec, path), MappedError::NONE);
+
+    auto mapped = open_mapped<int, double, packed_bool, std::uint8_t>(path);
+    REQUIRE(mapped.has_value());
+    REQUIRE_EQ(mapped->size(), vec.size());
+
+    // the columns are aligned blocks inside the mapping
+    const auto ints = mapped->get_container<0>();
+    CHECK_EQ(reinterpret_cast<std::uintptr_t>(ints.data()) % 4096, 0);
+    CHECK_EQ(ints[999], 999);
+    CHECK_EQ(mapped->get_container<1>()[10], 2.5);
+    CHECK_EQ(mapped->get_container<2>().count(), vec.get_container<3>().count());
+    CHECK_EQ(std::get<3>(mapped->back()), static_cast<std::uint8_t>(999 % 256));
+
+    std::size_t rows = 0;
+    for (auto&& [value, quarter, flag, byte] : *mapped) {
+        CHECK_EQ(static_cast<bool>(flag), value % 3 == 0);
+        rows += 1;
+    }
+    CHECK_EQ(rows, vec.size());
+
+    SUBCASE("[MULTI_VECTOR][MAPPED][MISMATCH]") {
+        mapped_multi_vector<int, float, packed_bool, std::uint8_t> wrong;
+        CHECK_EQ(wrong.open(path), MappedError::FORMAT_MISMATCH);
+        CHECK_FALSE(wrong.is_open());
+
+        mapped_multi_vector<int> missing;
+        CHECK_EQ(missing.open(path.string() + ".missing"), MappedError::OPEN_FAIL);
+    }
+
+    SUBCASE("[MULTI_VECTOR][MAPPED][TYPES]") {
+        static_assert(!is_saveable<multi_vector<int*>>);
+        static_assert(is_saveable<multi_vector<mapped_point>>);
+
+        multi_vector<mapped_point, mapped_color> points;
+        points.emplace_back(mapped_point { 1, 2.0F }, mapped_color::GREEN);
+        REQUIRE_EQ(save(points, path), MappedError::NONE);
+
+        // the same size and alignment, but other types
+        mapped_multi_vector<mapped_pair, mapped_color> pairs;
+        CHECK_EQ(pairs.open(path), MappedError::FORMAT_MISMATCH);
+
+        mapped_multi_vector<mapped_point, int> colors;
+        CHECK_EQ(colors.open(path), MappedError::FORMAT_MISMATCH);
+
+        auto reopened = open_mapped<mapped_point, mapped_color>(path);
+        REQUIRE(reopened.has_value());
+        CHECK_EQ(std::get<0>(reopened->front()).x, 1);
+        CHECK_EQ(std::get<1>(reopened->front()), mapped_color::GREEN);
+    }
+
+    SUBCASE("[MULTI_VECTOR][MAPPED][CORRUPT]") {
+        multi_vector<int, double> numbers;
+        for (int i = 0; i < 1000; ++i) {
+            numbers.emplace_back(i, i * 0.5);
+        }
+        REQUIRE_EQ(save(numbers, path), MappedError::NONE);
+
+        // the byte sizes of both columns wrap around to the stored ones, the size follows the magic, the version
+        // and the byte order
+        const std::uint64_t size = numbers.size() + (std::uint64_t { 1 } << 62);
+
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(16);
+        file.write(reinterpret_cast<const char*>(&size), sizeof(size));
+        file.close();
+
+        mapped_multi_vector<int, double> corrupt;
+        CHECK_EQ(corrupt.open(path), MappedError::FORMAT_MISMATCH);
+    }
+
+    SUBCASE("[MULTI_VECTOR][MAPPED][EMPTY]") {
+        vec.clear();
+        REQUIRE_EQ(save(vec, path), MappedError::NONE);
+
+        auto empty = open_mapped<int, double, packed_bool, std::uint8_t>(path);
+        REQUIRE(empty.has_value());
+        CHECK(empty->empty());
+        CHECK(empty->get_container<2>().empty());
+    }
+
+    mapped.reset();
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+template <typename T> struct limited_allocator {
+    using value_type = T;
+
+    explicit limited_allocator(std::size_t* budget)
+        : remaining(budget) { }
+
+    template <typename U>
+    limited_allocator(const limited_allocator<U>& other)
+        : remaining(other.remaining) { }
+
+    T* allocate(std::size_t n) {
+        if (*remaining == 0) {
+            throw std::bad_alloc();
+        }
+        *remaining -= 1;
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* ptr, std::size_t n) { std::allocator<T>().deallocate(ptr, n); }
+
+    template <typename U> bool operator==(const limited_allocator<U>& other) const {
+        return remaining == other.remaining;
+    }
+
+    std::size_t* remaining;
+};
+
+}
+
+TEST_CASE("[MULTI_VECTOR][CONCURRENT]") {
+    constexpr std::size_t first     = 64;
+    constexpr int producers         = 4;
+    constexpr int rows_per_producer = 5000;
+
+    basic_concurrent_multi_vector<first, std::allocator<std::byte>, int, int, std::string> vec;
+
+    static_assert(std::random_access_iterator<decltype(vec)::iterator_t>);
+
+    std::atomic<bool> done { false };
+    std::atomic<std::size_t> torn { 0 };
+
+    // every published row must be fully constructed
+    std::thread reader([&] {
+        while (!done.load()) {
+            const std::size_t size = vec.size();
+            for (std::size_t pos = size > 64 ? size - 64 : 0; pos < size; ++pos) {
+                const auto& [producer, value, text] = std::as_const(vec)[pos];
+                if (text != std::to_string(producer * rows_per_producer + value)) {
+                    torn.fetch_add(1);
+                }
+            }
+            std::this_thread::yield();
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&vec, producer] {
+            for (int i = 0; i < rows_per_producer; ++i) {
+                vec.emplace_back(producer, i, std::to_string(producer * rows_per_producer + i));
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    done.store(true);
+    reader.join();
+
+    CHECK_EQ(torn.load(), 0);
+    REQUIRE_EQ(vec.size(), static_cast<std::size_t>(producers * rows_per_producer));
+
+    // the rows of a producer keep their order
+    std::vector<int> last(producers, -1);
+    for (auto&& [producer, value, text] : vec) {
+        CHECK_EQ(value, last[static_cast<std::size_t>(producer)] + 1);
+        last[static_cast<std::size_t>(producer)] = value;
+    }
+
+    std::size_t rows = 0;
+    for (std::size_t segment = 0; segment < vec.segment_count(); ++segment) {
+        rows += vec.segment<1>(segment).size();
+    }
+    CHECK_EQ(rows, vec.size());
+    CHECK_EQ(vec.segment<0>(0).size(), first);
+    CHECK_EQ(vec.segment<0>(1).size(), 2 * first);
+
+    vec.clear();
+    CHECK(vec.empty());
+    CHECK_EQ(vec.emplace_back(1, 2, "3"), 0);
+    CHECK_EQ(std::get<2>(vec.at(0)), "3");
+
+    SUBCASE("[MULTI_VECTOR][CONCURRENT][BAD_ALLOC]") {
+        std::size_t remaining = 1;
+        basic_concurrent_multi_vector<first, limited_allocator<std::byte>, int> limited(
+            limited_allocator<std::byte> { &remaining }
+        );
+
+        for (int i = 0; i < static_cast<int>(first); ++i) {
+            limited.emplace_back(i);
+        }
+
+        // the second segment cannot be allocated, no row is reserved
+        bool thrown = false;
+        try {
+            limited.emplace_back(-1);
+        } catch (const std::bad_alloc&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK_EQ(limited.size(), first);
+
+        remaining = 1;
+        CHECK_EQ(limited.emplace_back(64), first);
+        CHECK_EQ(limited.size(), first + 1);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][VERSIONED]") {
+    constexpr std::size_t chunk = 64;
+    constexpr int count         = 1000;
+
+    basic_versioned_multi_vector<chunk, int, std::string> vec;
+    for (int i = 0; i < count; ++i) {
+        vec.push_back({ i, std::to_string(i) });
+    }
+
+    const auto snapshot = vec.snapshot();
+    REQUIRE_EQ(snapshot.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(snapshot.chunk_count(), (count + chunk - 1) / chunk);
+
+    // the snapshot shares every chunk
+    CHECK_EQ(snapshot.chunk<0>(3).data(), std::as_const(vec).chunk<0>(3).data());
+
+    vec.get<0>(5) = -5;
+    vec.emplace_back(count, "new");
+
+    CHECK_EQ(std::get<0>(snapshot[5]), 5);
+    CHECK_EQ(std::get<0>(std::as_const(vec)[5]), -5);
+    CHECK_EQ(snapshot.size(), static_cast<std::size_t>(count));
+    CHECK_EQ(vec.size(), static_cast<std::size_t>(count + 1));
+
+    // only the touched chunk of the touched column is cloned
+    CHECK_NE(snapshot.chunk<0>(0).data(), std::as_const(vec).chunk<0>(0).data());
+    CHECK_EQ(snapshot.chunk<1>(0).data(), std::as_const(vec).chunk<1>(0).data());
+    CHECK_EQ(snapshot.chunk<0>(1).data(), std::as_const(vec).chunk<0>(1).data());
+
+    int i = 0;
+    for (auto&& [value, text] : snapshot) {
+        CHECK_EQ(text, std::to_string(i));
+        i += 1;
+    }
+    CHECK_EQ(i, count);
+
+    SUBCASE("[MULTI_VECTOR][VERSIONED][IN_PLACE]") {
+        auto* data = std::as_const(vec).chunk<1>(2).data();
+
+        // without a snapshot sharing it, the clone of the chunk is modified in place
+        vec.get<0>(5) = 5;
+        std::get<1>(vec[5]).clear();
+        const auto* cloned = std::as_const(vec).chunk<1>(0).data();
+        std::get<1>(vec[6]).clear();
+        CHECK_EQ(std::as_const(vec).chunk<1>(0).data(), cloned);
+        CHECK_EQ(std::as_const(vec).chunk<1>(2).data(), data);
+        CHECK_EQ(std::get<1>(snapshot[5]), "5");
+    }
+
+    SUBCASE("[MULTI_VECTOR][VERSIONED][POP_BACK]") {
+        while (vec.size() > chunk) {
+            vec.pop_back();
+        }
+        CHECK_EQ(vec.chunk_count(), 1);
+        CHECK_EQ(snapshot.size(), static_cast<std::size_t>(count));
+        CHECK_EQ(std::get<1>(snapshot.back()), std::to_string(count - 1));
+
+        vec.clear();
+        CHECK(vec.empty());
+        CHECK_EQ(std::get<1>(snapshot[count / 2]), std::to_string(count / 2));
+    }
+
+    SUBCASE("[MULTI_VECTOR][VERSIONED][THREADS]") {
+        for (std::size_t pos = 0; pos < vec.size(); ++pos) {
+            vec.get<0>(pos) = -1;
+        }
+
+        std::atomic<bool> done { false };
+        std::atomic<std::size_t> mismatches { 0 };
+        std::mutex mutex;
+        auto published = vec.snapshot();
+
+        // the snapshot is handed over under a lock, its rows are read without one
+        std::thread reader([&] {
+            while (!done.load()) {
+                decltype(vec)::snapshot_t current;
+                {
+                    std::lock_guard lock(mutex);
+                    current = published;
+                }
+
+                long long total = 0;
+                for (std::size_t c = 0; c < current.chunk_count(); ++c) {
+                    for (int value : current.chunk<0>(c)) {
+                        total += value;
+                    }
+                }
+                // every row of a version holds the same value
+                if (total != static_cast<long long>(current.size()) * std::get<0>(current.front())) {
+                    mismatches.fetch_add(1);
+                }
+                std::this_thread::yield();
+            }
+        });
+
+        for (int version = 0; version < 50; ++version) {
+            for (std::size_t pos = 0; pos < vec.size(); ++pos) {
+                vec.get<0>(pos) = version;
+            }
+
+            auto next = vec.snapshot();
+            std::lock_guard lock(mutex);
+            published = std::move(next);
+        }
+
+        done.store(true);
+        reader.join();
+        CHECK_EQ(mismatches.load(), 0);
+    }
+
+    SUBCASE("[MULTI_VECTOR][VERSIONED][BOOL]") {
+        basic_versioned_multi_vector<chunk, int, bool> flags;
+        for (int j = 0; j < count; ++j) {
+            flags.emplace_back(j, j % 3 == 0);
+        }
+
+        const auto flags_snapshot = flags.snapshot();
+        flags.get<1>(3)           = false;
+        std::get<1>(flags[4])     = true;
+
+        CHECK(std::get<1>(flags_snapshot[3]));
+        CHECK_FALSE(std::get<1>(flags_snapshot[4]));
+        CHECK_FALSE(std::as_const(flags).get<1>(3));
+        CHECK(std::as_const(flags).get<1>(4));
+
+        const std::span<const bool> column = std::as_const(flags).chunk<1>(0);
+        CHECK_EQ(column.size(), chunk);
+        CHECK_EQ(std::count(column.begin(), column.end(), true), 22);
+        CHECK_EQ(flags.chunk<1>(1)[2], (chunk + 2) % 3 == 0);
+    }
+
+    SUBCASE("[MULTI_VECTOR][VERSIONED][EXCEPTION]") {
+        basic_versioned_multi_vector<chunk, int, throwing_move, int> rows;
+        const auto empty = rows.snapshot();
+
+        // the first element of a chunk, the new chunks are removed again
+        throwing_move::moves_left = 0;
+        bool thrown               = false;
+        try {
+            rows.emplace_back(1, throwing_move('a'), 1);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+        CHECK(rows.empty());
+        CHECK_EQ(rows.chunk_count(), 0);
+
+        throwing_move::moves_left = -1;
+        for (int j = 0; j < 3; ++j) {
+            rows.emplace_back(j, throwing_move('a'), j);
+        }
+
+        // an element in the middle of a chunk shared with a snapshot
+        const auto shared         = rows.snapshot();
+        throwing_move::moves_left = 0;
+        thrown                    = false;
+        try {
+            rows.emplace_back(3, throwing_move('b'), 3);
+        } catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        throwing_move::moves_left = -1;
+
+        CHECK(thrown);
+        REQUIRE_EQ(rows.size(), 3);
+        CHECK_EQ(std::as_const(rows).chunk<0>(0).size(), 3);
+        CHECK_EQ(std::as_const(rows).chunk<1>(0).size(), 3);
+
+        rows.emplace_back(3, throwing_move('c'), 3);
+        CHECK_EQ(std::get<0>(std::as_const(rows).back()), 3);
+        CHECK_EQ(std::get<1>(std::as_const(rows).back()).value, std::string(32, 'c'));
+        CHECK_EQ(std::get<2>(std::as_const(rows).back()), 3);
+        CHECK_EQ(shared.size(), 3);
+        CHECK(empty.empty());
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][QUERY]") {
+    constexpr int count = 1003;
+
+    multi_vector<
+        int,
+        void,
+        std::uint32_t,
+        float,
+        double,
+        std::int64_t,
+        packed_bool,
+        std::string,
+        std::int8_t,
+        std::uint8_t,
+        std::int16_t,
+        std::uint16_t,
+        std::uint64_t>
+        vec;
+    for (int i = 0; i < count; ++i) {
+        vec.emplace_back(
+            i % 10 - 5,
+            static_cast<std::uint32_t>(i) * 5'000'000U,
+            static_cast<float>(i) * 0.5F,
+            i % 7 == 0 ? std::nan("") : static_cast<double>(i),
+            static_cast<std::int64_t>(i) - 500,
+            i % 3 == 0,
+            std::to_string(i),
+            static_cast<std::int8_t>(i % 256 - 128),
+            static_cast<std::uint8_t>(i * 7),
+            static_cast<std::int16_t>(i * 61 - 30000),
+            static_cast<std::uint16_t>(i * 97),
+            static_cast<std::uint64_t>(i % 13) << 40
+        );
+    }
+
+    // compares the vectorized kernel with the scalar predicate for every operation
+    auto check_all = [&]<std::size_t I, typename T>(std::integral_constant<std::size_t, I> /*unused*/, T value) {
+        for (const CompareOp op : { CompareOp::EQUAL,
+                                    CompareOp::NOT_EQUAL,
+                                    CompareOp::LESS,
+                                    CompareOp::LESS_EQUAL,
+                                    CompareOp::GREATER,
+                                    CompareOp::GREATER_EQUAL }) {
+            const column_compare<T> compare { op, value };
+            const auto generic = [&](const T& element) { return compare(element); };
+
+            CHECK_EQ(select_where<I>(vec, compare), select_where<I>(vec, generic));
+        }
+    };
+
+    check_all(std::integral_constant<std::size_t, 0>(), 2);
+    check_all(std::integral_constant<std::size_t, 2>(), 3'000'000'000U);
+    check_all(std::integral_constant<std::size_t, 3>(), 100.25F);
+    check_all(std::integral_constant<std::size_t, 4>(), 500.0);
+    check_all(std::integral_constant<std::size_t, 5>(), std::int64_t { 0 });
+    check_all(std::integral_constant<std::size_t, 8>(), std::int8_t { -3 });
+    check_all(std::integral_constant<std::size_t, 9>(), std::uint8_t { 200 });
+    check_all(std::integral_constant<std::size_t, 10>(), std::int16_t { 1234 });
+    check_all(std::integral_constant<std::size_t, 11>(), std::uint16_t { 40000 });
+    check_all(std::integral_constant<std::size_t, 12>(), std::uint64_t { 5 } << 40);
+
+    CHECK_EQ(select_where<8>(vec, column_compare<std::int8_t> { CompareOp::EQUAL, -128 }).size(), 4);
+    CHECK_EQ(select_where<12>(vec, column_compare<std::uint64_t> { CompareOp::EQUAL, 0 }).size(), 78);
+
+    const auto negative = select_where<0>(vec, column_compare<int> { CompareOp::LESS, 0 });
+    CHECK_EQ(negative.size(), 503);
+    CHECK_EQ(negative[1], 1);
+    CHECK_EQ(negative[5], 10);
+
+    // the NaN rows never compare equal
+    CHECK_EQ(select_where<4>(vec, column_compare<double> { CompareOp::EQUAL, 7.0 }).size(), 0);
+    CHECK_EQ(select_where<4>(vec, column_compare<double> { CompareOp::NOT_EQUAL, 7.0 }).size(), count);
+
+    SUBCASE("[MULTI_VECTOR][QUERY][REFINE]") {
+        auto selection = select_where<5>(vec, column_compare<std::int64_t> { CompareOp::GREATER_EQUAL, 0 });
+        CHECK_EQ(selection.size(), count - 500);
+
+        refine_where<0>(vec, selection, [](int value) { return value == 4; });
+        CHECK_EQ(selection.size(), 50);
+        CHECK_EQ(selection.front(), 509);
+    }
+
+    SUBCASE("[MULTI_VECTOR][QUERY][MASK]") {
+        const auto selection = select_mask<6>(vec);
+        CHECK_EQ(selection.size(), (count + 2) / 3);
+        CHECK_EQ(selection[2], 6);
+    }
+
+    SUBCASE("[MULTI_VECTOR][QUERY][GATHER]") {
+        const auto selection = select_where<7>(vec, [](const std::string& text) { return text.ends_with("99"); });
+        const auto result    = gather(vec, selection);
+
+        REQUIRE_EQ(result.size(), 10);
+        CHECK_EQ(std::get<6>(result[1]), "199");
+        CHECK_EQ(std::get<0>(result[1]), 4);
+        CHECK_EQ(std::get<2>(result[1]), 99.5F);
+        CHECK(static_cast<bool>(std::get<5>(result[0])));
+        CHECK_FALSE(static_cast<bool>(std::get<5>(result[1])));
+
+        CHECK(gather(vec, {}).empty());
+
+        // the rows are copy-constructed, the elements need no default constructor
+        multi_vector<tracked, void, int> objects;
+        for (int i = 0; i < 10; ++i) {
+            objects.emplace_back(tracked(i), i);
+        }
+
+        const int alive     = tracked::alive;
+        const auto gathered = gather(objects, { 7, 2 });
+        REQUIRE_EQ(gathered.size(), 2);
+        CHECK_EQ(tracked::alive, alive + 2);
+        CHECK_EQ(std::get<0>(gathered[0]).value, 7);
+        CHECK_EQ(std::get<1>(gathered[1]), 2);
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][JOIN]") {
+    multi_vector<int, std::string> users;
+    users.push_back({ 1, "ann" });
+    users.push_back({ 2, "bob" });
+    users.push_back({ 3, "cid" });
+    users.push_back({ 2, "bea" });
+
+    multi_vector<double, int> orders;
+    for (int i = 0; i < 10; ++i) {
+        orders.emplace_back(i * 10.0, i % 5);
+    }
+
+    SUBCASE("[MULTI_VECTOR][JOIN][HASH_JOIN]") {
+        const join_result pairs = hash_join<0, 1>(users, orders);
+        REQUIRE_EQ(pairs.left.size(), pairs.right.size());
+
+        // users 1 and 3 have two orders each, both users with id 2 match the two orders of id 2
+        CHECK_EQ(pairs.left.size(), 8);
+
+        for (std::size_t i = 0; i < pairs.left.size(); ++i) {
+            CHECK_EQ(std::get<0>(users[pairs.left[i]]), std::get<1>(orders[pairs.right[i]]));
+        }
+
+        // the smaller side is the build side, so the pairs follow the orders
+        CHECK_EQ(pairs.right[0], 1);
+        CHECK_EQ(pairs.left[1], 1);
+        CHECK_EQ(pairs.left[2], 3);
+
+        const auto joined = gather(orders, pairs.right);
+        CHECK_EQ(joined.size(), 8);
+
+        const join_result swapped = hash_join<1, 0>(orders, users);
+        CHECK_EQ(swapped.left.size(), 8);
+        CHECK_EQ(swapped.left, pairs.right);
+    }
+
+    SUBCASE("[MULTI_VECTOR][JOIN][NO_MATCH]") {
+        multi_vector<int> other;
+        other.push_back({ 42 });
+
+        CHECK(hash_join<0>(users, other).left.empty());
+        CHECK(hash_join<0>(other, multi_vector<int>()).right.empty());
+    }
+
+    SUBCASE("[MULTI_VECTOR][JOIN][GROUP_BY]") {
+        const auto groups
+            = group_by<1>(orders, aggregate::count(), aggregate::sum<0>(), aggregate::min<0>(), aggregate::max<0>());
+
+        REQUIRE_EQ(groups.size(), 5);
+        for (std::size_t group = 0; group < groups.size(); ++group) {
+            const auto& [key, count, total, smallest, largest] = groups[group];
+            CHECK_EQ(key, static_cast<int>(group));
+            CHECK_EQ(count, 2);
+            CHECK_EQ(total, key * 20.0 + 50.0);
+            CHECK_EQ(smallest, key * 10.0);
+            CHECK_EQ(largest, key * 10.0 + 50.0);
+        }
+
+        const auto names = group_by<0>(users, aggregate::count());
+        REQUIRE_EQ(names.size(), 3);
+        CHECK_EQ(std::get<1>(names[1]), 2);
+    }
+
+    SUBCASE("[MULTI_VECTOR][JOIN][SUM]") {
+        multi_vector<int, std::uint8_t, float> bytes;
+        for (int i = 0; i < 100; ++i) {
+            bytes.emplace_back(i % 2, std::uint8_t { 200 }, 0.5F);
+        }
+
+        // the sums are widened, 50 * 200 does not fit into the column type
+        const auto groups = group_by<0>(bytes, aggregate::sum<1>(), aggregate::sum<2>());
+        static_assert(std::is_same_v<column_value_t<1, decltype(groups)>, std::uint64_t>);
+        static_assert(std::is_same_v<column_value_t<2, decltype(groups)>, double>);
+        CHECK_EQ(std::get<1>(groups[0]), 10000U);
+        CHECK_EQ(std::get<2>(groups[1]), 25.0);
+        static_assert(std::is_same_v<sum_result_t<int>, std::int64_t>);
+    }
+
+    SUBCASE("[MULTI_VECTOR][JOIN][BATCHES]") {
+        // more rows than one lookup batch, with keys repeated inside a batch
+        multi_vector<int> keys;
+        multi_vector<int, int> rows;
+        for (int i = 0; i < 100; ++i) {
+            keys.push_back({ i });
+        }
+        for (int i = 0; i < 1000; ++i) {
+            rows.emplace_back(i % 150, i);
+        }
+
+        const join_result pairs = hash_join<0>(keys, rows);
+        CHECK_EQ(pairs.left.size(), 700);
+        for (std::size_t i = 0; i < pairs.left.size(); ++i) {
+            CHECK_EQ(pairs.left[i], pairs.right[i] % 150);
+        }
+
+        const auto groups = group_by<0>(rows, aggregate::count());
+        REQUIRE_EQ(groups.size(), 150);
+        for (std::size_t group = 0; group < groups.size(); ++group) {
+            const auto& [key, count] = groups[group];
+            CHECK_EQ(key, static_cast<int>(group));
+            CHECK_EQ(count, group < 100 ? 7 : 6);
+        }
+    }
+}
+
+TEST_CASE("[MULTI_VECTOR][ENCODED]") {
+    SUBCASE("[MULTI_VECTOR][ENCODED][DICTIONARY]") {
+        const std::array<std::string, 4> categories = { "books", "games", "music", "tools" };
+
+        multi_vector<int, std::string> vec;
+        for (int i = 0; i < 1000; ++i) {
+            vec.emplace_back(i, categories[static_cast<std::size_t>(i * 7 % 4)]);
+        }
+
+        const auto column = encode_dictionary<1>(vec);
+        REQUIRE_EQ(column.size(), vec.size());
+        CHECK_EQ(column.dictionary().size(), 4);
+
+        for (std::size_t i = 0; i < vec.size(); ++i) {
+            CHECK_EQ(column[i], std::get<1>(vec[i]));
+        }
+
+        CHECK_EQ(column.find_code("tools"), column.codes()[1]);
+        CHECK_FALSE(column.find_code("films").has_value());
+        CHECK(column.select_equal("films").empty());
+
+        const selection_vector music = column.select_equal("music");
+        CHECK_EQ(music.size(), 250);
+        CHECK_EQ(music[0], 2);
+
+        std::vector<std::string> decoded(column.size());
+        column.decode(decoded);
+        CHECK(std::ranges::equal(decoded, vec.get_container<1>()));
+
+        CHECK_LE(column.memory_usage() * 4, vec.size() * sizeof(std::string));
+    }
+
+    SUBCASE("[MULTI_VECTOR][ENCODED][DELTA]") {
+        multi_vector<std::int64_t> vec;
+        std::int64_t timestamp = 1'700'000'000'000;
+        for (int i = 0; i < 10'000; ++i) {
+            timestamp += 1000 + i % 7;
+            vec.push_back({ timestamp });
+        }
+
+        const auto column = encode_delta<0>(vec);
+        REQUIRE_EQ(column.size(), vec.size());
+
+        for (std::size_t i = 0; i < vec.size(); i += 37) {
+            CHECK_EQ(column[i], std::get<0>(vec[i]));
+        }
+        CHECK_EQ(column[vec.size() - 1], std::get<0>(vec.back()));
+
+        std::vector<std::int64_t> decoded(column.size());
+        column.decode(decoded);
+        CHECK(std::ranges::equal(decoded, vec.get_container<0>()));
+
+        std::size_t scanned = 0;
+        column.for_each_block([&](std::span<const std::int64_t> block) {
+            CHECK(std::ranges::equal(block, decoded | std::views::drop(scanned) | std::views::take(block.size())));
+            scanned += block.size();
+        });
+        CHECK_EQ(scanned, vec.size());
+
+        CHECK_LE(column.memory_usage() * 10, vec.size() * sizeof(std::int64_t));
+    }
+
+    SUBCASE("[MULTI_VECTOR][ENCODED][DELTA_UNSORTED]") {
+        delta_column<std::int32_t, 16> column;
+        std::vector<std::int32_t> values;
+        for (int i = 0; i < 100; ++i) {
+            const std::int32_t value = i % 3 == 0 ? std::numeric_limits<std::int32_t>::min() + i : -i * 1'000'003;
+            values.push_back(value);
+            column.push_back(value);
+        }
+
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            CHECK_EQ(column[i], values[i]);
+        }
+
+        column.clear();
+        CHECK(column.empty());
+    }
+}
+
+namespace {
+
+struct soa_particle {
+    float x;
+    float y;
+    std::string name;
+    int id;
+};
+
+}
+
+TEST_CASE("[MULTI_VECTOR][SOA]") {
+    static_assert(koutil::type::aggregate_arity_v<soa_particle> == 4);
+    static_assert(koutil::type::aggregate_field_index_v<soa_particle, &soa_particle::name> == 2);
+
+    soa_vector<soa_particle> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back({ .x = static_cast<float>(i), .y = 1.5F, .name = std::to_string(i), .id = i * 2 });
+    }
+
+    REQUIRE_EQ(vec.size(), 10);
+    CHECK_EQ(vec.column<&soa_particle::id>()[3], 6);
+    CHECK_EQ(vec.column<&soa_particle::name>()[4], "4");
+    CHECK_EQ(vec.field<&soa_particle::x>(7), 7.0F);
+
+    vec.field<&soa_particle::y>(2) = 3.0F;
+    const soa_particle second = vec.get(2);
+    CHECK_EQ(second.x, 2.0F);
+    CHECK_EQ(second.y, 3.0F);
+    CHECK_EQ(second.name, "2");
+    CHECK_EQ(second.id, 4);
+
+    vec.set(0, { .x = -1.0F, .y = -2.0F, .name = "first", .id = 100 });
+    CHECK_EQ(std::get<2>(vec[0]), "first");
+
+    soa_particle moved { .x = 0.0F, .y = 0.0F, .name = "moved", .id = 1 };
+    vec.push_back(std::move(moved));
+    CHECK_EQ(vec.get(10).name, "moved");
+
+    float sum = 0;
+    for (const float x : vec.column<&soa_particle::x>()) {
+        sum += x;
+    }
+    CHECK_EQ(sum, 44.0F);
+
+    const auto selected = select_where<3>(vec.container(), column_compare<int> { CompareOp::GREATER, 10 });
+    CHECK_EQ(selected.size(), 5);
+
+    vec.pop_back();
+    CHECK_EQ(vec.size(), 10);
+    vec.clear();
+    CHECK(vec.empty());
+}
+
+TEST_CASE("[MULTI_VECTOR][SLOT_MAP]") {
+    slot_map<int, std::string> map;
+
+    std::vector<slot_handle> handles;
+    for (int i = 0; i < 8; ++i) {
+        handles.push_back(map.emplace(i, std::to_string(i)));
+    }
+
+    REQUIRE_EQ(map.size(), 8);
+    CHECK_EQ(std::get<1>(map[handles[5]]), "5");
+
+    SUBCASE("[MULTI_VECTOR][SLOT_MAP][ERASE]") {
+        CHECK(map.erase(handles[2]));
+        CHECK_FALSE(map.erase(handles[2]));
+        CHECK_FALSE(map.contains(handles[2]));
+        CHECK_FALSE(map.index_of(handles[2]).has_value());
+
+        // the last row took the place of the erased one
+        CHECK_EQ(map.index_of(handles[7]), 2);
+        CHECK_EQ(map.handle_at(2), handles[7]);
+        CHECK_EQ(std::get<0>(map[handles[7]]), 7);
+
+        for (std::size_t i = 0; i < handles.size(); ++i) {
+            if (i != 2) {
+                CHECK_EQ(std::get<0>(map.at(handles[i])), static_cast<int>(i));
+            }
+        }
+
+        // the freed slot is reused with a new generation
+        const slot_handle reused = map.insert({ 42, "new" });
+        CHECK_EQ(reused.index, handles[2].index);
+        CHECK_NE(reused, handles[2]);
+        CHECK_FALSE(map.contains(handles[2]));
+        CHECK_EQ(std::get<1>(map[reused]), "new");
+        CHECK_EQ(map.index_of(reused), 7);
+
+        int sum = 0;
+        for (const int value : map.get_container<0>()) {
+            sum += value;
+        }
+        CHECK_EQ(sum, 0 + 1 + 3 + 4 + 5 + 6 + 7 + 42);
+    }
+
+    SUBCASE("[MULTI_VECTOR][SLOT_MAP][ERASE_LAST]") {
+        CHECK(map.erase(handles[7]));
+        CHECK_EQ(map.size(), 7);
+        CHECK_EQ(map.index_of(handles[6]), 6);
+    }
+
+    SUBCASE("[MULTI_VECTOR][SLOT_MAP][CLEAR]") {
+        map.clear();
+        CHECK(map.empty());
+
+        for (const slot_handle handle : handles) {
+            CHECK_FALSE(map.contains(handle));
+        }
+
+        const slot_handle handle = map.emplace(1, "one");
+        CHECK_LT(handle.index, 8);
+        CHECK_EQ(handle.generation, 1);
+        CHECK_EQ(std::get<0>(map[handle]), 1);
+    }
+}